@@ -149,7 +149,7 @@ do_agent_secret (NmCli *nmc, int argc, char **argv)
 	nmc->secret_agent = nm_secret_agent_simple_new ("nmcli-agent");
 	if (nmc->secret_agent) {
 		/* We keep running */
-		nmc->should_wait++;
+		nmc_command_wait (nmc);
 
 		nm_secret_agent_simple_enable (nmc->secret_agent, NULL);
 		g_signal_connect (nmc->secret_agent,
@@ -183,7 +183,7 @@ do_agent_polkit (NmCli *nmc, int argc, char **argv)
 		g_error_free (error);
 	} else {
 		/* We keep running */
-		nmc->should_wait++;
+		nmc_command_wait (nmc);
 
 		g_print (_("nmcli successfully registered as a polkit agent.\n"));
 	}
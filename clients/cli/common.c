@@ -1174,6 +1174,58 @@ nmc_parse_lldp_capabilities (guint value)
 	return g_string_free (str, FALSE);
 }
 
+/**
+ * nmc_wait_release:
+ * @nmc: Client instance
+ *
+ * Releases one wait taken by incrementing @nmc's should_wait, for example
+ * for each watched object. Each increment must be matched by exactly one
+ * release.
+ */
+void
+nmc_wait_release (NmCli *nmc)
+{
+	g_return_if_fail (nmc->should_wait > 0);
+
+	nmc->should_wait--;
+}
+
+/**
+ * nmc_command_wait:
+ * @nmc: Client instance
+ *
+ * Keeps nmcli running until the command finishes asynchronously and calls
+ * nmc_command_done(). A command holds at most one such wait; taking it
+ * again is a no-op.
+ */
+void
+nmc_command_wait (NmCli *nmc)
+{
+	if (nmc->command_waiting)
+		return;
+
+	nmc->command_waiting = TRUE;
+	nmc->should_wait++;
+}
+
+/**
+ * nmc_command_done:
+ * @nmc: Client instance
+ *
+ * Releases the wait taken by nmc_command_wait(), if any. The command
+ * may get here several times, for example on timeout and again when
+ * the pending operation completes; only the first call releases.
+ */
+void
+nmc_command_done (NmCli *nmc)
+{
+	if (!nmc->command_waiting)
+		return;
+
+	nmc->command_waiting = FALSE;
+	nmc_wait_release (nmc);
+}
+
 static void
 command_done (GObject *object, GAsyncResult *res, gpointer user_data)
 {
@@ -1209,7 +1261,7 @@ got_client (GObject *source_object, GAsyncResult *res, gpointer user_data)
 	CmdCall *call = user_data;
 	NmCli *nmc = call->nmc;
 
-	nmc->should_wait--;
+	nmc_wait_release (nmc);
 	nmc->client = nm_client_new_finish (res, &error);
 
 	if (!nmc->client) {
@@ -86,6 +86,10 @@ typedef struct {
 	gboolean needs_nm_running;
 } NMCCommand;
 
+void nmc_wait_release (NmCli *nmc);
+void nmc_command_wait (NmCli *nmc);
+void nmc_command_done (NmCli *nmc);
+
 void nmc_do_cmd (NmCli *nmc, const NMCCommand cmds[], const char *cmd, int argc, char **argv);
 
 void nmc_complete_strv (const char *prefix, gssize nargs, const char *const*args);
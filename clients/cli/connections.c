@@ -1184,6 +1184,8 @@ quit (void)
 {
 	if (nm_clear_g_source (&progress_id))
 		nmc_terminal_erase_line ();
+
+	nmc_command_done (&nm_cli);
 	g_main_loop_quit (loop);
 }
 
@@ -2900,12 +2902,12 @@ do_connection_up (NmCli *nmc, int argc, char **argv)
 	 * and we can follow activation progress.
 	 */
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	if (!nmc_activate_connection (nmc, connection, ifname, ap, nsp, pwds, activate_connection_cb, &error)) {
 		g_string_printf (nmc->return_text, _("Error: %s."),
 		                 error->message);
-		nmc->should_wait--;
+		nmc_command_done (nmc);
 		return error->code;
 	}
 
@@ -3135,7 +3137,7 @@ do_connection_down (NmCli *nmc, int argc, char **argv)
 		return nmc->return_value;
 
 	if (nmc->timeout > 0) {
-		nmc->should_wait++;
+		nmc_command_wait (nmc);
 
 		info = g_slice_new0 (ConnectionCbInfo);
 		info->nmc = nmc;
@@ -5308,7 +5310,7 @@ read_properties:
 		}
 	}
 
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	info = g_malloc0 (sizeof (AddConnectionInfo));
 	info->nmc = nmc;
@@ -7942,7 +7944,7 @@ editor_menu_main (NmCli *nmc, NMConnection *connection, const char *connection_t
 			}
 
 			nmc->nowait_flag = FALSE;
-			nmc->should_wait++;
+			nmc_command_wait (nmc);
 			nmc->nmc_config_mutable.print_output = NMC_PRINT_PRETTY;
 			if (!nmc_activate_connection (nmc, NM_CONNECTION (rem_con), ifname, ap_nsp, ap_nsp, NULL,
 			                              activate_connection_editor_cb, &tmp_err)) {
@@ -8436,7 +8438,7 @@ do_connection_modify (NmCli *nmc,
 		return nmc->return_value;
 
 	update_connection (!temporary, rc, modify_connection_cb, nmc);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	return nmc->return_value;
 }
@@ -8571,7 +8573,7 @@ do_connection_clone (NmCli *nmc, int argc, char **argv)
 	                    clone_connection_cb,
 	                    info);
 
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 	return nmc->return_value;
 }
 
@@ -8680,7 +8682,7 @@ do_connection_delete (NmCli *nmc, int argc, char **argv)
 	info->cancellable = g_cancellable_new ();
 
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	g_signal_connect (nmc->client, NM_CLIENT_CONNECTION_REMOVED,
 	                  G_CALLBACK (connection_removed_cb), info);
@@ -8717,7 +8719,7 @@ static void
 connection_unwatch (NmCli *nmc, NMConnection *connection)
 {
 	if (g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_changed), nmc))
-		nmc->should_wait--;
+		nmc_wait_release (nmc);
 
 	/* Terminate if all the watched connections disappeared. */
 	if (!nmc->should_wait)
@@ -8779,7 +8781,7 @@ do_connection_monitor (NmCli *nmc, int argc, char **argv)
 
 	if (argc == 0) {
 		/* We'll watch the connection additions too, never exit. */
-		nmc->should_wait++;
+		nmc_command_wait (nmc);
 		g_signal_connect (nmc->client, NM_CLIENT_CONNECTION_ADDED, G_CALLBACK (connection_added), nmc);
 	}
 
@@ -8985,7 +8987,7 @@ do_connection_import (NmCli *nmc, int argc, char **argv)
 	                    add_connection_cb,
 	                    info);
 
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 	return nmc->return_value;
 }
 
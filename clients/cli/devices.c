@@ -888,6 +888,8 @@ quit (void)
 {
 	if (nm_clear_g_source (&progress_id))
 		nmc_terminal_erase_line ();
+
+	nmc_command_done (&nm_cli);
 	g_main_loop_quit (loop);
 }
 
@@ -2003,7 +2005,7 @@ do_device_connect (NmCli *nmc, int argc, char **argv)
 	 * till connect_device_cb() is called, giving NM time to check our permissions.
 	 */
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	/* Create secret agent */
 	nmc->secret_agent = nm_secret_agent_simple_new ("nmcli-connect");
@@ -2172,7 +2174,7 @@ do_device_reapply (NmCli *nmc, int argc, char **argv)
 		return nmc->return_value;
 
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	info = g_slice_new0 (DeviceCbInfo);
 	info->nmc = nmc;
@@ -2275,7 +2277,7 @@ do_device_modify (NmCli *nmc, int argc, char **argv)
 		nmc->timeout = 10;
 
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	info = g_slice_new0 (ModifyInfo);
 	info->nmc = nmc;
@@ -2354,7 +2356,7 @@ do_devices_disconnect (NmCli *nmc, int argc, char **argv)
 	                  G_CALLBACK (device_removed_cb), info);
 
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	for (iter = queue; iter; iter = g_slist_next (iter)) {
 		device = iter->data;
@@ -2421,7 +2423,7 @@ do_devices_delete (NmCli *nmc, int argc, char **argv)
 		info->timeout_id = g_timeout_add_seconds (nmc->timeout, device_op_timeout_cb, info);
 
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	for (iter = queue; iter; iter = g_slist_next (iter)) {
 		device = iter->data;
@@ -2575,7 +2577,7 @@ device_unwatch (NmCli *nmc, NMDevice *device)
 {
 	g_signal_handlers_disconnect_by_func (device, device_state, nmc);
 	if (g_signal_handlers_disconnect_by_func (device, device_ac, nmc))
-		nmc->should_wait--;
+		nmc_wait_release (nmc);
 
 	/* Terminate if all the watched devices disappeared. */
 	if (!nmc->should_wait)
@@ -2612,7 +2614,7 @@ do_devices_monitor (NmCli *nmc, int argc, char **argv)
 			device_watch (nmc, g_ptr_array_index (devices, i));
 
 		/* We'll watch the device additions too, never exit. */
-		nmc->should_wait++;
+		nmc_command_wait (nmc);
 		g_signal_connect (nmc->client, NM_CLIENT_DEVICE_ADDED, G_CALLBACK (device_added), nmc);
 	} else {
 		GSList *queue = get_device_list (nmc, argc, argv);
@@ -2850,7 +2852,8 @@ wifi_list_finish (WifiListData *data)
 	NmCli *nmc = info->nmc;
 	guint i;
 
-	if (--info->nmc->should_wait == 0) {
+	nmc_wait_release (nmc);
+	if (nmc->should_wait == 0) {
 		for (i = 0; info->devices[i]; i++) {
 			wifi_print_aps (NM_DEVICE_WIFI (info->devices[i]),
 			                info->nmc,
@@ -3512,7 +3515,7 @@ do_device_wifi_connect_network (NmCli *nmc, int argc, char **argv)
 	 * the user doesn't want to wait, in order to give NM time to check our
 	 * permissions. */
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	info = g_malloc0 (sizeof (AddAndActivateInfo));
 	info->nmc = nmc;
@@ -3882,7 +3885,7 @@ do_device_wifi_hotspot (NmCli *nmc, int argc, char **argv)
 
 	/* Activate the connection now */
 	nmc->nowait_flag = (nmc->timeout == 0);
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	info = g_malloc0 (sizeof (AddAndActivateInfo));
 	info->nmc = nmc;
@@ -4001,7 +4004,7 @@ do_device_wifi_rescan (NmCli *nmc, int argc, char **argv)
 		nm_device_wifi_request_scan_async (NM_DEVICE_WIFI (device),
 		                                   NULL, request_rescan_cb, nmc);
 
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 finish:
 	g_ptr_array_free (ssids, FALSE);
 	return nmc->return_value;
@@ -459,15 +459,19 @@ usage_radio_wwan (void)
 static void
 usage_monitor (void)
 {
-	g_printerr (_("Usage: nmcli monitor\n"
+	g_printerr (_("Usage: nmcli monitor [json]\n"
 	              "\n"
 	              "Monitor NetworkManager changes.\n"
-	              "Prints a line whenever a change occurs in NetworkManager\n\n"));
+	              "Prints a line whenever a change occurs in NetworkManager\n"
+	              "\n"
+	              "With 'json', prints one JSON object per line and event, for device\n"
+	              "and active connection state, connection profile and connectivity changes.\n\n"));
 }
 
 static void
 quit (void)
 {
+	nmc_command_done (&nm_cli);
 	g_main_loop_quit (loop);
 }
 
@@ -604,7 +608,7 @@ show_nm_permissions (NmCli *nmc)
 		nmc->timeout = 10;
 	g_timeout_add_seconds (nmc->timeout, timeout_cb, nmc);
 
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 	return TRUE;
 }
 
@@ -772,7 +776,7 @@ do_general_hostname (NmCli *nmc, int argc, char **argv)
 		if (next_arg (nmc, &argc, &argv, NULL) == 0)
 			g_print ("Warning: ignoring extra garbage after '%s' hostname\n", hostname);
 
-		nmc->should_wait++;
+		nmc_command_wait (nmc);
 		nm_client_save_hostname_async (nmc->client, hostname, NULL, save_hostname_cb, nmc);
 	}
 
@@ -1355,6 +1359,328 @@ do_overview (NmCli *nmc, int argc, char **argv)
 	return NMC_RESULT_SUCCESS;
 }
 
+/*****************************************************************************/
+
+/* 'nmcli monitor json' prints one JSON object per line. The values are taken
+ * from the signal arguments and the already cached NMClient objects, without
+ * issuing D-Bus calls. Lines are written to the stdio buffer of stdout, which
+ * is flushed once a burst of events is handled. As the buffer belongs to
+ * stdio, it is also written out when nmcli exits, for example on a signal. */
+
+typedef struct {
+	GString *buf;
+	guint flush_id;
+} MonitorJson;
+
+static void
+_json_append_str (GString *str, const char *s)
+{
+	if (!s) {
+		g_string_append (str, "null");
+		return;
+	}
+
+	g_string_append_c (str, '"');
+	for (; *s; s++) {
+		switch (*s) {
+		case '"':
+			g_string_append (str, "\\\"");
+			break;
+		case '\\':
+			g_string_append (str, "\\\\");
+			break;
+		case '\n':
+			g_string_append (str, "\\n");
+			break;
+		case '\r':
+			g_string_append (str, "\\r");
+			break;
+		case '\t':
+			g_string_append (str, "\\t");
+			break;
+		default:
+			if ((guchar) *s < 0x20)
+				g_string_append_printf (str, "\\u%04x", (guint) (guchar) *s);
+			else
+				g_string_append_c (str, *s);
+			break;
+		}
+	}
+	g_string_append_c (str, '"');
+}
+
+static void
+_json_add_str (MonitorJson *mj, const char *key, const char *value)
+{
+	g_string_append_printf (mj->buf, ",\"%s\":", key);
+	_json_append_str (mj->buf, value);
+}
+
+static void
+_json_add_int (MonitorJson *mj, const char *key, gint64 value)
+{
+	g_string_append_printf (mj->buf, ",\"%s\":%"G_GINT64_FORMAT, key, value);
+}
+
+static void
+_json_add_enum (MonitorJson *mj, const char *key, GType type, int value)
+{
+	gs_free char *name_key = NULL;
+	gs_free char *name = NULL;
+
+	_json_add_int (mj, key, value);
+
+	name_key = g_strdup_printf ("%s-name", key);
+	name = nm_utils_enum_to_str (type, value);
+	_json_add_str (mj, name_key, name);
+}
+
+static void
+_json_add_object (MonitorJson *mj, gpointer obj)
+{
+	_json_add_str (mj, "path", nm_object_get_path (NM_OBJECT (obj)));
+}
+
+static gboolean
+_json_flush (gpointer user_data)
+{
+	MonitorJson *mj = user_data;
+
+	mj->flush_id = 0;
+	fflush (stdout);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_json_event_start (MonitorJson *mj, const char *event)
+{
+	g_string_append_printf (mj->buf, "{\"time\":%"G_GINT64_FORMAT",\"event\":", g_get_real_time () / 1000);
+	_json_append_str (mj->buf, event);
+}
+
+static void
+_json_event_end (MonitorJson *mj)
+{
+	g_string_append (mj->buf, "}\n");
+	fwrite (mj->buf->str, 1, mj->buf->len, stdout);
+	g_string_truncate (mj->buf, 0);
+
+	/* events usually come in bursts, write them out together. */
+	if (!mj->flush_id)
+		mj->flush_id = g_idle_add (_json_flush, mj);
+}
+
+static void
+json_nm_running (NMClient *client, GParamSpec *param, MonitorJson *mj)
+{
+	_json_event_start (mj, "nm-running");
+	g_string_append_printf (mj->buf, ",\"running\":%s",
+	                        nm_client_get_nm_running (client) ? "true" : "false");
+	_json_event_end (mj);
+
+	/* consumers may want to react to NetworkManager going away right
+	 * away. Don't hold the event back until the next idle. */
+	if (!nm_client_get_nm_running (client)) {
+		nm_clear_g_source (&mj->flush_id);
+		_json_flush (mj);
+	}
+}
+
+static void
+json_state (NMClient *client, GParamSpec *param, MonitorJson *mj)
+{
+	_json_event_start (mj, "state");
+	_json_add_enum (mj, "state", NM_TYPE_STATE, nm_client_get_state (client));
+	_json_event_end (mj);
+}
+
+static void
+json_connectivity (NMClient *client, GParamSpec *param, MonitorJson *mj)
+{
+	_json_event_start (mj, "connectivity");
+	_json_add_enum (mj, "connectivity", NM_TYPE_CONNECTIVITY_STATE, nm_client_get_connectivity (client));
+	_json_event_end (mj);
+}
+
+static void
+json_primary_connection (NMClient *client, GParamSpec *param, MonitorJson *mj)
+{
+	NMActiveConnection *primary = nm_client_get_primary_connection (client);
+
+	_json_event_start (mj, "primary-connection");
+	_json_add_str (mj, "path", primary ? nm_object_get_path (NM_OBJECT (primary)) : NULL);
+	_json_add_str (mj, "id", primary ? nm_active_connection_get_id (primary) : NULL);
+	_json_add_str (mj, "uuid", primary ? nm_active_connection_get_uuid (primary) : NULL);
+	_json_event_end (mj);
+}
+
+static void
+json_device_state (NMDevice *device, guint new_state, guint old_state, guint reason, MonitorJson *mj)
+{
+	_json_event_start (mj, "device-state");
+	_json_add_object (mj, device);
+	_json_add_str (mj, "iface", nm_device_get_iface (device));
+	_json_add_enum (mj, "state", NM_TYPE_DEVICE_STATE, new_state);
+	_json_add_enum (mj, "old-state", NM_TYPE_DEVICE_STATE, old_state);
+	_json_add_enum (mj, "reason", NM_TYPE_DEVICE_STATE_REASON, reason);
+	_json_event_end (mj);
+}
+
+static void
+json_device_event (MonitorJson *mj, const char *event, NMDevice *device)
+{
+	_json_event_start (mj, event);
+	_json_add_object (mj, device);
+	_json_add_str (mj, "iface", nm_device_get_iface (device));
+	_json_add_enum (mj, "state", NM_TYPE_DEVICE_STATE, nm_device_get_state (device));
+	_json_event_end (mj);
+}
+
+static void
+json_device_added (NMClient *client, NMDevice *device, MonitorJson *mj)
+{
+	json_device_event (mj, "device-added", device);
+	g_signal_connect (device, "state-changed", G_CALLBACK (json_device_state), mj);
+}
+
+static void
+json_device_removed (NMClient *client, NMDevice *device, MonitorJson *mj)
+{
+	g_signal_handlers_disconnect_by_func (device, json_device_state, mj);
+
+	_json_event_start (mj, "device-removed");
+	_json_add_object (mj, device);
+	_json_add_str (mj, "iface", nm_device_get_iface (device));
+	_json_event_end (mj);
+}
+
+static void
+json_active_connection_state (NMActiveConnection *ac, guint state, guint reason, MonitorJson *mj)
+{
+	_json_event_start (mj, "active-connection-state");
+	_json_add_object (mj, ac);
+	_json_add_str (mj, "id", nm_active_connection_get_id (ac));
+	_json_add_str (mj, "uuid", nm_active_connection_get_uuid (ac));
+	_json_add_enum (mj, "state", NM_TYPE_ACTIVE_CONNECTION_STATE, state);
+	_json_add_enum (mj, "reason", NM_TYPE_ACTIVE_CONNECTION_STATE_REASON, reason);
+	_json_event_end (mj);
+}
+
+static void
+json_active_connection_event (MonitorJson *mj, const char *event, NMActiveConnection *ac)
+{
+	_json_event_start (mj, event);
+	_json_add_object (mj, ac);
+	_json_add_str (mj, "id", nm_active_connection_get_id (ac));
+	_json_add_str (mj, "uuid", nm_active_connection_get_uuid (ac));
+	_json_add_enum (mj, "state", NM_TYPE_ACTIVE_CONNECTION_STATE, nm_active_connection_get_state (ac));
+	_json_event_end (mj);
+}
+
+static void
+json_active_connection_added (NMClient *client, NMActiveConnection *ac, MonitorJson *mj)
+{
+	json_active_connection_event (mj, "active-connection-added", ac);
+	g_signal_connect (ac, "state-changed", G_CALLBACK (json_active_connection_state), mj);
+}
+
+static void
+json_active_connection_removed (NMClient *client, NMActiveConnection *ac, MonitorJson *mj)
+{
+	g_signal_handlers_disconnect_by_func (ac, json_active_connection_state, mj);
+
+	_json_event_start (mj, "active-connection-removed");
+	_json_add_object (mj, ac);
+	_json_add_str (mj, "uuid", nm_active_connection_get_uuid (ac));
+	_json_event_end (mj);
+}
+
+static void
+json_connection_event (MonitorJson *mj, const char *event, NMConnection *connection)
+{
+	_json_event_start (mj, event);
+	_json_add_object (mj, connection);
+	_json_add_str (mj, "id", nm_connection_get_id (connection));
+	_json_add_str (mj, "uuid", nm_connection_get_uuid (connection));
+	_json_event_end (mj);
+}
+
+static void
+json_connection_changed (NMConnection *connection, MonitorJson *mj)
+{
+	json_connection_event (mj, "connection-changed", connection);
+}
+
+static void
+json_connection_added (NMClient *client, NMRemoteConnection *con, MonitorJson *mj)
+{
+	json_connection_event (mj, "connection-added", NM_CONNECTION (con));
+	g_signal_connect (con, NM_CONNECTION_CHANGED, G_CALLBACK (json_connection_changed), mj);
+}
+
+static void
+json_connection_removed (NMClient *client, NMRemoteConnection *con, MonitorJson *mj)
+{
+	g_signal_handlers_disconnect_by_func (con, json_connection_changed, mj);
+	json_connection_event (mj, "connection-removed", NM_CONNECTION (con));
+}
+
+static void
+monitor_json (NmCli *nmc)
+{
+	MonitorJson *mj;
+	const GPtrArray *p;
+	guint i;
+
+	/* lives until nmcli exits. */
+	mj = g_slice_new0 (MonitorJson);
+	mj->buf = g_string_sized_new (512);
+
+	g_signal_connect (nmc->client, "notify::" NM_CLIENT_NM_RUNNING,
+	                  G_CALLBACK (json_nm_running), mj);
+	g_signal_connect (nmc->client, "notify::" NM_CLIENT_PRIMARY_CONNECTION,
+	                  G_CALLBACK (json_primary_connection), mj);
+	g_signal_connect (nmc->client, "notify::" NM_CLIENT_CONNECTIVITY,
+	                  G_CALLBACK (json_connectivity), mj);
+	g_signal_connect (nmc->client, "notify::" NM_CLIENT_STATE,
+	                  G_CALLBACK (json_state), mj);
+
+	p = nm_client_get_devices (nmc->client);
+	for (i = 0; i < p->len; i++)
+		g_signal_connect (p->pdata[i], "state-changed", G_CALLBACK (json_device_state), mj);
+	g_signal_connect (nmc->client, NM_CLIENT_DEVICE_ADDED, G_CALLBACK (json_device_added), mj);
+	g_signal_connect (nmc->client, NM_CLIENT_DEVICE_REMOVED, G_CALLBACK (json_device_removed), mj);
+
+	p = nm_client_get_active_connections (nmc->client);
+	for (i = 0; i < p->len; i++)
+		g_signal_connect (p->pdata[i], "state-changed", G_CALLBACK (json_active_connection_state), mj);
+	g_signal_connect (nmc->client, NM_CLIENT_ACTIVE_CONNECTION_ADDED, G_CALLBACK (json_active_connection_added), mj);
+	g_signal_connect (nmc->client, NM_CLIENT_ACTIVE_CONNECTION_REMOVED, G_CALLBACK (json_active_connection_removed), mj);
+
+	p = nm_client_get_connections (nmc->client);
+	for (i = 0; i < p->len; i++)
+		g_signal_connect (p->pdata[i], NM_CONNECTION_CHANGED, G_CALLBACK (json_connection_changed), mj);
+	g_signal_connect (nmc->client, NM_CLIENT_CONNECTION_ADDED, G_CALLBACK (json_connection_added), mj);
+	g_signal_connect (nmc->client, NM_CLIENT_CONNECTION_REMOVED, G_CALLBACK (json_connection_removed), mj);
+
+	/* start with the current state, so that consumers don't need to query it. */
+	json_nm_running (nmc->client, NULL, mj);
+	if (nm_client_get_nm_running (nmc->client)) {
+		json_state (nmc->client, NULL, mj);
+		json_connectivity (nmc->client, NULL, mj);
+
+		p = nm_client_get_devices (nmc->client);
+		for (i = 0; i < p->len; i++)
+			json_device_event (mj, "device", p->pdata[i]);
+
+		p = nm_client_get_active_connections (nmc->client);
+		for (i = 0; i < p->len; i++)
+			json_active_connection_event (mj, "active-connection", p->pdata[i]);
+	}
+
+	nmc_command_wait (nmc);
+}
+
 /*
  * Entry point function for 'nmcli monitor'
  */
@@ -1363,9 +1689,17 @@ do_monitor (NmCli *nmc, int argc, char **argv)
 {
 	next_arg (nmc, &argc, &argv, NULL);
 
+	if (argc == 1 && nmc->complete)
+		nmc_complete_strings (*argv, "json", NULL);
+
 	if (nmc->complete)
 		return nmc->return_value;
 
+	if (argc == 1 && matches (*argv, "json")) {
+		monitor_json (nmc);
+		return NMC_RESULT_SUCCESS;
+	}
+
 	if (argc > 0) {
 		if (!nmc_arg_is_help (*argv)) {
 			g_string_printf (nmc->return_text, _("Error: 'monitor' command '%s' is not valid."), *argv);
@@ -1396,7 +1730,7 @@ do_monitor (NmCli *nmc, int argc, char **argv)
 	g_signal_connect (nmc->client, "notify::" NM_CLIENT_STATE,
 	                  G_CALLBACK (client_state), nmc);
 
-	nmc->should_wait++;
+	nmc_command_wait (nmc);
 
 	monitor_devices (nmc);
 	monitor_connections (nmc);
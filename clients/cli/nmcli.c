@@ -245,11 +245,13 @@ usage (void)
 	              "\n"
 	              "OPTIONS\n"
 	              "  -a, --ask                                ask for missing parameters\n"
+	              "  -b, --batch <file>|-                     read commands from a file or stdin\n"
 	              "  -c, --colors auto|yes|no                 whether to use colors in output\n"
 	              "  -e, --escape yes|no                      escape columns separators in values\n"
 	              "  -f, --fields <field,...>|all|common      specify fields to output\n"
 	              "  -g, --get-values <field,...>|all|common  shortcut for -m tabular -t -f\n"
 	              "  -h, --help                               print this help\n"
+	              "  -k, --keep-going                         continue a batch after failed commands\n"
 	              "  -m, --mode tabular|multiline             output mode\n"
 	              "  -o, --overview                           overview mode\n"
 	              "  -p, --pretty                             pretty output\n"
@@ -703,10 +705,108 @@ set_colors (NmcColorOption color_option,
 
 /*************************************************************************************/
 
+static void
+process_batch (NmCli *nmc, const char *filename, gboolean keep_going)
+{
+	gs_unref_ptrarray GPtrArray *argvs = NULL;
+	NMCResultCode first_error = NMC_RESULT_SUCCESS;
+	gs_free char *line = NULL;
+	size_t line_len = 0;
+	guint lineno = 0;
+	guint n_failed = 0;
+	guint n_run = 0;
+	FILE *f;
+
+	if (nm_streq (filename, "-"))
+		f = stdin;
+	else {
+		f = fopen (filename, "re");
+		if (!f) {
+			int errsv = errno;
+
+			g_string_printf (nmc->return_text, _("Error: failed to open batch file '%s': %s."),
+			                 filename, nm_strerror_native (errsv));
+			nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+			return;
+		}
+	}
+
+	/* Commands may still reference their argument vector from callbacks,
+	 * keep all of them until the whole batch is done. */
+	argvs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_strfreev);
+
+	while (getline (&line, &line_len, f) != -1) {
+		gs_free_error GError *error = NULL;
+		const char *l;
+		char **cmd_argv;
+		int cmd_argc;
+
+		lineno++;
+
+		l = nm_str_skip_leading_spaces (line);
+		if (NM_IN_SET (l[0], '\0', '\n', '#'))
+			continue;
+
+		n_run++;
+		nmc->return_value = NMC_RESULT_SUCCESS;
+		g_string_assign (nmc->return_text, _("Success"));
+
+		if (!g_shell_parse_argv (l, &cmd_argc, &cmd_argv, &error)) {
+			g_string_printf (nmc->return_text, _("Error: %s"), error->message);
+			nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+		} else {
+			g_ptr_array_add (argvs, cmd_argv);
+
+			/* All commands share the NMClient instance, which is created
+			 * by the first command that needs it. */
+			nmc_do_cmd (nmc, nmcli_cmds, cmd_argv[0], cmd_argc, cmd_argv);
+			g_main_loop_run (loop);
+
+			/* The main loop may be quit while asynchronous operations of the
+			 * command are still pending. Let them finish before starting the
+			 * next command, unless we got interrupted. */
+			while (   nmc->should_wait > 0
+			       && nmc->return_value != 0x80 + SIGINT)
+				g_main_context_iteration (NULL, TRUE);
+		}
+
+		if (nmc->return_value == NMC_RESULT_SUCCESS)
+			continue;
+
+		/* Interrupted by SIGINT. Don't run further commands. */
+		if (nmc->return_value == 0x80 + SIGINT) {
+			first_error = nmc->return_value;
+			break;
+		}
+
+		n_failed++;
+		if (first_error == NMC_RESULT_SUCCESS)
+			first_error = nmc->return_value;
+		g_printerr ("%s:%u: %s\n", filename, lineno, nmc->return_text->str);
+
+		if (!keep_going)
+			break;
+	}
+
+	if (f != stdin)
+		fclose (f);
+
+	if (first_error == NMC_RESULT_SUCCESS) {
+		nmc->return_value = NMC_RESULT_SUCCESS;
+		g_string_assign (nmc->return_text, _("Success"));
+	} else if (first_error != 0x80 + SIGINT) {
+		nmc->return_value = first_error;
+		g_string_printf (nmc->return_text, _("Error: %u of %u commands in batch failed."),
+		                 n_failed, n_run);
+	}
+}
+
 static gboolean
 process_command_line (NmCli *nmc, int argc, char **argv)
 {
 	NmcColorOption colors = NMC_USE_COLOR_AUTO;
+	const char *batch_file = NULL;
+	gboolean keep_going = FALSE;
 	char *base;
 
 	base = strrchr (argv[0], '/');
@@ -732,7 +832,8 @@ process_command_line (NmCli *nmc, int argc, char **argv)
 			nmc_complete_strings (argv[0], "--terse", "--pretty", "--mode", "--overview",
 			                               "--colors", "--escape",
 			                               "--fields", "--nocheck", "--get-values",
-			                               "--wait", "--version", "--help", NULL);
+			                               "--wait", "--batch", "--keep-going",
+			                               "--version", "--help", NULL);
 		}
 
 		if (argv[0][1] == '-' && argv[0][2] == '\0') {
@@ -833,6 +934,10 @@ process_command_line (NmCli *nmc, int argc, char **argv)
 				return FALSE;
 			}
 			nmc->timeout = (int) timeout;
+		} else if (matches_arg (nmc, &argc, &argv, "-batch", &value)) {
+			batch_file = value;
+		} else if (matches_arg (nmc, &argc, &argv, "-keep-going", NULL)) {
+			keep_going = TRUE;
 		} else if (matches_arg (nmc, &argc, &argv, "-version", NULL)) {
 			if (!nmc->complete)
 				g_print (_("nmcli tool, version %s\n"), NMCLI_VERSION);
@@ -861,6 +966,22 @@ process_command_line (NmCli *nmc, int argc, char **argv)
 	            &nmc->palette_buffer,
 	            nmc->nmc_config_mutable.palette);
 
+	if (batch_file) {
+		if (argc > 0) {
+			g_string_printf (nmc->return_text, _("Error: a command cannot be given together with '--batch'."));
+			nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+			return FALSE;
+		}
+		if (nmc->complete)
+			return FALSE;
+		process_batch (nmc, batch_file, keep_going);
+		return FALSE;
+	} else if (keep_going) {
+		g_string_printf (nmc->return_text, _("Error: '--keep-going' requires '--batch'."));
+		nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+		return FALSE;
+	}
+
 	/* Now run the requested command */
 	nmc_do_cmd (nmc, nmcli_cmds, *argv, argc, argv);
 
@@ -993,22 +993,13 @@ _print_data_cell_clear (gpointer cell_p)
 	_print_data_cell_clear_text (cell);
 }
 
-static void
-_print_fill (const NmcConfig *nmc_config,
-             gpointer const *targets,
-             gpointer targets_data,
-             const PrintDataCol *cols,
-             guint cols_len,
-             GArray **out_header_row,
-             GArray **out_cells)
+static GArray *
+_print_fill_header (const NmcConfig *nmc_config,
+                    const PrintDataCol *cols,
+                    guint cols_len)
 {
-	GArray *cells;
 	GArray *header_row;
-	guint i_row, i_col;
-	guint targets_len;
-	NMMetaAccessorGetType text_get_type;
-	NMMetaAccessorGetFlags text_get_flags;
-
+	guint i_col;
 
 	header_row = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataHeaderCell), cols_len);
 	g_array_set_clear_func (header_row, _print_data_header_cell_clear);
@@ -1050,112 +1041,125 @@ _print_fill (const NmcConfig *nmc_config,
 		}
 	}
 
-	targets_len = NM_PTRARRAY_LEN (targets);
+	return header_row;
+}
 
-	cells = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataCell), targets_len * header_row->len);
-	g_array_set_clear_func (cells, _print_data_cell_clear);
-	g_array_set_size (cells, targets_len * header_row->len);
+static void
+_print_fill_row (const NmcConfig *nmc_config,
+                 GArray *header_row,
+                 gpointer target,
+                 gpointer targets_data,
+                 guint i_row,
+                 gboolean update_to_print,
+                 PrintDataCell *cells_line)
+{
+	NMMetaAccessorGetType text_get_type;
+	NMMetaAccessorGetFlags text_get_flags;
+	guint i_col;
 
 	text_get_type = nmc_print_output_to_accessor_get_type (nmc_config->print_output);
 	text_get_flags = NM_META_ACCESSOR_GET_FLAGS_ACCEPT_STRV;
 	if (nmc_config->show_secrets)
 		text_get_flags |= NM_META_ACCESSOR_GET_FLAGS_SHOW_SECRETS;
 
-	for (i_row = 0; i_row < targets_len; i_row++) {
-		gpointer target = targets[i_row];
-		PrintDataCell *cells_line = &g_array_index (cells, PrintDataCell, i_row * header_row->len);
-
-		for (i_col = 0; i_col < header_row->len; i_col++) {
-			char *to_free = NULL;
-			PrintDataCell *cell = &cells_line[i_col];
-			PrintDataHeaderCell *header_cell;
-			const NMMetaAbstractInfo *info;
-			NMMetaAccessorGetOutFlags text_out_flags, color_out_flags;
-			gconstpointer value;
-			gboolean is_default;
-
-			header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
-			info = header_cell->col->selection_item->info;
-
-			cell->row_idx = i_row;
-			cell->header_cell = header_cell;
-
-			value = nm_meta_abstract_info_get (info,
-			                                   nmc_meta_environment,
-			                                   nmc_meta_environment_arg,
-			                                   target,
-			                                   targets_data,
-			                                   text_get_type,
-			                                   text_get_flags,
-			                                   &text_out_flags,
-			                                   &is_default,
-			                                   (gpointer *) &to_free);
-
-			nm_assert (!to_free || value == to_free);
-
-			if (   is_default
-			    && (   nmc_config->overview
-			        || NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_HIDE))) {
-				/* don't mark the entry for display. This is to shorten the output in case
-				 * the property is the default value. But we only do that, if the user
-				 * opts in to this behavior (-overview), or of the property marks itself
-				 * eligible to be hidden.
-				 *
-				 * In general, only new API shall mark itself eligible to be hidden.
-				 * Long established properties cannot, because it would be a change
-				 * in behavior. */
-			} else
-				header_cell->to_print = TRUE;
-
-			if (NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_STRV)) {
-				if (nmc_config->multiline_output) {
-					cell->text_format = PRINT_DATA_CELL_FORMAT_TYPE_STRV;
-					cell->text.strv = value;
-					cell->text_to_free = !!to_free;
-				} else {
-					if (value && ((const char *const*) value)[0]) {
-						cell->text.plain = g_strjoinv (" | ", (char **) value);
-						cell->text_to_free = TRUE;
-					}
-					if (to_free)
-						g_strfreev ((char **) to_free);
-				}
-			} else {
-				cell->text.plain = value;
+	for (i_col = 0; i_col < header_row->len; i_col++) {
+		char *to_free = NULL;
+		PrintDataCell *cell = &cells_line[i_col];
+		PrintDataHeaderCell *header_cell;
+		const NMMetaAbstractInfo *info;
+		NMMetaAccessorGetOutFlags text_out_flags, color_out_flags;
+		gconstpointer value;
+		gboolean is_default;
+
+		header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
+		info = header_cell->col->selection_item->info;
+
+		cell->row_idx = i_row;
+		cell->header_cell = header_cell;
+
+		value = nm_meta_abstract_info_get (info,
+		                                   nmc_meta_environment,
+		                                   nmc_meta_environment_arg,
+		                                   target,
+		                                   targets_data,
+		                                   text_get_type,
+		                                   text_get_flags,
+		                                   &text_out_flags,
+		                                   &is_default,
+		                                   (gpointer *) &to_free);
+
+		nm_assert (!to_free || value == to_free);
+
+		if (   is_default
+		    && (   nmc_config->overview
+		        || NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_HIDE))) {
+			/* don't mark the entry for display. This is to shorten the output in case
+			 * the property is the default value. But we only do that, if the user
+			 * opts in to this behavior (-overview), or of the property marks itself
+			 * eligible to be hidden.
+			 *
+			 * In general, only new API shall mark itself eligible to be hidden.
+			 * Long established properties cannot, because it would be a change
+			 * in behavior. */
+		} else if (update_to_print)
+			header_cell->to_print = TRUE;
+
+		if (NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_STRV)) {
+			if (nmc_config->multiline_output) {
+				cell->text_format = PRINT_DATA_CELL_FORMAT_TYPE_STRV;
+				cell->text.strv = value;
 				cell->text_to_free = !!to_free;
+			} else {
+				if (value && ((const char *const*) value)[0]) {
+					cell->text.plain = g_strjoinv (" | ", (char **) value);
+					cell->text_to_free = TRUE;
+				}
+				if (to_free)
+					g_strfreev ((char **) to_free);
 			}
+		} else {
+			cell->text.plain = value;
+			cell->text_to_free = !!to_free;
+		}
 
-			cell->color = GPOINTER_TO_INT (nm_meta_abstract_info_get (info,
-			                                                          nmc_meta_environment,
-			                                                          nmc_meta_environment_arg,
-			                                                          target,
-			                                                          targets_data,
-			                                                          NM_META_ACCESSOR_GET_TYPE_COLOR,
-			                                                          NM_META_ACCESSOR_GET_FLAGS_NONE,
-			                                                          &color_out_flags,
-			                                                          NULL,
-			                                                          NULL));
-
-			if (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_PLAIN) {
-				if (   NM_IN_SET (nmc_config->print_output, NMC_PRINT_NORMAL, NMC_PRINT_PRETTY)
-				    && (   !cell->text.plain
-				        || !cell->text.plain[0])) {
-					_print_data_cell_clear_text (cell);
-					cell->text.plain = "--";
-				} else if (!cell->text.plain)
-					cell->text.plain = "";
-				nm_assert (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_PLAIN);
-			}
+		cell->color = GPOINTER_TO_INT (nm_meta_abstract_info_get (info,
+		                                                          nmc_meta_environment,
+		                                                          nmc_meta_environment_arg,
+		                                                          target,
+		                                                          targets_data,
+		                                                          NM_META_ACCESSOR_GET_TYPE_COLOR,
+		                                                          NM_META_ACCESSOR_GET_FLAGS_NONE,
+		                                                          &color_out_flags,
+		                                                          NULL,
+		                                                          NULL));
+
+		if (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_PLAIN) {
+			if (   NM_IN_SET (nmc_config->print_output, NMC_PRINT_NORMAL, NMC_PRINT_PRETTY)
+			    && (   !cell->text.plain
+			        || !cell->text.plain[0])) {
+				_print_data_cell_clear_text (cell);
+				cell->text.plain = "--";
+			} else if (!cell->text.plain)
+				cell->text.plain = "";
+			nm_assert (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_PLAIN);
 		}
 	}
+}
+
+static void
+_print_fill_widths (GArray *header_row,
+                    const PrintDataCell *cells,
+                    guint rows_len)
+{
+	guint i_row, i_col;
 
 	for (i_col = 0; i_col < header_row->len; i_col++) {
 		PrintDataHeaderCell *header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
 
 		header_cell->width = nmc_string_screen_width (header_cell->title, NULL);
 
-		for (i_row = 0; i_row < targets_len; i_row++) {
-			const PrintDataCell *cell = &g_array_index (cells, PrintDataCell, i_row * cols_len + i_col);
+		for (i_row = 0; i_row < rows_len; i_row++) {
+			const PrintDataCell *cell = &cells[i_row * header_row->len + i_col];
 			const char *const*i_strv;
 
 			switch (cell->text_format) {
@@ -1177,9 +1181,33 @@ _print_fill (const NmcConfig *nmc_config,
 
 		header_cell->width += 1;
 	}
+}
+
+static GArray *
+_print_fill_cells (const NmcConfig *nmc_config,
+                   GArray *header_row,
+                   gpointer const *targets,
+                   gpointer targets_data,
+                   guint targets_len)
+{
+	GArray *cells;
+	guint i_row;
 
-	*out_header_row = header_row;
-	*out_cells = cells;
+	cells = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataCell), targets_len * header_row->len);
+	g_array_set_clear_func (cells, _print_data_cell_clear);
+	g_array_set_size (cells, targets_len * header_row->len);
+
+	for (i_row = 0; i_row < targets_len; i_row++) {
+		_print_fill_row (nmc_config,
+		                 header_row,
+		                 targets[i_row],
+		                 targets_data,
+		                 i_row,
+		                 TRUE,
+		                 &g_array_index (cells, PrintDataCell, i_row * header_row->len));
+	}
+
+	return cells;
 }
 
 static gboolean
@@ -1219,16 +1247,14 @@ _print_skip_column (const NmcConfig *nmc_config,
 }
 
 static void
-_print_do (const NmcConfig *nmc_config,
-           const char *header_name_no_l10n,
-           guint col_len,
-           guint row_len,
-           const PrintDataHeaderCell *header_row,
-           const PrintDataCell *cells)
+_print_do_header (const NmcConfig *nmc_config,
+                  const char *header_name_no_l10n,
+                  guint col_len,
+                  const PrintDataHeaderCell *header_row)
 {
 	int width1, width2;
 	int table_width = 0;
-	guint i_row, i_col;
+	guint i_col;
 	nm_auto_free_gstring GString *str = NULL;
 
 	g_assert (col_len);
@@ -1257,13 +1283,10 @@ _print_do (const NmcConfig *nmc_config,
 		g_print ("%s\n", line);
 	}
 
-	str = !nmc_config->multiline_output
-	      ? g_string_sized_new (100)
-	      : NULL;
-
 	/* print the header for the tabular form */
 	if (   NM_IN_SET (nmc_config->print_output, NMC_PRINT_NORMAL, NMC_PRINT_PRETTY)
 	    && !nmc_config->multiline_output) {
+		str = g_string_sized_new (100);
 		for (i_col = 0; i_col < col_len; i_col++) {
 			const PrintDataHeaderCell *header_cell = &header_row[i_col];
 			const char *title;
@@ -1283,7 +1306,6 @@ _print_do (const NmcConfig *nmc_config,
 		if (str->len)
 			g_string_truncate (str, str->len-1);  /* Chop off last column separator */
 		g_print ("%s\n", str->str);
-		g_string_truncate (str, 0);
 
 		/* Print horizontal separator */
 		if (nmc_config->print_output == NMC_PRINT_PRETTY) {
@@ -1292,6 +1314,22 @@ _print_do (const NmcConfig *nmc_config,
 			g_print ("%s\n", (line = g_strnfill (table_width, '-')));
 		}
 	}
+}
+
+static void
+_print_do_rows (const NmcConfig *nmc_config,
+                guint col_len,
+                guint row_len,
+                const PrintDataHeaderCell *header_row,
+                const PrintDataCell *cells)
+{
+	int width1, width2;
+	guint i_row, i_col;
+	nm_auto_free_gstring GString *str = NULL;
+
+	str = !nmc_config->multiline_output
+	      ? g_string_sized_new (100)
+	      : NULL;
 
 	for (i_row = 0; i_row < row_len; i_row++) {
 		const PrintDataCell *current_line = &cells[i_row * col_len];
@@ -1359,7 +1397,6 @@ _print_do (const NmcConfig *nmc_config,
 						width2 = nmc_string_screen_width (text, NULL);  /* Width of the string (in screen columns) */
 						g_string_append_printf (str, "%-*s", (int) (header_cell->width + width1 - width2), text);
 						g_string_append_c (str, ' ');  /* Column separator */
-						table_width += header_cell->width + width1 - width2 + 1;
 					}
 				}
 			}
@@ -1382,6 +1419,38 @@ _print_do (const NmcConfig *nmc_config,
 	}
 }
 
+/* In streaming mode, only the first rows are filled in advance. Afterwards,
+ * each row is printed as soon as it is generated and freed right after.
+ * That is only done for terse output, which does not align columns. */
+#define PRINT_STREAM_SAMPLE_ROWS 64
+
+static gboolean
+_print_use_streaming (const NmcConfig *nmc_config,
+                      GArray *header_row,
+                      guint targets_len)
+{
+	guint i_col;
+
+	if (targets_len <= PRINT_STREAM_SAMPLE_ROWS)
+		return FALSE;
+
+	/* the sample decides which columns get printed. That only works if no
+	 * column can hide itself, which cells do for default values in overview
+	 * mode and for properties that mark themselves eligible to be hidden. */
+	if (nmc_config->overview)
+		return FALSE;
+	for (i_col = 0; i_col < header_row->len; i_col++) {
+		const PrintDataHeaderCell *header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
+
+		if (header_cell->col->selection_item->info->meta_type != &nmc_meta_type_generic_info)
+			return FALSE;
+	}
+
+	/* tabular output aligns all rows to the widest cell, which is only
+	 * known after filling all of them. */
+	return nmc_config->print_output == NMC_PRINT_TERSE;
+}
+
 gboolean
 nmc_print (const NmcConfig *nmc_config,
            gpointer const *targets,
@@ -1395,26 +1464,71 @@ nmc_print (const NmcConfig *nmc_config,
 	gs_unref_array GArray *cols = NULL;
 	gs_unref_array GArray *header_row = NULL;
 	gs_unref_array GArray *cells = NULL;
+	guint targets_len;
+	guint rows_len;
+	guint i_row;
 
 	if (!_output_selection_parse (fields, fields_str,
 	                              &cols, &gfree_keeper,
 	                              error))
 		return FALSE;
 
-	_print_fill (nmc_config,
-	             targets,
-	             targets_data,
-	             &g_array_index (cols, PrintDataCol, 0),
-	             cols->len,
-	             &header_row,
-	             &cells);
-
-	_print_do (nmc_config,
-	           header_name_no_l10n,
-	           header_row->len,
-	           cells->len / header_row->len,
-	           &g_array_index (header_row, PrintDataHeaderCell, 0),
-	           &g_array_index (cells, PrintDataCell, 0));
+	targets_len = NM_PTRARRAY_LEN (targets);
+
+	header_row = _print_fill_header (nmc_config,
+	                                 &g_array_index (cols, PrintDataCol, 0),
+	                                 cols->len);
+
+	rows_len = _print_use_streaming (nmc_config, header_row, targets_len)
+	           ? PRINT_STREAM_SAMPLE_ROWS
+	           : targets_len;
+
+	cells = _print_fill_cells (nmc_config,
+	                           header_row,
+	                           targets,
+	                           targets_data,
+	                           rows_len);
+	_print_fill_widths (header_row,
+	                    &g_array_index (cells, PrintDataCell, 0),
+	                    rows_len);
+
+	_print_do_header (nmc_config,
+	                  header_name_no_l10n,
+	                  header_row->len,
+	                  &g_array_index (header_row, PrintDataHeaderCell, 0));
+	_print_do_rows (nmc_config,
+	                header_row->len,
+	                rows_len,
+	                &g_array_index (header_row, PrintDataHeaderCell, 0),
+	                &g_array_index (cells, PrintDataCell, 0));
+
+	if (rows_len == targets_len)
+		return TRUE;
+
+	/* Stream the remaining rows, reusing the cells of one row. No column
+	 * can be hidden, so the sample already selected all of them for
+	 * printing. */
+	g_array_set_size (cells, header_row->len);
+	for (i_row = rows_len; i_row < targets_len; i_row++) {
+		guint i_col;
+
+		for (i_col = 0; i_col < header_row->len; i_col++)
+			_print_data_cell_clear (&g_array_index (cells, PrintDataCell, i_col));
+
+		_print_fill_row (nmc_config,
+		                 header_row,
+		                 targets[i_row],
+		                 targets_data,
+		                 i_row,
+		                 FALSE,
+		                 &g_array_index (cells, PrintDataCell, 0));
+
+		_print_do_rows (nmc_config,
+		                header_row->len,
+		                1,
+		                &g_array_index (header_row, PrintDataHeaderCell, 0),
+		                &g_array_index (cells, PrintDataCell, 0));
+	}
 
 	return TRUE;
 }
@@ -49,11 +49,12 @@
 typedef struct
 {
 	GMainLoop *loop;
-	NMClient *client;
-	GCancellable *client_new_cancellable;
-	guint client_new_timeout_id;
+	GDBusProxy *proxy;
+	GCancellable *proxy_new_cancellable;
+	guint proxy_new_timeout_id;
 	guint handle_timeout_id;
-	gulong client_notify_id;
+	gulong proxy_name_owner_id;
+	gulong proxy_properties_changed_id;
 	gboolean exit_no_nm;
 	gboolean wait_startup;
 	gboolean quiet;
@@ -76,7 +77,8 @@ _return (OnlineData *data, int retval)
 	nm_assert (data->retval == EXIT_FAILURE_UNSPECIFIED);
 
 	data->retval = retval;
-	nm_clear_g_signal_handler (data->client, &data->client_notify_id);
+	nm_clear_g_signal_handler (data->proxy, &data->proxy_name_owner_id);
+	nm_clear_g_signal_handler (data->proxy, &data->proxy_properties_changed_id);
 	g_main_loop_quit (data->loop);
 }
 
@@ -114,19 +116,59 @@ _print_progress (gboolean wait_startup, int progress_next_step_i, gint64 remaini
 	fflush (stdout);
 }
 
+/*****************************************************************************/
+
+/* nm-online only cares about the "State" and "Startup" properties of the manager.
+ * Instead of creating a NMClient, which fetches all objects and all connection
+ * profiles, use a plain proxy for the manager object. That matters during boot,
+ * where nm-online competes with NetworkManager itself for CPU. */
+
+static NMState
+_proxy_get_state (GDBusProxy *proxy)
+{
+	gs_unref_variant GVariant *v = NULL;
+
+	v = g_dbus_proxy_get_cached_property (proxy, "State");
+	if (   v
+	    && g_variant_is_of_type (v, G_VARIANT_TYPE_UINT32))
+		return g_variant_get_uint32 (v);
+	return NM_STATE_UNKNOWN;
+}
+
+static gboolean
+_proxy_get_startup (GDBusProxy *proxy)
+{
+	gs_unref_variant GVariant *v = NULL;
+
+	v = g_dbus_proxy_get_cached_property (proxy, "Startup");
+	if (   v
+	    && g_variant_is_of_type (v, G_VARIANT_TYPE_BOOLEAN))
+		return g_variant_get_boolean (v);
+	return FALSE;
+}
+
+static gboolean
+_proxy_get_nm_running (GDBusProxy *proxy)
+{
+	gs_free char *name_owner = NULL;
+
+	name_owner = g_dbus_proxy_get_name_owner (proxy);
+	return !!name_owner;
+}
+
 static gboolean
 quit_if_connected (OnlineData *data)
 {
 	NMState state;
 
-	state = nm_client_get_state (data->client);
-	if (!nm_client_get_nm_running (data->client)) {
+	state = _proxy_get_state (data->proxy);
+	if (!_proxy_get_nm_running (data->proxy)) {
 		if (data->exit_no_nm) {
 			_return (data, EXIT_FAILURE_OFFLINE);
 			return TRUE;
 		}
 	} else if (data->wait_startup) {
-		if (!nm_client_get_startup (data->client)) {
+		if (!_proxy_get_startup (data->proxy)) {
 			_return (data, EXIT_SUCCESS);
 			return TRUE;
 		}
@@ -147,9 +189,18 @@ quit_if_connected (OnlineData *data)
 }
 
 static void
-client_properties_changed (GObject *object,
-                           GParamSpec *pspec,
-                           gpointer user_data)
+proxy_name_owner_changed (GObject *object,
+                          GParamSpec *pspec,
+                          gpointer user_data)
+{
+	quit_if_connected (user_data);
+}
+
+static void
+proxy_properties_changed (GDBusProxy *proxy,
+                          GVariant *changed_properties,
+                          const char *const*invalidated_properties,
+                          gpointer user_data)
 {
 	quit_if_connected (user_data);
 }
@@ -197,45 +248,49 @@ handle_timeout (gpointer user_data)
 }
 
 static gboolean
-got_client_timeout (gpointer user_data)
+got_proxy_timeout (gpointer user_data)
 {
 	OnlineData *data = user_data;
 
-	data->client_new_timeout_id = 0;
+	data->proxy_new_timeout_id = 0;
 	data->quiet = TRUE;
-	g_printerr (_("Error: timeout creating NMClient object\n"));
+	g_printerr (_("Error: timeout creating D-Bus proxy for NetworkManager\n"));
 	_return (data, EXIT_FAILURE_LIBNM_BUG);
 	return G_SOURCE_REMOVE;
 }
 
 static void
-got_client (GObject *source_object, GAsyncResult *res, gpointer user_data)
+got_proxy (GObject *source_object, GAsyncResult *res, gpointer user_data)
 {
 	OnlineData *data = user_data;
 	gs_free_error GError *error = NULL;
-	NMClient *client;
+	GDBusProxy *proxy;
 
-	nm_clear_g_source (&data->client_new_timeout_id);
-	g_clear_object (&data->client_new_cancellable);
+	nm_clear_g_source (&data->proxy_new_timeout_id);
+	g_clear_object (&data->proxy_new_cancellable);
 
-	client = nm_client_new_finish (res, &error);
-	if (!client) {
+	proxy = g_dbus_proxy_new_for_bus_finish (res, &error);
+	if (!proxy) {
 		if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
 			return;
 		data->quiet = TRUE;
-		g_printerr (_("Error: Could not create NMClient object: %s\n"),
+		g_printerr (_("Error: Could not create D-Bus proxy for NetworkManager: %s\n"),
 		            error->message);
 		_return (data, EXIT_FAILURE_ERROR);
 		return;
 	}
 
-	data->client = client;
+	data->proxy = proxy;
 
 	if (quit_if_connected (data))
 		return;
 
-	data->client_notify_id = g_signal_connect (data->client, "notify",
-	                                           G_CALLBACK (client_properties_changed), data);
+	/* GDBusProxy reloads the properties when NetworkManager (re)appears on the bus,
+	 * before notifying about the new name owner. */
+	data->proxy_name_owner_id = g_signal_connect (data->proxy, "notify::g-name-owner",
+	                                              G_CALLBACK (proxy_name_owner_changed), data);
+	data->proxy_properties_changed_id = g_signal_connect (data->proxy, "g-properties-changed",
+	                                                      G_CALLBACK (proxy_properties_changed), data);
 	data->handle_timeout_id = g_timeout_add (data->quiet ? NM_MAX (0, data->end_timestamp_ms - _now_ms ()) : 0, handle_timeout, data);
 }
 
@@ -297,18 +352,27 @@ main (int argc, char *argv[])
 	data.end_timestamp_ms = data.start_timestamp_ms + (t_secs * 1000);
 	data.progress_step_duration = NM_MAX (1, (data.end_timestamp_ms - data.start_timestamp_ms + PROGRESS_STEPS/2) / PROGRESS_STEPS);
 
-	data.client_new_cancellable = g_cancellable_new ();
+	data.proxy_new_cancellable = g_cancellable_new ();
 
-	data.client_new_timeout_id = g_timeout_add_seconds (30, got_client_timeout, &data);
-	nm_client_new_async (data.client_new_cancellable, got_client, &data);
+	data.proxy_new_timeout_id = g_timeout_add_seconds (30, got_proxy_timeout, &data);
+	g_dbus_proxy_new_for_bus (G_BUS_TYPE_SYSTEM,
+	                          G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START,
+	                          NULL,
+	                          NM_DBUS_SERVICE,
+	                          NM_DBUS_PATH,
+	                          NM_DBUS_INTERFACE,
+	                          data.proxy_new_cancellable,
+	                          got_proxy,
+	                          &data);
 
 	g_main_loop_run (data.loop);
 
-	nm_clear_g_cancellable (&data.client_new_cancellable);
-	nm_clear_g_source (&data.client_new_timeout_id);
+	nm_clear_g_cancellable (&data.proxy_new_cancellable);
+	nm_clear_g_source (&data.proxy_new_timeout_id);
 	nm_clear_g_source (&data.handle_timeout_id);
-	nm_clear_g_signal_handler (data.client, &data.client_notify_id);
-	g_clear_object (&data.client);
+	nm_clear_g_signal_handler (data.proxy, &data.proxy_name_owner_id);
+	nm_clear_g_signal_handler (data.proxy, &data.proxy_properties_changed_id);
+	g_clear_object (&data.proxy);
 
 	g_clear_pointer (&data.loop, g_main_loop_unref);
 
@@ -400,17 +400,23 @@ class AsyncProcess():
     def __init__(self,
                  args,
                  env,
-                 complete_cb):
+                 complete_cb,
+                 stdin_data = None):
         self._args = args
         self._env = env
         self._complete_cb = complete_cb
+        self._stdin_data = stdin_data
 
     def start(self):
         if not hasattr(self, '_p'):
             self._p = subprocess.Popen(self._args,
+                                       stdin = subprocess.PIPE if self._stdin_data is not None else None,
                                        stdout = subprocess.PIPE,
                                        stderr = subprocess.PIPE,
                                        env = self._env)
+            if self._stdin_data is not None:
+                self._p.stdin.write(self._stdin_data)
+                self._p.stdin.close()
 
     def wait(self):
 
@@ -487,6 +493,7 @@ class TestNmcli(NmTestBase):
                              sort_lines_stdout,
                              extra_env,
                              sync_barrier,
+                             None,
                              frame)
 
 
@@ -503,7 +510,8 @@ class TestNmcli(NmTestBase):
                    replace_stderr = None,
                    sort_lines_stdout = False,
                    extra_env = None,
-                   sync_barrier = None):
+                   sync_barrier = None,
+                   stdin_data = None):
 
         frame = sys._getframe(1)
 
@@ -530,6 +538,7 @@ class TestNmcli(NmTestBase):
                              sort_lines_stdout,
                              extra_env,
                              sync_barrier,
+                             stdin_data,
                              frame)
 
     def _call_nmcli(self,
@@ -545,6 +554,7 @@ class TestNmcli(NmTestBase):
                     sort_lines_stdout,
                     extra_env,
                     sync_barrier,
+                    stdin_data,
                     frame):
 
         if sync_barrier:
@@ -680,7 +690,8 @@ class TestNmcli(NmTestBase):
 
         async_job = AsyncProcess(args = args,
                                  env = env,
-                                 complete_cb = complete_cb)
+                                 complete_cb = complete_cb,
+                                 stdin_data = stdin_data)
 
         self._async_jobs.append(async_job)
 
@@ -1097,6 +1108,45 @@ class TestNmcli(NmTestBase):
             self.call_nmcli_l(mode + ['-f', 'GENERAL,CAPABILITIES,WIFI-PROPERTIES,AP,WIRED-PROPERTIES,WIMAX-PROPERTIES,NSP,IP4,DHCP4,IP6,DHCP6,BOND,TEAM,BRIDGE,VLAN,BLUETOOTH,CONNECTIONS', 'device', 'show', 'wlan0' ],
                               replace_stdout = replace_stdout)
 
+    @nm_test
+    def test_005(self):
+        self.init_001()
+
+        batch = ('# the second line fails\n'
+                 'bogus\n'
+                 'connection show\n').encode('utf8')
+
+        # without --keep-going the batch stops at the first failure.
+        self.call_nmcli(['--batch', '-'],
+                        stdin_data = batch)
+
+        # with --keep-going the remaining lines run and the failure
+        # is still reported.
+        self.call_nmcli(['--keep-going', '--batch', '-'],
+                        stdin_data = batch)
+
+    @nm_test
+    def test_006(self):
+        self.init_001()
+
+        # more rows than nmcli uses to lay out a table before it starts
+        # streaming. Only the last row has a device.
+        names = ['con-%02d' % (i) for i in range(70)]
+        for name in names:
+            self.srv.addConnection( {
+                                        'connection': {
+                                            'type': '802-3-ethernet',
+                                            'id':   name,
+                                        },
+                                    })
+
+        self.call_nmcli(['con', 'up', names[-1], 'ifname', 'eth0'],
+                        expected_returncode = 0,
+                        expected_stdout = _UNSTABLE_OUTPUT)
+
+        self.call_nmcli(['-t', '-f', 'NAME,DEVICE', 'con', 'show', '--order', 'name'],
+                        sort_lines_stdout = True)
+
 ###############################################################################
 
 def main():
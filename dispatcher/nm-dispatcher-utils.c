@@ -579,3 +579,50 @@ done:
 	g_ptr_array_add (items, NULL);
 	return (char **) g_ptr_array_free (g_steal_pointer (&items), FALSE);
 }
+
+/*****************************************************************************/
+
+static gsize
+_script_group_prefix (const char *path, const char **out_name)
+{
+	const char *name;
+	gsize n;
+
+	name = strrchr (path, '/');
+	name = name ? &name[1] : path;
+
+	for (n = 0; g_ascii_isdigit (name[n]); n++) {
+		/* pass */
+	}
+
+	*out_name = name;
+	return n;
+}
+
+/**
+ * nm_dispatcher_utils_script_same_group:
+ * @path_a: path of a dispatcher script
+ * @path_b: path of another dispatcher script
+ *
+ * Scripts whose file name starts with the same numeric prefix (like
+ * "20-foo" and "20-bar") belong to the same ordering group. Scripts
+ * without numeric prefix are never in a group with another script.
+ *
+ * Returns: %TRUE if both scripts belong to the same group and may be
+ *   run concurrently.
+ */
+gboolean
+nm_dispatcher_utils_script_same_group (const char *path_a,
+                                       const char *path_b)
+{
+	const char *name_a, *name_b;
+	gsize n_a, n_b;
+
+	n_a = _script_group_prefix (path_a, &name_a);
+	if (n_a == 0)
+		return FALSE;
+
+	n_b = _script_group_prefix (path_b, &name_b);
+	return    n_a == n_b
+	       && memcmp (name_a, name_b, n_a) == 0;
+}
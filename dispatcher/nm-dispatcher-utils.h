@@ -39,5 +39,8 @@ nm_dispatcher_utils_construct_envp (const char *action,
                                     char **out_iface,
                                     const char **out_error_message);
 
+gboolean nm_dispatcher_utils_script_same_group (const char *path_a,
+                                                const char *path_b);
+
 #endif  /* __NETWORKMANAGER_DISPATCHER_UTILS_H__ */
 
@@ -39,6 +39,7 @@
 static GMainLoop *loop = NULL;
 static gboolean debug = FALSE;
 static gboolean persist = FALSE;
+static int max_parallel = 1;
 static guint quit_id;
 static guint request_id_counter = 0;
 
@@ -87,6 +88,27 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
                gboolean request_debug,
                gpointer user_data);
 
+static gboolean
+handle_action2 (NMDBusDispatcher *dbus_dispatcher,
+                GDBusMethodInvocation *context,
+                const char *str_action,
+                GVariant *connection_dict,
+                GVariant *connection_props,
+                GVariant *device_props,
+                GVariant *device_proxy_props,
+                GVariant *device_ip4_props,
+                GVariant *device_ip6_props,
+                GVariant *device_dhcp4_props,
+                GVariant *device_dhcp6_props,
+                const char *connectivity_state,
+                const char *vpn_ip_iface,
+                GVariant *vpn_proxy_props,
+                GVariant *vpn_ip4_props,
+                GVariant *vpn_ip6_props,
+                gboolean request_debug,
+                GVariant *options,
+                gpointer user_data);
+
 static void
 handler_init (Handler *h)
 {
@@ -94,6 +116,8 @@ handler_init (Handler *h)
 	h->dbus_dispatcher = nmdbus_dispatcher_skeleton_new ();
 	g_signal_connect (h->dbus_dispatcher, "handle-action",
 	                  G_CALLBACK (handle_action), h);
+	g_signal_connect (h->dbus_dispatcher, "handle-action2",
+	                  G_CALLBACK (handle_action2), h);
 }
 
 static void
@@ -114,6 +138,9 @@ typedef struct {
 	gboolean dispatched;
 	guint watch_id;
 	guint timeout_id;
+	guint group;
+	gint64 start_time_us;
+	gint64 duration_us;
 } ScriptInfo;
 
 struct Request {
@@ -131,6 +158,17 @@ struct Request {
 	guint idx;
 	int num_scripts_done;
 	int num_scripts_nowait;
+
+	/* the number of "wait" scripts currently running. Only with
+	 * @max_parallel larger than one, this can be larger than one, in
+	 * which case all running scripts belong to @running_group. */
+	int num_scripts_running;
+	guint running_group;
+	guint max_parallel;
+
+	/* whether the request came via Action2(), which also returns the
+	 * durations of the scripts. */
+	bool is_action2:1;
 };
 
 /*****************************************************************************/
@@ -278,6 +316,7 @@ static void
 complete_request (Request *request)
 {
 	GVariantBuilder results;
+	GVariantBuilder durations;
 	GVariant *ret;
 	guint i;
 	Handler *handler = request->handler;
@@ -289,6 +328,7 @@ complete_request (Request *request)
 		return;
 
 	g_variant_builder_init (&results, G_VARIANT_TYPE ("a(sus)"));
+	g_variant_builder_init (&durations, G_VARIANT_TYPE ("at"));
 	for (i = 0; i < request->scripts->len; i++) {
 		ScriptInfo *script = g_ptr_array_index (request->scripts, i);
 
@@ -296,9 +336,16 @@ complete_request (Request *request)
 		                       script->script,
 		                       script->result,
 		                       script->error ?: "");
+		g_variant_builder_add (&durations, "t",
+		                       (guint64) script->duration_us);
 	}
 
-	ret = g_variant_new ("(a(sus))", &results);
+	if (request->is_action2)
+		ret = g_variant_new ("(a(sus)at)", &results, &durations);
+	else {
+		g_variant_builder_clear (&durations);
+		ret = g_variant_new ("(a(sus))", &results);
+	}
 	g_dbus_method_invocation_return_value (request->context, ret);
 
 	_LOG_R_D (request, "completed (%u scripts)", request->scripts->len);
@@ -363,8 +410,8 @@ complete_script (ScriptInfo *script)
 		 *
 		 * Also, it cannot be that there is another request currently being
 		 * processed because only requests with "wait" scripts can become
-		 * @current_request. As there can only be one "wait" script running
-		 * at any time, it means complete_request() above completed @request. */
+		 * @current_request. As dispatch_one_script() found no more running
+		 * "wait" scripts, it means complete_request() above completed @request. */
 		nm_assert (!handler->current_request);
 	}
 
@@ -384,6 +431,17 @@ complete_script (ScriptInfo *script)
 	}
 }
 
+static void
+script_finished (ScriptInfo *script)
+{
+	script->duration_us = g_get_monotonic_time () - script->start_time_us;
+	script->request->num_scripts_done++;
+	if (!script->wait)
+		script->request->num_scripts_nowait--;
+	else
+		script->request->num_scripts_running--;
+}
+
 static void
 script_watch_cb (GPid pid, int status, gpointer user_data)
 {
@@ -394,9 +452,7 @@ script_watch_cb (GPid pid, int status, gpointer user_data)
 
 	script->watch_id = 0;
 	nm_clear_g_source (&script->timeout_id);
-	script->request->num_scripts_done++;
-	if (!script->wait)
-		script->request->num_scripts_nowait--;
+	script_finished (script);
 
 	if (WIFEXITED (status)) {
 		err = WEXITSTATUS (status);
@@ -418,10 +474,12 @@ script_watch_cb (GPid pid, int status, gpointer user_data)
 	}
 
 	if (script->result == DISPATCH_RESULT_SUCCESS) {
-		_LOG_S_D (script, "complete");
+		_LOG_S_D (script, "complete (%"G_GINT64_FORMAT" msec)",
+		          script->duration_us / 1000);
 	} else {
 		script->result = DISPATCH_RESULT_FAILED;
-		_LOG_S_W (script, "complete: failed with %s", script->error);
+		_LOG_S_W (script, "complete: failed with %s (%"G_GINT64_FORMAT" msec)",
+		          script->error, script->duration_us / 1000);
 	}
 
 	g_spawn_close_pid (script->pid);
@@ -436,9 +494,7 @@ script_timeout_cb (gpointer user_data)
 
 	script->timeout_id = 0;
 	nm_clear_g_source (&script->watch_id);
-	script->request->num_scripts_done++;
-	if (!script->wait)
-		script->request->num_scripts_nowait--;
+	script_finished (script);
 
 	_LOG_S_W (script, "complete: timeout (kill script)");
 
@@ -541,11 +597,14 @@ script_dispatch (ScriptInfo *script)
 
 	_LOG_S_D (script, "run script%s", script->wait ? "" : " (no-wait)");
 
+	script->start_time_us = g_get_monotonic_time ();
 	if (g_spawn_async ("/", argv, request->envp, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL, &script->pid, &error)) {
 		script->watch_id = g_child_watch_add (script->pid, (GChildWatchFunc) script_watch_cb, script);
 		script->timeout_id = g_timeout_add_seconds (SCRIPT_TIMEOUT, script_timeout_cb, script);
 		if (!script->wait)
 			request->num_scripts_nowait++;
+		else
+			request->num_scripts_running++;
 		return TRUE;
 	} else {
 		_LOG_S_W (script, "complete: failed to execute script: %s", error->message);
@@ -557,6 +616,16 @@ script_dispatch (ScriptInfo *script)
 	}
 }
 
+/**
+ * dispatch_one_script:
+ * @request: the request
+ *
+ * Schedules the next "wait" script(s) of @request. By default, scripts
+ * run one after another. Up to @max_parallel scripts of the request
+ * that belong to the same ordering group run concurrently.
+ *
+ * Returns: %TRUE, if there are still scripts running for @request.
+ */
 static gboolean
 dispatch_one_script (Request *request)
 {
@@ -566,11 +635,22 @@ dispatch_one_script (Request *request)
 	while (request->idx < request->scripts->len) {
 		ScriptInfo *script;
 
-		script = g_ptr_array_index (request->scripts, request->idx++);
-		if (script_dispatch (script))
+		script = g_ptr_array_index (request->scripts, request->idx);
+		if (script->dispatched) {
+			request->idx++;
+			continue;
+		}
+
+		if (   request->num_scripts_running > 0
+		    && (   request->num_scripts_running >= request->max_parallel
+		        || script->group != request->running_group))
 			return TRUE;
+
+		request->idx++;
+		if (script_dispatch (script))
+			request->running_group = script->group;
 	}
-	return FALSE;
+	return request->num_scripts_running > 0;
 }
 
 static GSList *
@@ -657,26 +737,26 @@ script_must_wait (const char *path)
 }
 
 static gboolean
-handle_action (NMDBusDispatcher *dbus_dispatcher,
-               GDBusMethodInvocation *context,
-               const char *str_action,
-               GVariant *connection_dict,
-               GVariant *connection_props,
-               GVariant *device_props,
-               GVariant *device_proxy_props,
-               GVariant *device_ip4_props,
-               GVariant *device_ip6_props,
-               GVariant *device_dhcp4_props,
-               GVariant *device_dhcp6_props,
-               const char *connectivity_state,
-               const char *vpn_ip_iface,
-               GVariant *vpn_proxy_props,
-               GVariant *vpn_ip4_props,
-               GVariant *vpn_ip6_props,
-               gboolean request_debug,
-               gpointer user_data)
+_handle_action (Handler *h,
+                GDBusMethodInvocation *context,
+                gboolean is_action2,
+                const char *str_action,
+                GVariant *connection_dict,
+                GVariant *connection_props,
+                GVariant *device_props,
+                GVariant *device_proxy_props,
+                GVariant *device_ip4_props,
+                GVariant *device_ip6_props,
+                GVariant *device_dhcp4_props,
+                GVariant *device_dhcp6_props,
+                const char *connectivity_state,
+                const char *vpn_ip_iface,
+                GVariant *vpn_proxy_props,
+                GVariant *vpn_ip4_props,
+                GVariant *vpn_ip6_props,
+                gboolean request_debug,
+                GVariant *options)
 {
-	Handler *h = user_data;
 	GSList *sorted_scripts = NULL;
 	GSList *iter;
 	Request *request;
@@ -692,6 +772,15 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 	request->debug = request_debug || debug;
 	request->context = context;
 	request->action = g_strdup (str_action);
+	request->is_action2 = is_action2;
+
+	request->max_parallel = max_parallel;
+	if (options) {
+		guint32 u32;
+
+		if (g_variant_lookup (options, NMD_OPTION_PARALLEL, "u", &u32))
+			request->max_parallel = MAX (u32, 1u);
+	}
 
 	request->envp = nm_dispatcher_utils_construct_envp (str_action,
 	                                                    connection_dict,
@@ -718,6 +807,15 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 		s->request = request;
 		s->script = iter->data;
 		s->wait = script_must_wait (s->script);
+		if (request->scripts->len > 0) {
+			ScriptInfo *prev = g_ptr_array_index (request->scripts, request->scripts->len - 1);
+
+			/* the scripts are sorted by name, so scripts with the same
+			 * numeric prefix are adjacent. */
+			s->group = prev->group;
+			if (!nm_dispatcher_utils_script_same_group (prev->script, s->script))
+				s->group++;
+		}
 		g_ptr_array_add (request->scripts, s);
 	}
 	g_slist_free (sorted_scripts);
@@ -738,7 +836,13 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 			_LOG_R_I (request, "completed: no scripts");
 
 		results = g_variant_new_array (G_VARIANT_TYPE ("(sus)"), NULL, 0);
-		g_dbus_method_invocation_return_value (context, g_variant_new ("(@a(sus))", results));
+		if (is_action2) {
+			g_dbus_method_invocation_return_value (context,
+			                                       g_variant_new ("(@a(sus)@at)",
+			                                                      results,
+			                                                      g_variant_new_array (G_VARIANT_TYPE_UINT64, NULL, 0)));
+		} else
+			g_dbus_method_invocation_return_value (context, g_variant_new ("(@a(sus))", results));
 		request->num_scripts_done = request->scripts->len;
 		request_free (request);
 		return TRUE;
@@ -793,6 +897,89 @@ handle_action (NMDBusDispatcher *dbus_dispatcher,
 	return TRUE;
 }
 
+static gboolean
+handle_action (NMDBusDispatcher *dbus_dispatcher,
+               GDBusMethodInvocation *context,
+               const char *str_action,
+               GVariant *connection_dict,
+               GVariant *connection_props,
+               GVariant *device_props,
+               GVariant *device_proxy_props,
+               GVariant *device_ip4_props,
+               GVariant *device_ip6_props,
+               GVariant *device_dhcp4_props,
+               GVariant *device_dhcp6_props,
+               const char *connectivity_state,
+               const char *vpn_ip_iface,
+               GVariant *vpn_proxy_props,
+               GVariant *vpn_ip4_props,
+               GVariant *vpn_ip6_props,
+               gboolean request_debug,
+               gpointer user_data)
+{
+	return _handle_action (user_data,
+	                       context,
+	                       FALSE,
+	                       str_action,
+	                       connection_dict,
+	                       connection_props,
+	                       device_props,
+	                       device_proxy_props,
+	                       device_ip4_props,
+	                       device_ip6_props,
+	                       device_dhcp4_props,
+	                       device_dhcp6_props,
+	                       connectivity_state,
+	                       vpn_ip_iface,
+	                       vpn_proxy_props,
+	                       vpn_ip4_props,
+	                       vpn_ip6_props,
+	                       request_debug,
+	                       NULL);
+}
+
+static gboolean
+handle_action2 (NMDBusDispatcher *dbus_dispatcher,
+                GDBusMethodInvocation *context,
+                const char *str_action,
+                GVariant *connection_dict,
+                GVariant *connection_props,
+                GVariant *device_props,
+                GVariant *device_proxy_props,
+                GVariant *device_ip4_props,
+                GVariant *device_ip6_props,
+                GVariant *device_dhcp4_props,
+                GVariant *device_dhcp6_props,
+                const char *connectivity_state,
+                const char *vpn_ip_iface,
+                GVariant *vpn_proxy_props,
+                GVariant *vpn_ip4_props,
+                GVariant *vpn_ip6_props,
+                gboolean request_debug,
+                GVariant *options,
+                gpointer user_data)
+{
+	return _handle_action (user_data,
+	                       context,
+	                       TRUE,
+	                       str_action,
+	                       connection_dict,
+	                       connection_props,
+	                       device_props,
+	                       device_proxy_props,
+	                       device_ip4_props,
+	                       device_ip6_props,
+	                       device_dhcp4_props,
+	                       device_dhcp6_props,
+	                       connectivity_state,
+	                       vpn_ip_iface,
+	                       vpn_proxy_props,
+	                       vpn_ip4_props,
+	                       vpn_ip6_props,
+	                       request_debug,
+	                       options);
+}
+
 static gboolean ever_acquired_name = FALSE;
 
 static void
@@ -896,6 +1083,7 @@ main (int argc, char **argv)
 	GOptionEntry entries[] = {
 		{ "debug", 0, 0, G_OPTION_ARG_NONE, &debug, "Output to console rather than syslog", NULL },
 		{ "persist", 0, 0, G_OPTION_ARG_NONE, &persist, "Don't quit after a short timeout", NULL },
+		{ "parallel", 0, 0, G_OPTION_ARG_INT, &max_parallel, "Run up to N scripts with the same numeric prefix concurrently, unless NetworkManager requests otherwise", "N" },
 		{ NULL }
 	};
 
@@ -911,6 +1099,9 @@ main (int argc, char **argv)
 
 	g_option_context_free (opt_ctx);
 
+	if (max_parallel < 1)
+		max_parallel = 1;
+
 	g_unix_signal_add (SIGTERM, signal_handler, GINT_TO_POINTER (SIGTERM));
 	g_unix_signal_add (SIGINT, signal_handler, GINT_TO_POINTER (SIGINT));
 
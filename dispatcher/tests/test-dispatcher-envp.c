@@ -647,6 +647,19 @@ test_up_empty_vpn_iface (void)
 	test_generic ("dispatcher-up", "");
 }
 
+static void
+test_script_same_group (void)
+{
+	g_assert (nm_dispatcher_utils_script_same_group ("/etc/dispatcher.d/20-foo", "/etc/dispatcher.d/20-bar"));
+	g_assert (nm_dispatcher_utils_script_same_group ("20-foo", "/etc/dispatcher.d/20bar"));
+	g_assert (nm_dispatcher_utils_script_same_group ("/etc/dispatcher.d/007", "/etc/dispatcher.d/007-x"));
+	g_assert (!nm_dispatcher_utils_script_same_group ("/etc/dispatcher.d/20-foo", "/etc/dispatcher.d/200-foo"));
+	g_assert (!nm_dispatcher_utils_script_same_group ("/etc/dispatcher.d/20-foo", "/etc/dispatcher.d/02-foo"));
+	g_assert (!nm_dispatcher_utils_script_same_group ("/etc/dispatcher.d/foo", "/etc/dispatcher.d/foo"));
+	g_assert (!nm_dispatcher_utils_script_same_group ("/etc/dispatcher.d/foo", "/etc/dispatcher.d/20-foo"));
+	g_assert (!nm_dispatcher_utils_script_same_group ("/etc/20.d/foo", "/etc/20.d/bar"));
+}
+
 /*****************************************************************************/
 
 NMTST_DEFINE ();
@@ -665,6 +678,8 @@ main (int argc, char **argv)
 
 	g_test_add_func ("/dispatcher/up_empty_vpn_iface", test_up_empty_vpn_iface);
 
+	g_test_add_func ("/dispatcher/script_same_group", test_script_same_group);
+
 	return g_test_run ();
 }
 
@@ -260,6 +260,11 @@ const char **_nm_ip_address_get_attribute_names (const NMIPAddress *addr, gboole
 gboolean _nm_ip_route_attribute_validate_all (const NMIPRoute *route);
 const char **_nm_ip_route_get_attribute_names (const NMIPRoute *route, gboolean sorted, guint *out_length);
 GHashTable *_nm_ip_route_get_attributes_direct (NMIPRoute *route);
+const NMIPAddr *_nm_ip_route_get_dest_direct (const NMIPRoute *route);
+const NMIPAddr *_nm_ip_route_get_next_hop_direct (const NMIPRoute *route);
+const char *_nm_ip_route_get_dest_str (const NMIPRoute *route, char *buf);
+const char *_nm_ip_route_get_next_hop_str (const NMIPRoute *route, char *buf);
+gboolean _nm_ip_route_has_attributes (const NMIPRoute *route);
 
 NMSriovVF *_nm_utils_sriov_vf_from_strparts (const char *index, const char *detail, gboolean ignore_unknown, GError **error);
 gboolean _nm_sriov_vf_attribute_validate_all (const NMSriovVF *vf, GError **error);
@@ -1746,6 +1746,8 @@ write_ip_values (GKeyFile *file,
 	guint32 plen;
 	char key_name[64];
 	char *key_name_idx;
+	char addr_buf[NM_UTILS_INET_ADDRSTRLEN];
+	char gw_buf[NM_UTILS_INET_ADDRSTRLEN];
 
 	if (!array->len)
 		return;
@@ -1764,9 +1766,9 @@ write_ip_values (GKeyFile *file,
 		if (is_route) {
 			NMIPRoute *route = array->pdata[i];
 
-			addr = nm_ip_route_get_dest (route);
+			addr = _nm_ip_route_get_dest_str (route, addr_buf);
 			plen = nm_ip_route_get_prefix (route);
-			gw = nm_ip_route_get_next_hop (route);
+			gw = _nm_ip_route_get_next_hop_str (route, gw_buf);
 			metric = nm_ip_route_get_metric (route);
 		} else {
 			NMIPAddress *address = array->pdata[i];
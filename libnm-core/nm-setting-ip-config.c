@@ -106,27 +106,6 @@ canonicalize_ip (int family, const char *ip, gboolean null_any)
 	return g_strdup (inet_ntop (family, addr_bytes, addr_str, sizeof (addr_str)));
 }
 
-static char *
-canonicalize_ip_binary (int family, gconstpointer ip, gboolean null_any)
-{
-	char string[NM_UTILS_INET_ADDRSTRLEN];
-
-	if (!ip) {
-		if (null_any)
-			return NULL;
-		if (family == AF_INET)
-			return g_strdup ("0.0.0.0");
-		if (family == AF_INET6)
-			return g_strdup ("::");
-		g_return_val_if_reached (NULL);
-	}
-	if (null_any) {
-		if (!memcmp (ip, &in6addr_any, _addr_size (family)))
-			return NULL;
-	}
-	return g_strdup (inet_ntop (family, ip, string, sizeof (string)));
-}
-
 static gboolean
 valid_ip (int family, const char *ip, GError **error)
 {
@@ -613,14 +592,52 @@ struct NMIPRoute {
 	guint refcount;
 
 	int family;
-	char *dest;
 	guint prefix;
-	char *next_hop;
 	gint64 metric;
 
+	/* Profiles can have many thousand routes. Keep the addresses in binary
+	 * form, and only create the string representation on demand, for
+	 * nm_ip_route_get_dest() and nm_ip_route_get_next_hop(). libnm-core
+	 * and the daemon serialize routes with _nm_ip_route_get_dest_str()
+	 * and _nm_ip_route_get_next_hop_str() instead, which don't keep
+	 * the strings. */
+	NMIPAddr dest;
+	NMIPAddr next_hop;
+	bool has_next_hop:1;
+	char *dest_str;
+	char *next_hop_str;
+
 	GHashTable *attributes;
 };
 
+static void
+_route_set_dest (NMIPRoute *route, gconstpointer dest)
+{
+	route->dest = nm_ip_addr_zero;
+	memcpy (&route->dest, dest, _addr_size (route->family));
+	nm_clear_g_free (&route->dest_str);
+}
+
+static void
+_route_set_next_hop (NMIPRoute *route, gconstpointer next_hop)
+{
+	route->next_hop = nm_ip_addr_zero;
+	if (next_hop)
+		memcpy (&route->next_hop, next_hop, _addr_size (route->family));
+	route->has_next_hop = (memcmp (&route->next_hop, &nm_ip_addr_zero, sizeof (NMIPAddr)) != 0);
+	nm_clear_g_free (&route->next_hop_str);
+}
+
+static const char *
+_route_addr_to_string (const NMIPRoute *route, const NMIPAddr *addr, char **p_str)
+{
+	char string[NM_UTILS_INET_ADDRSTRLEN];
+
+	if (!*p_str)
+		*p_str = g_strdup (inet_ntop (route->family, addr, string, sizeof (string)));
+	return *p_str;
+}
+
 /**
  * nm_ip_route_new:
  * @family: the IP address family (<literal>AF_INET</literal> or
@@ -661,9 +678,12 @@ nm_ip_route_new (int family,
 	route->refcount = 1;
 
 	route->family = family;
-	route->dest = canonicalize_ip (family, dest, FALSE);
+	inet_pton (family, dest, &route->dest);
 	route->prefix = prefix;
-	route->next_hop = canonicalize_ip (family, next_hop, TRUE);
+	if (next_hop) {
+		inet_pton (family, next_hop, &route->next_hop);
+		route->has_next_hop = (memcmp (&route->next_hop, &nm_ip_addr_zero, sizeof (NMIPAddr)) != 0);
+	}
 	route->metric = metric;
 
 	return route;
@@ -706,9 +726,9 @@ nm_ip_route_new_binary (int family,
 	route->refcount = 1;
 
 	route->family = family;
-	route->dest = canonicalize_ip_binary (family, dest, FALSE);
+	_route_set_dest (route, dest);
 	route->prefix = prefix;
-	route->next_hop = canonicalize_ip_binary (family, next_hop, TRUE);
+	_route_set_next_hop (route, next_hop);
 	route->metric = metric;
 
 	return route;
@@ -744,8 +764,8 @@ nm_ip_route_unref (NMIPRoute *route)
 
 	route->refcount--;
 	if (route->refcount == 0) {
-		g_free (route->dest);
-		g_free (route->next_hop);
+		g_free (route->dest_str);
+		g_free (route->next_hop_str);
 		if (route->attributes)
 			g_hash_table_unref (route->attributes);
 		g_slice_free (NMIPRoute, route);
@@ -780,10 +800,12 @@ nm_ip_route_equal_full (NMIPRoute *route, NMIPRoute *other, guint cmp_flags)
 	                                 NM_IP_ROUTE_EQUAL_CMP_FLAGS_NONE,
 	                                 NM_IP_ROUTE_EQUAL_CMP_FLAGS_WITH_ATTRS), FALSE);
 
-	if (   route->prefix != other->prefix
+	if (   route->family != other->family
+	    || route->prefix != other->prefix
 	    || route->metric != other->metric
-	    || strcmp (route->dest, other->dest) != 0
-	    || g_strcmp0 (route->next_hop, other->next_hop) != 0)
+	    || route->has_next_hop != other->has_next_hop
+	    || memcmp (&route->dest, &other->dest, sizeof (NMIPAddr)) != 0
+	    || memcmp (&route->next_hop, &other->next_hop, sizeof (NMIPAddr)) != 0)
 		return FALSE;
 	if (cmp_flags == NM_IP_ROUTE_EQUAL_CMP_FLAGS_WITH_ATTRS) {
 		GHashTableIter iter;
@@ -840,10 +862,11 @@ nm_ip_route_dup (NMIPRoute *route)
 	g_return_val_if_fail (route != NULL, NULL);
 	g_return_val_if_fail (route->refcount > 0, NULL);
 
-	copy = nm_ip_route_new (route->family,
-	                        route->dest, route->prefix,
-	                        route->next_hop, route->metric,
-	                        NULL);
+	copy = nm_ip_route_new_binary (route->family,
+	                               &route->dest, route->prefix,
+	                               route->has_next_hop ? &route->next_hop : NULL,
+	                               route->metric,
+	                               NULL);
 	if (route->attributes) {
 		GHashTableIter iter;
 		const char *key;
@@ -889,7 +912,7 @@ nm_ip_route_get_dest (NMIPRoute *route)
 	g_return_val_if_fail (route != NULL, NULL);
 	g_return_val_if_fail (route->refcount > 0, NULL);
 
-	return route->dest;
+	return _route_addr_to_string (route, &route->dest, &route->dest_str);
 }
 
 /**
@@ -906,11 +929,13 @@ void
 nm_ip_route_set_dest (NMIPRoute *route,
                       const char *dest)
 {
+	NMIPAddr addr;
+
 	g_return_if_fail (route != NULL);
 	g_return_if_fail (nm_utils_ipaddr_valid (route->family, dest));
 
-	g_free (route->dest);
-	route->dest = canonicalize_ip (route->family, dest, FALSE);
+	inet_pton (route->family, dest, &addr);
+	_route_set_dest (route, &addr);
 }
 
 /**
@@ -929,7 +954,7 @@ nm_ip_route_get_dest_binary (NMIPRoute *route,
 	g_return_if_fail (route != NULL);
 	g_return_if_fail (dest != NULL);
 
-	inet_pton (route->family, route->dest, dest);
+	memcpy (dest, &route->dest, _addr_size (route->family));
 }
 
 /**
@@ -945,13 +970,10 @@ void
 nm_ip_route_set_dest_binary (NMIPRoute *route,
                              gconstpointer dest)
 {
-	char string[NM_UTILS_INET_ADDRSTRLEN];
-
 	g_return_if_fail (route != NULL);
 	g_return_if_fail (dest != NULL);
 
-	g_free (route->dest);
-	route->dest = g_strdup (inet_ntop (route->family, dest, string, sizeof (string)));
+	_route_set_dest (route, dest);
 }
 
 /**
@@ -1003,7 +1025,9 @@ nm_ip_route_get_next_hop (NMIPRoute *route)
 	g_return_val_if_fail (route != NULL, NULL);
 	g_return_val_if_fail (route->refcount > 0, NULL);
 
-	return route->next_hop;
+	if (!route->has_next_hop)
+		return NULL;
+	return _route_addr_to_string (route, &route->next_hop, &route->next_hop_str);
 }
 
 /**
@@ -1021,11 +1045,14 @@ void
 nm_ip_route_set_next_hop (NMIPRoute *route,
                           const char *next_hop)
 {
+	NMIPAddr addr;
+
 	g_return_if_fail (route != NULL);
 	g_return_if_fail (!next_hop || nm_utils_ipaddr_valid (route->family, next_hop));
 
-	g_free (route->next_hop);
-	route->next_hop = canonicalize_ip (route->family, next_hop, TRUE);
+	if (next_hop)
+		inet_pton (route->family, next_hop, &addr);
+	_route_set_next_hop (route, next_hop ? &addr : NULL);
 }
 
 /**
@@ -1047,8 +1074,8 @@ nm_ip_route_get_next_hop_binary (NMIPRoute *route,
 	g_return_val_if_fail (route != NULL, FALSE);
 	g_return_val_if_fail (next_hop != NULL, FALSE);
 
-	if (route->next_hop) {
-		inet_pton (route->family, route->next_hop, next_hop);
+	if (route->has_next_hop) {
+		memcpy (next_hop, &route->next_hop, _addr_size (route->family));
 		return TRUE;
 	} else {
 		memset (next_hop, 0, _addr_size (route->family));
@@ -1072,8 +1099,7 @@ nm_ip_route_set_next_hop_binary (NMIPRoute *route,
 {
 	g_return_if_fail (route != NULL);
 
-	g_free (route->next_hop);
-	route->next_hop = canonicalize_ip_binary (route->family, next_hop, TRUE);
+	_route_set_next_hop (route, next_hop);
 }
 
 /**
@@ -1120,6 +1146,55 @@ _nm_ip_route_get_attributes_direct (NMIPRoute *route)
 	return route->attributes;
 }
 
+const NMIPAddr *
+_nm_ip_route_get_dest_direct (const NMIPRoute *route)
+{
+	nm_assert (route);
+
+	return &route->dest;
+}
+
+/* returns the all-zero address if @route has no next hop. */
+const NMIPAddr *
+_nm_ip_route_get_next_hop_direct (const NMIPRoute *route)
+{
+	nm_assert (route);
+
+	return &route->next_hop;
+}
+
+/* formats the destination into @buf of NM_UTILS_INET_ADDRSTRLEN bytes.
+ * Contrary to nm_ip_route_get_dest(), this does not keep the string
+ * in @route. */
+const char *
+_nm_ip_route_get_dest_str (const NMIPRoute *route, char *buf)
+{
+	nm_assert (route);
+
+	return nm_utils_inet_ntop (route->family, &route->dest, buf);
+}
+
+/* like _nm_ip_route_get_dest_str(), returns %NULL if @route has
+ * no next hop. */
+const char *
+_nm_ip_route_get_next_hop_str (const NMIPRoute *route, char *buf)
+{
+	nm_assert (route);
+
+	if (!route->has_next_hop)
+		return NULL;
+	return nm_utils_inet_ntop (route->family, &route->next_hop, buf);
+}
+
+gboolean
+_nm_ip_route_has_attributes (const NMIPRoute *route)
+{
+	nm_assert (route);
+
+	return    route->attributes
+	       && g_hash_table_size (route->attributes) > 0;
+}
+
 /**
  * _nm_ip_route_get_attribute_names:
  * @route: the #NMIPRoute
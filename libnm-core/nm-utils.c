@@ -2146,19 +2146,22 @@ nm_utils_ip_routes_to_variant (GPtrArray *routes)
 			NMIPRoute *route = routes->pdata[i];
 			GVariantBuilder route_builder;
 			gs_free const char **names = NULL;
+			char buf[NM_UTILS_INET_ADDRSTRLEN];
+			const char *next_hop;
 			guint j, len;
 
 			g_variant_builder_init (&route_builder, G_VARIANT_TYPE ("a{sv}"));
 			g_variant_builder_add (&route_builder, "{sv}",
 			                       "dest",
-			                       g_variant_new_string (nm_ip_route_get_dest (route)));
+			                       g_variant_new_string (_nm_ip_route_get_dest_str (route, buf)));
 			g_variant_builder_add (&route_builder, "{sv}",
 			                       "prefix",
 			                       g_variant_new_uint32 (nm_ip_route_get_prefix (route)));
-			if (nm_ip_route_get_next_hop (route)) {
+			next_hop = _nm_ip_route_get_next_hop_str (route, buf);
+			if (next_hop) {
 				g_variant_builder_add (&route_builder, "{sv}",
 				                       "next-hop",
-				                       g_variant_new_string (nm_ip_route_get_next_hop (route)));
+				                       g_variant_new_string (next_hop));
 			}
 			if (nm_ip_route_get_metric (route) != -1) {
 				g_variant_builder_add (&route_builder, "{sv}",
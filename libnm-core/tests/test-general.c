@@ -3176,6 +3176,56 @@ test_setting_compare_routes (void)
 	g_clear_pointer (&result, g_hash_table_unref);
 }
 
+static void
+test_setting_ip_route_addresses (void)
+{
+	NMIPRoute *r, *r2;
+	in_addr_t a4;
+	struct in6_addr a6;
+	char buf[NM_UTILS_INET_ADDRSTRLEN];
+
+	r = nm_ip_route_new (AF_INET, "192.168.12.0", 24, "0.0.0.0", -1, NULL);
+	g_assert (r);
+	g_assert_cmpstr (_nm_ip_route_get_dest_str (r, buf), ==, "192.168.12.0");
+	g_assert_cmpstr (_nm_ip_route_get_next_hop_str (r, buf), ==, NULL);
+	g_assert_cmpstr (nm_ip_route_get_dest (r), ==, "192.168.12.0");
+	g_assert_cmpstr (nm_ip_route_get_next_hop (r), ==, NULL);
+	g_assert (!nm_ip_route_get_next_hop_binary (r, &a4));
+	g_assert_cmpint (a4, ==, 0);
+
+	nm_ip_route_set_next_hop (r, "192.168.11.1");
+	g_assert_cmpstr (nm_ip_route_get_next_hop (r), ==, "192.168.11.1");
+	g_assert (nm_ip_route_get_next_hop_binary (r, &a4));
+	g_assert_cmpint (a4, ==, nmtst_inet4_from_string ("192.168.11.1"));
+
+	a4 = nmtst_inet4_from_string ("10.0.0.0");
+	nm_ip_route_set_dest_binary (r, &a4);
+	g_assert_cmpstr (nm_ip_route_get_dest (r), ==, "10.0.0.0");
+
+	r2 = nm_ip_route_new (AF_INET, "10.0.0.0", 24, "192.168.11.1", -1, NULL);
+	g_assert (nm_ip_route_equal (r, r2));
+	nm_ip_route_set_next_hop_binary (r2, NULL);
+	g_assert (!nm_ip_route_equal (r, r2));
+	nm_ip_route_unref (r2);
+
+	r2 = nm_ip_route_dup (r);
+	g_assert (nm_ip_route_equal (r, r2));
+	nm_ip_route_unref (r2);
+	nm_ip_route_unref (r);
+
+	r = nm_ip_route_new (AF_INET6, "2001:0db8::0", 64, "fe80::1", 100, NULL);
+	g_assert (r);
+	g_assert_cmpstr (nm_ip_route_get_dest (r), ==, "2001:db8::");
+	g_assert_cmpstr (nm_ip_route_get_next_hop (r), ==, "fe80::1");
+	g_assert_cmpstr (_nm_ip_route_get_dest_str (r, buf), ==, "2001:db8::");
+	g_assert_cmpstr (_nm_ip_route_get_next_hop_str (r, buf), ==, "fe80::1");
+	nm_ip_route_get_dest_binary (r, &a6);
+	g_assert (IN6_ARE_ADDR_EQUAL (&a6, nmtst_inet6_from_string ("2001:db8::")));
+	nm_ip_route_set_dest (r, "2001:db8:1::");
+	g_assert_cmpstr (nm_ip_route_get_dest (r), ==, "2001:db8:1::");
+	nm_ip_route_unref (r);
+}
+
 static void
 test_setting_compare_wired_cloned_mac_address (void)
 {
@@ -7788,6 +7838,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/core/general/test_setting_compare_id", test_setting_compare_id);
 	g_test_add_func ("/core/general/test_setting_compare_addresses", test_setting_compare_addresses);
 	g_test_add_func ("/core/general/test_setting_compare_routes", test_setting_compare_routes);
+	g_test_add_func ("/core/general/test_setting_ip_route_addresses", test_setting_ip_route_addresses);
 	g_test_add_func ("/core/general/test_setting_compare_wired_cloned_mac_address", test_setting_compare_wired_cloned_mac_address);
 	g_test_add_func ("/core/general/test_setting_compare_wirless_cloned_mac_address", test_setting_compare_wireless_cloned_mac_address);
 	g_test_add_func ("/core/general/test_setting_compare_timestamp", test_setting_compare_timestamp);
@@ -35,6 +35,7 @@
 #include "nm-active-connection.h"
 #include "nm-vpn-connection.h"
 #include "nm-remote-connection.h"
+#include "nm-remote-connection-private.h"
 #include "nm-dbus-helpers.h"
 #include "nm-wimax-nsp.h"
 #include "nm-object-private.h"
@@ -106,6 +107,7 @@ typedef struct {
 	NMClient *client;
 	GCancellable *cancellable;
 	GSimpleAsyncResult *result;
+	GDBusObjectManager *prefetch_object_manager;
 	int pending_init;
 } NMClientInitData;
 
@@ -116,7 +118,10 @@ typedef struct {
 	GDBusObjectManager *object_manager;
 	GCancellable *new_object_manager_cancellable;
 	struct udev *udev;
+	char **object_filter;
+	guint lazy_reload_id;
 	bool udev_inited:1;
+	bool init_sync_running:1;
 } NMClientPrivate;
 
 enum {
@@ -148,6 +153,7 @@ enum {
 	PROP_DNS_RC_MANAGER,
 	PROP_DNS_CONFIGURATION,
 	PROP_CHECKPOINTS,
+	PROP_OBJECT_FILTER,
 
 	LAST_PROP
 };
@@ -2795,6 +2801,115 @@ object_removed (GDBusObjectManager *object_manager, GDBusObject *object, gpointe
 	g_object_set_qdata (G_OBJECT (object), _nm_object_obj_nm_quark (), NULL);
 }
 
+static gboolean
+_object_filter_matches (NMClient *self, GDBusObject *object)
+{
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (self);
+	const char *path;
+	char **iter;
+
+	if (!priv->object_filter)
+		return TRUE;
+
+	/* The root objects are always needed. */
+	path = g_dbus_object_get_object_path (object);
+	if (NM_IN_STRSET (path, NM_DBUS_PATH,
+	                        NM_DBUS_PATH_SETTINGS,
+	                        NM_DBUS_PATH_DNS_MANAGER))
+		return TRUE;
+
+	for (iter = priv->object_filter; *iter; iter++) {
+		gs_unref_object GDBusInterface *interface = NULL;
+
+		if ((*iter)[0] == '/') {
+			if (nm_streq (*iter, path))
+				return TRUE;
+			continue;
+		}
+
+		interface = g_dbus_object_get_interface (object, *iter);
+		if (interface)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+static GPtrArray *
+_get_obj_nms (GDBusObjectManager *object_manager)
+{
+	GPtrArray *obj_nms;
+	GList *objects, *iter;
+
+	/* Take a snapshot first. Initializing one object may create others
+	 * lazily, and those get initialized right away. */
+	obj_nms = g_ptr_array_new_with_free_func (g_object_unref);
+	objects = g_dbus_object_manager_get_objects (object_manager);
+	for (iter = objects; iter; iter = iter->next) {
+		NMObject *obj_nm;
+
+		obj_nm = g_object_get_qdata (iter->data, _nm_object_obj_nm_quark ());
+		if (obj_nm)
+			g_ptr_array_add (obj_nms, g_object_ref (obj_nm));
+	}
+	g_list_free_full (objects, g_object_unref);
+	return obj_nms;
+}
+
+static gboolean
+lazy_reload_cb (gpointer user_data)
+{
+	NMClient *self = user_data;
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (self);
+
+	priv->lazy_reload_id = 0;
+
+	/* Let the root objects pick up the objects that were created since. */
+	if (priv->manager)
+		_nm_object_reload_cached_properties (NM_OBJECT (priv->manager));
+	if (priv->settings)
+		_nm_object_reload_cached_properties (NM_OBJECT (priv->settings));
+
+	return G_SOURCE_REMOVE;
+}
+
+static NMObject *
+lazy_create_cb (NMObject *referrer, GDBusObject *object, gpointer user_data)
+{
+	NMClient *self = user_data;
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (self);
+	NMObject *obj_nm;
+
+	/* The root objects only refer to objects that already exist, otherwise
+	 * they would pull in everything right away. */
+	if (   NM_IS_MANAGER (referrer)
+	    || NM_IS_REMOTE_SETTINGS (referrer)
+	    || NM_IS_DNS_MANAGER (referrer))
+		return NULL;
+
+	obj_nm = obj_nm_for_gdbus_object (self, object, priv->object_manager);
+	if (!obj_nm)
+		return NULL;
+
+	/* Initializing an NMObject only evaluates the cached properties, except
+	 * for remote connections that fetch their settings. Don't block on that
+	 * outside of the synchronous initialization of the client. */
+	if (   priv->init_sync_running
+	    || !NM_IS_REMOTE_CONNECTION (obj_nm)) {
+		if (!g_initable_init (G_INITABLE (obj_nm), NULL, NULL))
+			g_warn_if_reached ();
+	} else {
+		g_async_initable_init_async (G_ASYNC_INITABLE (obj_nm),
+		                             G_PRIORITY_DEFAULT, NULL,
+		                             obj_nm_inited, NULL);
+	}
+
+	if (!priv->lazy_reload_id)
+		priv->lazy_reload_id = g_idle_add (lazy_reload_cb, self);
+
+	return obj_nm;
+}
+
 static gboolean
 objects_created (NMClient *client, GDBusObjectManager *object_manager, GError **error)
 {
@@ -2805,12 +2920,19 @@ objects_created (NMClient *client, GDBusObjectManager *object_manager, GError **
 	NMObject *obj_nm;
 	GList *objects, *iter;
 
-	/* First just ensure all the NMObjects for known GDBusObjects exist. */
+	/* First just ensure all the NMObjects for known GDBusObjects exist. With
+	 * an object filter, the others get created on demand once an object
+	 * refers to them. */
 	objects = g_dbus_object_manager_get_objects (object_manager);
-	for (iter = objects; iter; iter = iter->next)
-		obj_nm_for_gdbus_object (client, iter->data, object_manager);
+	for (iter = objects; iter; iter = iter->next) {
+		if (_object_filter_matches (client, iter->data))
+			obj_nm_for_gdbus_object (client, iter->data, object_manager);
+	}
 	g_list_free_full (objects, g_object_unref);
 
+	if (priv->object_filter)
+		_nm_object_set_lazy_create_func (object_manager, lazy_create_cb, client);
+
 	manager = g_dbus_object_manager_get_object (object_manager, NM_DBUS_PATH);
 	if (!manager) {
 		g_set_error_literal (error,
@@ -2901,6 +3023,112 @@ objects_created (NMClient *client, GDBusObjectManager *object_manager, GError **
 	return TRUE;
 }
 
+/* Fetching the settings of all connections with one GetConnectionsSettings()
+ * call is much cheaper than one GetSettings() call per connection during
+ * initialization. Daemons that don't support the call yet fail it, in which
+ * case the connections fall back to fetching their settings individually. */
+
+static GDBusProxy *
+_prefetch_get_settings_proxy (GDBusObjectManager *object_manager)
+{
+	return (GDBusProxy *) g_dbus_object_manager_get_interface (object_manager,
+	                                                           NM_DBUS_PATH_SETTINGS,
+	                                                           NM_DBUS_INTERFACE_SETTINGS);
+}
+
+static GVariant *
+_prefetch_get_args (NMClient *self, GDBusObjectManager *object_manager)
+{
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (self);
+	GVariantBuilder builder;
+	GList *objects, *iter;
+	gboolean any = FALSE;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("ao"));
+
+	/* Without an object filter all connections are wanted, which is
+	 * what an empty list requests. */
+	if (priv->object_filter) {
+		objects = g_dbus_object_manager_get_objects (object_manager);
+		for (iter = objects; iter; iter = iter->next) {
+			if (!NM_IS_REMOTE_CONNECTION (g_object_get_qdata (iter->data, _nm_object_obj_nm_quark ())))
+				continue;
+			g_variant_builder_add (&builder, "o", g_dbus_object_get_object_path (iter->data));
+			any = TRUE;
+		}
+		g_list_free_full (objects, g_object_unref);
+
+		if (!any) {
+			g_variant_builder_clear (&builder);
+			return NULL;
+		}
+	}
+
+	return g_variant_new ("(ao)", &builder);
+}
+
+static void
+_prefetch_apply (GDBusObjectManager *object_manager, GVariant *ret)
+{
+	gs_unref_variant GVariant *v_settings = NULL;
+	GList *objects, *iter;
+	GVariantIter viter;
+	const char *path;
+	GVariant *settings;
+
+	g_variant_get (ret, "(@a{oa{sa{sv}}})", &v_settings);
+
+	/* Connections that are missing from the reply are not visible to us. */
+	objects = g_dbus_object_manager_get_objects (object_manager);
+	for (iter = objects; iter; iter = iter->next) {
+		NMObject *obj_nm;
+
+		obj_nm = g_object_get_qdata (iter->data, _nm_object_obj_nm_quark ());
+		if (NM_IS_REMOTE_CONNECTION (obj_nm))
+			_nm_remote_connection_set_prefetched_settings (NM_REMOTE_CONNECTION (obj_nm), NULL);
+	}
+	g_list_free_full (objects, g_object_unref);
+
+	g_variant_iter_init (&viter, v_settings);
+	while (g_variant_iter_next (&viter, "{&o@a{sa{sv}}}", &path, &settings)) {
+		gs_unref_object GDBusObject *object = NULL;
+		NMObject *obj_nm;
+
+		object = g_dbus_object_manager_get_object (object_manager, path);
+		obj_nm = object ? g_object_get_qdata (G_OBJECT (object), _nm_object_obj_nm_quark ()) : NULL;
+		if (NM_IS_REMOTE_CONNECTION (obj_nm))
+			_nm_remote_connection_set_prefetched_settings (NM_REMOTE_CONNECTION (obj_nm), settings);
+		g_variant_unref (settings);
+	}
+}
+
+static void
+_prefetch_sync (NMClient *self, GDBusObjectManager *object_manager, GCancellable *cancellable)
+{
+	gs_unref_object GDBusProxy *proxy = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	GVariant *args;
+
+	proxy = _prefetch_get_settings_proxy (object_manager);
+	if (!proxy)
+		return;
+
+	args = _prefetch_get_args (self, object_manager);
+	if (!args)
+		return;
+
+	ret = g_dbus_proxy_call_sync (proxy,
+	                              "GetConnectionsSettings",
+	                              args,
+	                              G_DBUS_CALL_FLAGS_NONE,
+	                              -1,
+	                              cancellable,
+	                              NULL);
+	if (   ret
+	    && g_variant_is_of_type (ret, G_VARIANT_TYPE ("(a{oa{sa{sv}}})")))
+		_prefetch_apply (object_manager, ret);
+}
+
 /* Synchronous initialization. */
 
 static void name_owner_changed (GObject *object, GParamSpec *pspec, gpointer user_data);
@@ -2921,7 +3149,8 @@ init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 {
 	NMClient *client = NM_CLIENT (initable);
 	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (client);
-	GList *objects, *iter;
+	gs_unref_ptrarray GPtrArray *obj_nms = NULL;
+	guint i;
 
 	priv->object_manager = g_dbus_object_manager_client_new_for_bus_sync (_nm_dbus_bus_type (),
 	                                                                      G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_DO_NOT_AUTO_START,
@@ -2937,21 +3166,18 @@ init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 		if (!objects_created (client, priv->object_manager, error))
 			return FALSE;
 
-		objects = g_dbus_object_manager_get_objects (priv->object_manager);
-		for (iter = objects; iter; iter = iter->next) {
-			NMObject *obj_nm;
-
-			obj_nm = g_object_get_qdata (iter->data, _nm_object_obj_nm_quark ());
-			if (!obj_nm)
-				continue;
+		_prefetch_sync (client, priv->object_manager, cancellable);
 
-			if (!g_initable_init (G_INITABLE (obj_nm), cancellable, NULL)) {
+		obj_nms = _get_obj_nms (priv->object_manager);
+		priv->init_sync_running = TRUE;
+		for (i = 0; i < obj_nms->len; i++) {
+			if (!g_initable_init (G_INITABLE (obj_nms->pdata[i]), cancellable, NULL)) {
 				/* This is a can-not-happen situation, the NMObject subclasses are not
 				 * supposed to fail initialization. */
 				g_warn_if_reached ();
 			}
 		}
-		g_list_free_full (objects, g_object_unref);
+		priv->init_sync_running = FALSE;
 	}
 
 	g_signal_connect (priv->object_manager, "notify::name-owner",
@@ -2970,6 +3196,7 @@ init_async_complete (NMClientInitData *init_data)
 	g_simple_async_result_complete (init_data->result);
 	g_object_unref (init_data->result);
 	g_clear_object (&init_data->cancellable);
+	g_clear_object (&init_data->prefetch_object_manager);
 	g_slice_free (NMClientInitData, init_data);
 }
 
@@ -3036,6 +3263,9 @@ unhook_om (NMClient *self)
 		g_clear_object (&priv->dns_manager);
 	}
 
+	nm_clear_g_source (&priv->lazy_reload_id);
+	_nm_object_set_lazy_create_func (priv->object_manager, NULL, NULL);
+
 	objects = g_dbus_object_manager_get_objects (priv->object_manager);
 	for (iter = objects; iter; iter = iter->next)
 		g_object_set_qdata (iter->data, _nm_object_obj_nm_quark (), NULL);
@@ -3052,13 +3282,53 @@ new_object_manager (GObject *source_object, GAsyncResult *res, gpointer user_dat
 	g_object_notify (G_OBJECT (user_data), NM_CLIENT_NM_RUNNING);
 }
 
+static void
+init_objects_async (NMClientInitData *init_data, GDBusObjectManager *object_manager)
+{
+	gs_unref_ptrarray GPtrArray *obj_nms = NULL;
+	guint i;
+
+	obj_nms = _get_obj_nms (object_manager);
+	for (i = 0; i < obj_nms->len; i++) {
+		init_data->pending_init++;
+		g_async_initable_init_async (G_ASYNC_INITABLE (obj_nms->pdata[i]),
+		                             G_PRIORITY_DEFAULT, init_data->cancellable,
+		                             async_inited_obj_nm, init_data);
+	}
+}
+
+static void
+prefetch_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+	NMClientInitData *init_data = user_data;
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (init_data->client);
+	gs_unref_variant GVariant *ret = NULL;
+
+	nm_assert (init_data->pending_init > 0);
+
+	ret = g_dbus_proxy_call_finish (G_DBUS_PROXY (source), result, NULL);
+
+	/* If the name owner changed in the meantime, the objects of the
+	 * previous object manager are already gone. */
+	if (init_data->prefetch_object_manager == priv->object_manager) {
+		if (   ret
+		    && g_variant_is_of_type (ret, G_VARIANT_TYPE ("(a{oa{sa{sv}}})")))
+			_prefetch_apply (priv->object_manager, ret);
+		init_objects_async (init_data, priv->object_manager);
+	}
+
+	init_data->pending_init--;
+	init_async_complete (init_data);
+}
+
 static void
 got_object_manager (GObject *object, GAsyncResult *result, gpointer user_data)
 {
 	NMClientInitData *init_data = user_data;
 	NMClient *client;
 	NMClientPrivate *priv;
-	GList *objects, *iter;
+	gs_unref_object GDBusProxy *proxy = NULL;
+	GVariant *args;
 	GError *error = NULL;
 	GDBusObjectManager *object_manager;
 
@@ -3080,20 +3350,21 @@ got_object_manager (GObject *object, GAsyncResult *result, gpointer user_data)
 			return;
 		}
 
-		objects = g_dbus_object_manager_get_objects (priv->object_manager);
-		for (iter = objects; iter; iter = iter->next) {
-			NMObject *obj_nm;
-
-			obj_nm = g_object_get_qdata (iter->data, _nm_object_obj_nm_quark ());
-			if (!obj_nm)
-				continue;
-
+		proxy = _prefetch_get_settings_proxy (priv->object_manager);
+		args = proxy ? _prefetch_get_args (client, priv->object_manager) : NULL;
+		if (args) {
 			init_data->pending_init++;
-			g_async_initable_init_async (G_ASYNC_INITABLE (obj_nm),
-			                             G_PRIORITY_DEFAULT, init_data->cancellable,
-			                             async_inited_obj_nm, init_data);
-		}
-		g_list_free_full (objects, g_object_unref);
+			init_data->prefetch_object_manager = g_object_ref (priv->object_manager);
+			g_dbus_proxy_call (proxy,
+			                   "GetConnectionsSettings",
+			                   args,
+			                   G_DBUS_CALL_FLAGS_NONE,
+			                   -1,
+			                   init_data->cancellable,
+			                   prefetch_cb,
+			                   init_data);
+		} else
+			init_objects_async (init_data, priv->object_manager);
 	}
 
 	init_async_complete (init_data);
@@ -3176,6 +3447,7 @@ dispose (GObject *object)
 	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (object);
 
 	nm_clear_g_cancellable (&priv->new_object_manager_cancellable);
+	nm_clear_g_source (&priv->lazy_reload_id);
 
 	if (priv->manager) {
 		g_signal_handlers_disconnect_by_data (priv->manager, object);
@@ -3196,6 +3468,7 @@ dispose (GObject *object)
 		GList *objects, *iter;
 
 		/* Unhook the NM objects. */
+		_nm_object_set_lazy_create_func (priv->object_manager, NULL, NULL);
 		objects = g_dbus_object_manager_get_objects (priv->object_manager);
 		for (iter = objects; iter; iter = iter->next)
 			g_object_set_qdata (G_OBJECT (iter->data), _nm_object_obj_nm_quark (), NULL);
@@ -3213,6 +3486,16 @@ dispose (GObject *object)
 	}
 }
 
+static void
+finalize (GObject *object)
+{
+	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (object);
+
+	g_strfreev (priv->object_filter);
+
+	G_OBJECT_CLASS (nm_client_parent_class)->finalize (object);
+}
+
 static void
 set_property (GObject *object, guint prop_id,
               const GValue *value, GParamSpec *pspec)
@@ -3228,6 +3511,10 @@ set_property (GObject *object, guint prop_id,
 		if (priv->manager)
 			g_object_set_property (G_OBJECT (priv->manager), pspec->name, value);
 		break;
+	case PROP_OBJECT_FILTER:
+		/* construct-only */
+		priv->object_filter = g_value_dup_boxed (value);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -3245,6 +3532,9 @@ get_property (GObject *object, guint prop_id,
 	case PROP_NM_RUNNING:
 		g_value_set_boolean (value, nm_client_get_nm_running (self));
 		break;
+	case PROP_OBJECT_FILTER:
+		g_value_set_boxed (value, priv->object_filter);
+		break;
 
 	/* Manager properties. */
 	case PROP_VERSION:
@@ -3378,6 +3668,7 @@ nm_client_class_init (NMClientClass *client_class)
 	object_class->set_property = set_property;
 	object_class->get_property = get_property;
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
 
 	/* properties */
 
@@ -3734,6 +4025,32 @@ nm_client_class_init (NMClientClass *client_class)
 		                     G_PARAM_READABLE |
 		                     G_PARAM_STATIC_STRINGS));
 
+	/**
+	 * NMClient:object-filter:
+	 *
+	 * Restricts which D-Bus objects are instantiated when the client
+	 * initializes. Each entry is either a D-Bus object path or the name
+	 * of a D-Bus interface that the object must implement. The manager,
+	 * settings and DNS manager objects are always instantiated.
+	 *
+	 * Other objects that exist at initialization are only created once an
+	 * instantiated object refers to them, for example the IP configuration
+	 * or active connection of a selected device. The lists of the client,
+	 * like #NMClient:devices, only contain objects that were instantiated.
+	 * Objects that appear later are instantiated as usual.
+	 *
+	 * If %NULL (the default), all objects are instantiated.
+	 *
+	 * Since: 1.18
+	 **/
+	g_object_class_install_property
+		(object_class, PROP_OBJECT_FILTER,
+		 g_param_spec_boxed (NM_CLIENT_OBJECT_FILTER, "", "",
+		                     G_TYPE_STRV,
+		                     G_PARAM_READWRITE |
+		                     G_PARAM_CONSTRUCT_ONLY |
+		                     G_PARAM_STATIC_STRINGS));
+
 	/* signals */
 
 	/**
@@ -63,6 +63,7 @@ G_BEGIN_DECLS
 #define NM_CLIENT_DNS_MODE "dns-mode"
 #define NM_CLIENT_DNS_RC_MANAGER "dns-rc-manager"
 #define NM_CLIENT_DNS_CONFIGURATION "dns-configuration"
+#define NM_CLIENT_OBJECT_FILTER "object-filter"
 
 #define NM_CLIENT_DEVICE_ADDED "device-added"
 #define NM_CLIENT_DEVICE_REMOVED "device-removed"
@@ -49,6 +49,16 @@ GDBusObjectManager *_nm_object_get_dbus_object_manager (NMObject *object);
 
 GQuark _nm_object_obj_nm_quark (void);
 
+typedef NMObject *(*NMObjectLazyCreateFunc) (NMObject *referrer,
+                                             GDBusObject *object,
+                                             gpointer user_data);
+
+void _nm_object_set_lazy_create_func (GDBusObjectManager *object_manager,
+                                      NMObjectLazyCreateFunc func,
+                                      gpointer user_data);
+
+void _nm_object_reload_cached_properties (NMObject *object);
+
 /* DBus property accessors */
 
 void _nm_object_set_property (NMObject *object,
@@ -39,6 +39,19 @@ static gboolean debug = FALSE;
 
 NM_CACHED_QUARK_FCN ("nm-obj-nm", _nm_object_obj_nm_quark)
 
+static NM_CACHED_QUARK_FCN ("nm-obj-lazy-create", _lazy_create_quark)
+
+typedef struct {
+	NMObjectLazyCreateFunc func;
+	gpointer user_data;
+} LazyCreateData;
+
+static void
+_lazy_create_data_free (gpointer data)
+{
+	g_slice_free (LazyCreateData, data);
+}
+
 static void nm_object_initable_iface_init (GInitableIface *iface);
 static void nm_object_async_initable_iface_init (GAsyncInitableIface *iface);
 
@@ -575,6 +588,61 @@ object_created (GObject *obj, const char *path, gpointer user_data)
 	object_property_maybe_complete (odata->self);
 }
 
+/**
+ * _nm_object_set_lazy_create_func:
+ * @object_manager: the #GDBusObjectManager
+ * @func: (allow-none): the function to create missing objects, or %NULL
+ * @user_data: user data for @func
+ *
+ * By default, every #GDBusObject of @object_manager has a #NMObject
+ * attached. Setting a lazy-create function indicates that some of them are
+ * left out on purpose. When a property refers to such an object, @func is
+ * asked to create it on demand; if it returns %NULL, the reference is
+ * silently dropped.
+ */
+void
+_nm_object_set_lazy_create_func (GDBusObjectManager *object_manager,
+                                 NMObjectLazyCreateFunc func,
+                                 gpointer user_data)
+{
+	LazyCreateData *lazy = NULL;
+
+	if (func) {
+		lazy = g_slice_new (LazyCreateData);
+		lazy->func = func;
+		lazy->user_data = user_data;
+	}
+	g_object_set_qdata_full (G_OBJECT (object_manager),
+	                         _lazy_create_quark (),
+	                         lazy,
+	                         lazy ? _lazy_create_data_free : NULL);
+}
+
+static gboolean
+_object_is_filtered (NMObjectPrivate *priv, GDBusObject *object)
+{
+	return    !g_object_get_qdata (G_OBJECT (object), _nm_object_obj_nm_quark ())
+	       && g_object_get_qdata (G_OBJECT (priv->object_manager), _lazy_create_quark ());
+}
+
+static GObject *
+_object_for_gdbus_object (NMObject *self, GDBusObject *object)
+{
+	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (self);
+	const LazyCreateData *lazy;
+	GObject *obj;
+
+	obj = g_object_get_qdata (G_OBJECT (object), _nm_object_obj_nm_quark ());
+	if (obj)
+		return obj;
+
+	lazy = g_object_get_qdata (G_OBJECT (priv->object_manager), _lazy_create_quark ());
+	if (!lazy)
+		return NULL;
+
+	return (GObject *) lazy->func (self, object, lazy->user_data);
+}
+
 static gboolean
 handle_object_property (NMObject *self, const char *property_name, GVariant *value,
                         PropertyInfo *pi)
@@ -624,7 +692,12 @@ handle_object_property (NMObject *self, const char *property_name, GVariant *val
 		return FALSE;
 	}
 
-	obj = g_object_get_qdata (G_OBJECT (object), _nm_object_obj_nm_quark ());
+	obj = _object_for_gdbus_object (self, object);
+	if (!obj && _object_is_filtered (priv, object)) {
+		/* Not instantiated on purpose. The property reads as unset. */
+		object_created (NULL, "/", odata);
+		return TRUE;
+	}
 	object_created (obj, path, odata);
 
 	return TRUE;
@@ -665,11 +738,12 @@ handle_object_array_property (NMObject *self, const char *property_name, GVarian
 		gs_unref_object GDBusObject *object = NULL;
 
 		object = g_dbus_object_manager_get_object (priv->object_manager, path);
-		if (object) {
-			obj = g_object_get_qdata (G_OBJECT (object), _nm_object_obj_nm_quark ());
+		obj = object ? _object_for_gdbus_object (self, object) : NULL;
+		if (obj || (object && !_object_is_filtered (priv, object)))
 			object_created (obj, path, odata);
-		} else {
-			g_warning ("no object known for %s\n", path);
+		else {
+			if (!object)
+				g_warning ("no object known for %s\n", path);
 			odata->remaining--;
 			odata->length--;
 			object_property_maybe_complete (self);
@@ -773,6 +847,30 @@ properties_changed (GDBusProxy *proxy,
 	}
 }
 
+static void init_if (GDBusProxy *proxy, NMObject *self);
+
+/**
+ * _nm_object_reload_cached_properties:
+ * @object: the #NMObject
+ *
+ * Re-evaluates all properties from the D-Bus proxies' cache. This is useful
+ * after objects were created lazily, so that object and object-array
+ * properties that previously left them out pick them up.
+ */
+void
+_nm_object_reload_cached_properties (NMObject *object)
+{
+	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
+	GList *interfaces;
+
+	if (!priv->inited)
+		return;
+
+	interfaces = g_dbus_object_get_interfaces (priv->object);
+	g_list_foreach (interfaces, (GFunc) init_if, object);
+	g_list_free_full (interfaces, g_object_unref);
+}
+
 #define HANDLE_TYPE(vtype, ctype, getter) \
 	G_STMT_START { \
 		if (g_variant_is_of_type (value, vtype)) { \
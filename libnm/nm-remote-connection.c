@@ -71,6 +71,9 @@ typedef struct {
 	char *filename;
 
 	gboolean visible;
+
+	GVariant *prefetched_settings;
+	bool prefetched:1;
 } NMRemoteConnectionPrivate;
 
 #define NM_REMOTE_CONNECTION_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), NM_TYPE_REMOTE_CONNECTION, NMRemoteConnectionPrivate))
@@ -731,6 +734,49 @@ replace_settings (NMRemoteConnection *self, GVariant *new_settings)
 		g_clear_error (&error);
 }
 
+/**
+ * _nm_remote_connection_set_prefetched_settings:
+ * @self: the #NMRemoteConnection
+ * @settings: (allow-none): the connection's settings, or %NULL if they
+ *   could not be fetched because the connection is not visible.
+ *
+ * Hands over settings that were already fetched in bulk, so that
+ * initializing the object does not need a separate GetSettings()
+ * call. Must be called before the object gets initialized.
+ */
+void
+_nm_remote_connection_set_prefetched_settings (NMRemoteConnection *self,
+                                               GVariant *settings)
+{
+	NMRemoteConnectionPrivate *priv;
+
+	g_return_if_fail (NM_IS_REMOTE_CONNECTION (self));
+
+	priv = NM_REMOTE_CONNECTION_GET_PRIVATE (self);
+
+	nm_clear_pointer (&priv->prefetched_settings, g_variant_unref);
+	if (settings)
+		priv->prefetched_settings = g_variant_ref (settings);
+	priv->prefetched = TRUE;
+}
+
+static gboolean
+init_from_prefetched_settings (NMRemoteConnection *self)
+{
+	NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE (self);
+
+	if (!priv->prefetched)
+		return FALSE;
+
+	priv->prefetched = FALSE;
+	if (priv->prefetched_settings) {
+		priv->visible = TRUE;
+		replace_settings (self, priv->prefetched_settings);
+		nm_clear_pointer (&priv->prefetched_settings, g_variant_unref);
+	}
+	return TRUE;
+}
+
 static void
 updated_get_settings_cb (GObject *proxy,
                          GAsyncResult *result,
@@ -805,10 +851,11 @@ init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 	priv->proxy = NMDBUS_SETTINGS_CONNECTION (_nm_object_get_proxy (NM_OBJECT (initable), NM_DBUS_INTERFACE_SETTINGS_CONNECTION));
 	g_signal_connect_object (priv->proxy, "updated", G_CALLBACK (updated_cb), initable, 0);
 
-	if (nmdbus_settings_connection_call_get_settings_sync (priv->proxy,
-	                                                       &settings,
-	                                                       cancellable,
-	                                                       NULL)) {
+	if (   !init_from_prefetched_settings (self)
+	    && nmdbus_settings_connection_call_get_settings_sync (priv->proxy,
+	                                                          &settings,
+	                                                          cancellable,
+	                                                          NULL)) {
 		priv->visible = TRUE;
 		replace_settings (self, settings);
 		g_variant_unref (settings);
@@ -897,6 +944,12 @@ init_async (GAsyncInitable *initable, int io_priority,
 	g_signal_connect_object (priv->proxy, "updated",
 	                         G_CALLBACK (updated_cb), initable, 0);
 
+	if (init_from_prefetched_settings (NM_REMOTE_CONNECTION (initable))) {
+		nm_remote_connection_parent_async_initable_iface->
+			init_async (initable, io_priority, init_data->cancellable, init_async_parent_inited, init_data);
+		return;
+	}
+
 	nmdbus_settings_connection_call_get_settings (NM_REMOTE_CONNECTION_GET_PRIVATE (init_data->initable)->proxy,
 	                                              init_data->cancellable,
 	                                              init_get_settings_cb, init_data);
@@ -946,6 +999,7 @@ dispose (GObject *object)
 
 	g_clear_object (&priv->proxy);
 	nm_clear_g_free (&priv->filename);
+	nm_clear_pointer (&priv->prefetched_settings, g_variant_unref);
 
 	G_OBJECT_CLASS (nm_remote_connection_parent_class)->dispose (object);
 }
@@ -1594,6 +1594,126 @@ test_connection_invalid (void)
 
 /*****************************************************************************/
 
+#define N_MANY_CONNECTIONS 200
+
+static void
+_test_connections_many_check (NMClient *client, char **paths, guint n_visible)
+{
+	const GPtrArray *connections;
+	guint i;
+
+	connections = nm_client_get_connections (client);
+	g_assert (connections);
+	g_assert_cmpint (connections->len, ==, n_visible);
+
+	for (i = 0; i < connections->len; i++) {
+		NMRemoteConnection *remote = connections->pdata[i];
+
+		g_assert (NM_IS_REMOTE_CONNECTION (remote));
+		g_assert (nm_remote_connection_get_visible (remote));
+		g_assert (nm_connection_get_uuid (NM_CONNECTION (remote)));
+		g_assert (g_str_has_prefix (nm_connection_get_id (NM_CONNECTION (remote)), "test-connections-many-"));
+	}
+
+	g_assert (!nm_client_get_connection_by_path (client, paths[0]));
+	g_assert (nm_client_get_connection_by_path (client, paths[1]));
+}
+
+static void
+test_connections_many (void)
+{
+	NMTSTC_SERVICE_INFO_SETUP (my_sinfo)
+	gs_unref_object NMClient *client = NULL;
+	gs_free_error GError *error = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	char *paths[N_MANY_CONNECTIONS] = { };
+	gint64 ts;
+	guint i;
+
+	for (i = 0; i < N_MANY_CONNECTIONS; i++) {
+		gs_unref_object NMConnection *connection = NULL;
+		gs_free char *id = g_strdup_printf ("test-connections-many-%u", i);
+
+		connection = nmtst_create_minimal_connection (id, NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+		nmtst_connection_normalize (connection);
+		nmtstc_service_add_connection (my_sinfo, connection, TRUE, &paths[i]);
+	}
+
+	/* The first connection is not visible to us and must be filtered out
+	 * from the bulk reply, just like GetSettings() fails for it. */
+	ret = g_dbus_connection_call_sync (my_sinfo->bus,
+	                                   NM_DBUS_SERVICE,
+	                                   paths[0],
+	                                   NM_DBUS_INTERFACE_SETTINGS_CONNECTION,
+	                                   "SetVisible",
+	                                   g_variant_new ("(b)", FALSE),
+	                                   NULL,
+	                                   G_DBUS_CALL_FLAGS_NONE,
+	                                   -1,
+	                                   NULL,
+	                                   &error);
+	g_assert_no_error (error);
+
+	ts = g_get_monotonic_time ();
+	client = nm_client_new (NULL, &error);
+	g_assert_no_error (error);
+	g_test_message ("nm_client_new() with %u connections took %.3f msec",
+	                (guint) N_MANY_CONNECTIONS,
+	                (g_get_monotonic_time () - ts) / 1000.0);
+	_test_connections_many_check (client, paths, N_MANY_CONNECTIONS - 1);
+	g_clear_object (&client);
+
+	ts = g_get_monotonic_time ();
+	nm_client_new_async (NULL, new_client_cb, &client);
+	g_main_loop_run (loop);
+	g_test_message ("nm_client_new_async() with %u connections took %.3f msec",
+	                (guint) N_MANY_CONNECTIONS,
+	                (g_get_monotonic_time () - ts) / 1000.0);
+	_test_connections_many_check (client, paths, N_MANY_CONNECTIONS - 1);
+
+	for (i = 0; i < N_MANY_CONNECTIONS; i++)
+		g_free (paths[i]);
+}
+
+/*****************************************************************************/
+
+static void
+test_object_filter (void)
+{
+	NMTSTC_SERVICE_INFO_SETUP (my_sinfo)
+	gs_unref_object NMClient *client = NULL;
+	gs_unref_object NMClient *filtered = NULL;
+	gs_free_error GError *error = NULL;
+	const char *filter[] = { NULL, NULL };
+	const GPtrArray *devices;
+	NMDevice *device;
+
+	client = nm_client_new (NULL, &error);
+	g_assert_no_error (error);
+
+	nmtstc_service_add_wired_device (my_sinfo, client, "eth0", "52:54:00:12:34:56", NULL);
+	device = nmtstc_service_add_wired_device (my_sinfo, client, "eth1", "52:54:00:12:34:57", NULL);
+	filter[0] = nm_object_get_path (NM_OBJECT (device));
+
+	filtered = g_initable_new (NM_TYPE_CLIENT, NULL, &error,
+	                           NM_CLIENT_OBJECT_FILTER, filter,
+	                           NULL);
+	g_assert_no_error (error);
+	g_assert (NM_IS_CLIENT (filtered));
+	g_assert (nm_client_get_nm_running (filtered));
+
+	devices = nm_client_get_devices (filtered);
+	g_assert (devices);
+	g_assert_cmpint (devices->len, ==, 1);
+	g_assert_cmpstr (nm_device_get_iface (devices->pdata[0]), ==, "eth1");
+	g_assert (!nm_client_get_device_by_iface (filtered, "eth0"));
+
+	devices = nm_client_get_devices (client);
+	g_assert_cmpint (devices->len, ==, 2);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1616,6 +1736,8 @@ main (int argc, char **argv)
 	g_test_add_func ("/libnm/activate-failed", test_activate_failed);
 	g_test_add_func ("/libnm/device-connection-compatibility", test_device_connection_compatibility);
 	g_test_add_func ("/libnm/connection/invalid", test_connection_invalid);
+	g_test_add_func ("/libnm/connection/many", test_connections_many);
+	g_test_add_func ("/libnm/client-object-filter", test_object_filter);
 
 	return g_test_run ();
 }
@@ -51,6 +51,9 @@
 #define NMD_ACTION_DHCP6_CHANGE "dhcp6-change"
 #define NMD_ACTION_CONNECTIVITY_CHANGE "connectivity-change"
 
+/* Options of Action2() */
+#define NMD_OPTION_PARALLEL     "parallel"
+
 typedef enum {
 	DISPATCH_RESULT_UNKNOWN = 0,
 	DISPATCH_RESULT_SUCCESS = 1,
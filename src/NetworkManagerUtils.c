@@ -376,6 +376,8 @@ route_compare (NMIPRoute *route1, NMIPRoute *route2, gint64 default_metric)
 {
 	NMIPAddr a1;
 	NMIPAddr a2;
+	char buf1[NM_UTILS_INET_ADDRSTRLEN];
+	char buf2[NM_UTILS_INET_ADDRSTRLEN];
 	guint64 m1;
 	guint64 m2;
 	int family;
@@ -394,13 +396,11 @@ route_compare (NMIPRoute *route1, NMIPRoute *route2, gint64 default_metric)
 	NM_CMP_DIRECT (m1 == -1 ? default_metric : m1,
 	               m2 == -1 ? default_metric : m2);
 
-	NM_CMP_DIRECT_STRCMP0 (nm_ip_route_get_next_hop (route1),
-	                       nm_ip_route_get_next_hop (route2));
+	NM_CMP_DIRECT_STRCMP0 (_nm_ip_route_get_next_hop_str (route1, buf1),
+	                       _nm_ip_route_get_next_hop_str (route2, buf2));
 
-	if (!inet_pton (family, nm_ip_route_get_dest (route1), &a1))
-		nm_assert_not_reached ();
-	if (!inet_pton (family, nm_ip_route_get_dest (route2), &a2))
-		nm_assert_not_reached ();
+	a1 = *_nm_ip_route_get_dest_direct (route1);
+	a2 = *_nm_ip_route_get_dest_direct (route2);
 	nm_utils_ipx_address_clear_host_address (family, &a1, NULL, plen);
 	nm_utils_ipx_address_clear_host_address (family, &a2, NULL, plen);
 	NM_CMP_DIRECT_MEMCMP (&a1, &a2, nm_utils_addr_family_to_size (family));
@@ -512,6 +512,8 @@ typedef struct _NMDevicePrivate {
 	gulong         ndisc_timeout_id;
 	NMSettingIP6ConfigPrivacy ndisc_use_tempaddr;
 
+	NMNDiscRebuild ndisc_rebuild;
+
 	guint          linklocal6_timeout_id;
 	guint8         linklocal6_dad_counter;
 
@@ -574,10 +576,30 @@ typedef struct _NMDevicePrivate {
 	guint check_delete_unrealized_id;
 
 	struct {
-		guint timeout_id;
+		CList lst;
+		NMDevice *self;
+		gint64 due_at_ms;
 		guint refresh_rate_ms;
 		guint64 tx_bytes;
 		guint64 rx_bytes;
+		guint64 tx_packets;
+		guint64 rx_packets;
+		guint64 tx_errors;
+		guint64 rx_errors;
+		guint64 tx_dropped;
+		guint64 rx_dropped;
+		guint64 multicast;
+
+		/* the rates in bytes per second, calculated on each tick from the
+		 * difference to the previous sample. */
+		gint64 sampled_at_ms;
+		guint64 sampled_tx_bytes;
+		guint64 sampled_rx_bytes;
+		guint64 tx_bytes_rate;
+		guint64 rx_bytes_rate;
+
+		/* whether the counters changed since the last batched signal. */
+		bool changed:1;
 	} stats;
 
 } NMDevicePrivate;
@@ -1792,18 +1814,49 @@ nm_device_parent_find_for_connection (NMDevice *self,
 
 static void
 _stats_update_counters (NMDevice *self,
-                        guint64 tx_bytes,
-                        guint64 rx_bytes)
+                        const NMPlatformLink *pllink)
 {
 	NMDevicePrivate *priv;
+	guint64 tx_bytes = pllink ? pllink->tx_bytes : 0;
+	guint64 rx_bytes = pllink ? pllink->rx_bytes : 0;
 
 	priv = NM_DEVICE_GET_PRIVATE (self);
 
+#define _stats_set(field, value) \
+	G_STMT_START { \
+		guint64 _value = (value); \
+		\
+		if (priv->stats.field != _value) { \
+			priv->stats.field = _value; \
+			priv->stats.changed = TRUE; \
+		} \
+	} G_STMT_END
+
+	/* the additional counters are not exposed as properties but only
+	 * with the batched DeviceStatisticsChanged signal. */
+	_stats_set (tx_packets, pllink ? pllink->tx_packets : 0);
+	_stats_set (rx_packets, pllink ? pllink->rx_packets : 0);
+	_stats_set (tx_errors,  pllink ? pllink->tx_errors  : 0);
+	_stats_set (rx_errors,  pllink ? pllink->rx_errors  : 0);
+	_stats_set (tx_dropped, pllink ? pllink->tx_dropped : 0);
+	_stats_set (rx_dropped, pllink ? pllink->rx_dropped : 0);
+	_stats_set (multicast,  pllink ? pllink->multicast  : 0);
+
+#undef _stats_set
+
+	if (!pllink) {
+		priv->stats.sampled_at_ms = 0;
+		priv->stats.tx_bytes_rate = 0;
+		priv->stats.rx_bytes_rate = 0;
+	}
+
 	if (priv->stats.tx_bytes != tx_bytes) {
+		priv->stats.changed = TRUE;
 		priv->stats.tx_bytes = tx_bytes;
 		_notify (self, PROP_TX_BYTES);
 	}
 	if (priv->stats.rx_bytes != rx_bytes) {
+		priv->stats.changed = TRUE;
 		priv->stats.rx_bytes = rx_bytes;
 		_notify (self, PROP_RX_BYTES);
 	}
@@ -1812,23 +1865,62 @@ _stats_update_counters (NMDevice *self,
 static void
 _stats_update_counters_from_pllink (NMDevice *self, const NMPlatformLink *pllink)
 {
-	_stats_update_counters (self, pllink->tx_bytes, pllink->rx_bytes);
+	_stats_update_counters (self, pllink);
 }
 
-static gboolean
-_stats_timeout_cb (gpointer user_data)
+static guint64
+_stats_rate (guint64 value, guint64 old_value, gint64 elapsed_ms)
 {
-	NMDevice *self = user_data;
-	int ifindex;
+	/* a counter going backwards was reset, e.g. the driver reloaded. */
+	if (   elapsed_ms <= 0
+	    || value < old_value)
+		return 0;
+	return (value - old_value) * 1000u / (guint64) elapsed_ms;
+}
 
-	ifindex = nm_device_get_ip_ifindex (self);
+static void
+_stats_update_rates (NMDevice *self, gint64 now_ms)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	guint64 tx_rate = 0;
+	guint64 rx_rate = 0;
+
+	if (priv->stats.sampled_at_ms > 0) {
+		tx_rate = _stats_rate (priv->stats.tx_bytes, priv->stats.sampled_tx_bytes, now_ms - priv->stats.sampled_at_ms);
+		rx_rate = _stats_rate (priv->stats.rx_bytes, priv->stats.sampled_rx_bytes, now_ms - priv->stats.sampled_at_ms);
+	}
 
-	_LOGT (LOGD_DEVICE, "stats: refresh %d", ifindex);
+	priv->stats.sampled_at_ms = now_ms;
+	priv->stats.sampled_tx_bytes = priv->stats.tx_bytes;
+	priv->stats.sampled_rx_bytes = priv->stats.rx_bytes;
 
-	if (ifindex > 0)
-		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
+	if (   priv->stats.tx_bytes_rate != tx_rate
+	    || priv->stats.rx_bytes_rate != rx_rate) {
+		priv->stats.tx_bytes_rate = tx_rate;
+		priv->stats.rx_bytes_rate = rx_rate;
+		priv->stats.changed = TRUE;
+	}
+}
 
-	return G_SOURCE_CONTINUE;
+static GVariant *
+_stats_to_variant (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}", "tx-bytes", g_variant_new_uint64 (priv->stats.tx_bytes));
+	g_variant_builder_add (&builder, "{sv}", "rx-bytes", g_variant_new_uint64 (priv->stats.rx_bytes));
+	g_variant_builder_add (&builder, "{sv}", "tx-packets", g_variant_new_uint64 (priv->stats.tx_packets));
+	g_variant_builder_add (&builder, "{sv}", "rx-packets", g_variant_new_uint64 (priv->stats.rx_packets));
+	g_variant_builder_add (&builder, "{sv}", "tx-errors", g_variant_new_uint64 (priv->stats.tx_errors));
+	g_variant_builder_add (&builder, "{sv}", "rx-errors", g_variant_new_uint64 (priv->stats.rx_errors));
+	g_variant_builder_add (&builder, "{sv}", "tx-dropped", g_variant_new_uint64 (priv->stats.tx_dropped));
+	g_variant_builder_add (&builder, "{sv}", "rx-dropped", g_variant_new_uint64 (priv->stats.rx_dropped));
+	g_variant_builder_add (&builder, "{sv}", "multicast", g_variant_new_uint64 (priv->stats.multicast));
+	g_variant_builder_add (&builder, "{sv}", "tx-bytes-rate", g_variant_new_uint64 (priv->stats.tx_bytes_rate));
+	g_variant_builder_add (&builder, "{sv}", "rx-bytes-rate", g_variant_new_uint64 (priv->stats.rx_bytes_rate));
+	return g_variant_builder_end (&builder);
 }
 
 static guint
@@ -1848,6 +1940,201 @@ _stats_refresh_rate_real (guint refresh_rate_ms)
 	return refresh_rate_ms;
 }
 
+/* All devices with a refresh-rate share one timer. The due times are
+ * aligned to multiples of the refresh-rate, so that devices with the
+ * same rate get refreshed in the same tick, with one platform request
+ * per namespace instead of one wakeup per device. */
+static CList _stats_lst_head = C_LIST_INIT (_stats_lst_head);
+static guint _stats_timeout_id;
+static gint64 _stats_timeout_at_ms;
+
+/* refresh devices that are due shortly together with the current tick. */
+#define STATS_REFRESH_SLACK_MS 50
+
+static gboolean _stats_timeout_cb (gpointer user_data);
+
+static gint64
+_stats_next_due_ms (gint64 now_ms, guint rate_ms)
+{
+	nm_assert (rate_ms > 0);
+
+	return ((now_ms / rate_ms) + 1) * rate_ms;
+}
+
+static void
+_stats_schedule (gint64 now_ms)
+{
+	NMDevicePrivate *priv;
+	gint64 next_ms = 0;
+
+	c_list_for_each_entry (priv, &_stats_lst_head, stats.lst) {
+		if (   next_ms == 0
+		    || priv->stats.due_at_ms < next_ms)
+			next_ms = priv->stats.due_at_ms;
+	}
+
+	if (next_ms == 0) {
+		nm_clear_g_source (&_stats_timeout_id);
+		return;
+	}
+
+	if (   _stats_timeout_id
+	    && _stats_timeout_at_ms == next_ms)
+		return;
+
+	nm_clear_g_source (&_stats_timeout_id);
+	_stats_timeout_at_ms = next_ms;
+	_stats_timeout_id = g_timeout_add (MAX (next_ms - now_ms, 0), _stats_timeout_cb, NULL);
+}
+
+static void
+_stats_emit_changed (void)
+{
+	GVariantBuilder builder;
+	NMDevicePrivate *priv;
+	gboolean any = FALSE;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oa{sv}}"));
+
+	c_list_for_each_entry (priv, &_stats_lst_head, stats.lst) {
+		NMDevice *self = priv->stats.self;
+		const char *path;
+
+		if (!priv->stats.changed)
+			continue;
+		priv->stats.changed = FALSE;
+
+		path = nm_dbus_object_get_path (NM_DBUS_OBJECT (self));
+		if (!path)
+			continue;
+
+		g_variant_builder_add (&builder, "{o@a{sv}}", path, _stats_to_variant (self));
+		any = TRUE;
+	}
+
+	if (!any) {
+		g_variant_builder_clear (&builder);
+		return;
+	}
+
+	nm_manager_emit_device_statistics (nm_manager_get (), g_variant_builder_end (&builder));
+}
+
+static gboolean
+_stats_timeout_cb (gpointer user_data)
+{
+	gs_unref_hashtable GHashTable *by_platform = NULL;
+	gs_unref_ptrarray GPtrArray *devices = NULL;
+	NMDevicePrivate *priv;
+	GHashTableIter iter;
+	NMPlatform *platform;
+	GArray *ifindexes;
+	gint64 now_ms;
+	guint i;
+
+	_stats_timeout_id = 0;
+
+	now_ms = nm_utils_get_monotonic_timestamp_ms ();
+
+	by_platform = g_hash_table_new_full (nm_direct_hash, NULL, g_object_unref, (GDestroyNotify) g_array_unref);
+	devices = g_ptr_array_new_with_free_func (g_object_unref);
+
+	c_list_for_each_entry (priv, &_stats_lst_head, stats.lst) {
+		NMDevice *self = priv->stats.self;
+		int ifindex;
+
+		if (priv->stats.due_at_ms > now_ms + STATS_REFRESH_SLACK_MS)
+			continue;
+
+		priv->stats.due_at_ms = _stats_next_due_ms (MAX (now_ms, priv->stats.due_at_ms),
+		                                            _stats_refresh_rate_real (priv->stats.refresh_rate_ms));
+
+		ifindex = nm_device_get_ip_ifindex (self);
+
+		_LOGT (LOGD_DEVICE, "stats: refresh %d", ifindex);
+
+		if (ifindex <= 0)
+			continue;
+
+		platform = nm_device_get_platform (self);
+		ifindexes = g_hash_table_lookup (by_platform, platform);
+		if (!ifindexes) {
+			ifindexes = g_array_new (FALSE, FALSE, sizeof (int));
+			g_hash_table_insert (by_platform, g_object_ref (platform), ifindexes);
+		}
+		g_array_append_val (ifindexes, ifindex);
+		g_ptr_array_add (devices, g_object_ref (self));
+	}
+
+	/* the refresh may emit platform signals. We are done iterating the
+	 * list, devices that go away meanwhile only unlink themselves. */
+	g_hash_table_iter_init (&iter, by_platform);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &platform, (gpointer *) &ifindexes))
+		nm_platform_link_refresh_many (platform, (const int *) ifindexes->data, ifindexes->len);
+
+	/* the refresh is synchronous, the cache is up to date now. Sample the
+	 * counters right away to calculate the rates. */
+	now_ms = nm_utils_get_monotonic_timestamp_ms ();
+	for (i = 0; i < devices->len; i++) {
+		NMDevice *self = devices->pdata[i];
+		const NMPlatformLink *pllink;
+		int ifindex;
+
+		if (c_list_is_empty (&NM_DEVICE_GET_PRIVATE (self)->stats.lst))
+			continue;
+
+		ifindex = nm_device_get_ip_ifindex (self);
+		if (ifindex <= 0)
+			continue;
+
+		pllink = nm_platform_link_get (nm_device_get_platform (self), ifindex);
+		if (!pllink)
+			continue;
+
+		_stats_update_counters (self, pllink);
+		_stats_update_rates (self, now_ms);
+	}
+
+	_stats_emit_changed ();
+
+	_stats_schedule (now_ms);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_stats_stop (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	if (c_list_is_empty (&priv->stats.lst))
+		return;
+
+	c_list_unlink (&priv->stats.lst);
+	_stats_schedule (nm_utils_get_monotonic_timestamp_ms ());
+}
+
+static void
+_stats_start (NMDevice *self)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	gint64 now_ms;
+	guint rate_ms;
+
+	rate_ms = _stats_refresh_rate_real (priv->stats.refresh_rate_ms);
+	if (!rate_ms) {
+		_stats_stop (self);
+		return;
+	}
+
+	now_ms = nm_utils_get_monotonic_timestamp_ms ();
+	priv->stats.due_at_ms = _stats_next_due_ms (now_ms, rate_ms);
+	if (c_list_is_empty (&priv->stats.lst)) {
+		priv->stats.sampled_at_ms = 0;
+		c_list_link_tail (&_stats_lst_head, &priv->stats.lst);
+	}
+	_stats_schedule (now_ms);
+}
+
 static void
 _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 {
@@ -1873,10 +2160,10 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (_stats_refresh_rate_real (old_rate) == refresh_rate_ms)
 		return;
 
-	nm_clear_g_source (&priv->stats.timeout_id);
-
-	if (!refresh_rate_ms)
+	if (!refresh_rate_ms) {
+		_stats_stop (self);
 		return;
+	}
 
 	/* trigger an initial refresh of the data whenever the refresh-rate changes.
 	 * As we process the result in an idle handler with device_link_changed(),
@@ -1885,7 +2172,7 @@ _stats_set_refresh_rate (NMDevice *self, guint refresh_rate_ms)
 	if (ifindex > 0)
 		nm_platform_link_refresh (nm_device_get_platform (self), ifindex);
 
-	priv->stats.timeout_id = g_timeout_add (refresh_rate_ms, _stats_timeout_cb, self);
+	_stats_start (self);
 }
 
 /*****************************************************************************/
@@ -2575,6 +2862,15 @@ concheck_periodic_schedule_do (NMDevice *self, int addr_family, gint64 now_ns)
 	 * correct. */
 
 	expiry = priv->concheck_x[IS_IPv4].p_cur_basetime_ns + (priv->concheck_x[IS_IPv4].p_cur_interval * NM_UTILS_NS_PER_SECOND);
+
+	if (   priv->concheck_x[IS_IPv4].p_cur_interval == priv->concheck_x[IS_IPv4].p_max_interval
+	    && priv->concheck_x[IS_IPv4].p_cur_interval >= 10) {
+		/* in the steady state, delay the check by up to 5% of the interval.
+		 * Otherwise, the checks of devices that got activated at the same
+		 * time all fire at once. */
+		expiry += ((gint64) g_random_int_range (0, priv->concheck_x[IS_IPv4].p_cur_interval * 50)) * NM_UTILS_NS_PER_MSEC;
+	}
+
 	tdiff = expiry - now_ns;
 
 	_LOGT (LOGD_CONCHECK, "connectivity: [IPv%c] periodic-check: %sscheduled in %lld milliseconds (%u seconds interval)",
@@ -4258,7 +4554,6 @@ realize_start_setup (NMDevice *self,
 	static guint32 id = 0;
 	NMDeviceCapabilities capabilities = 0;
 	NMConfig *config;
-	guint real_rate;
 
 	/* plink is a NMPlatformLink type, however, we require it to come from the platform
 	 * cache (where else would it come from?). */
@@ -4361,10 +4656,8 @@ realize_start_setup (NMDevice *self,
 
 	nm_device_set_carrier_from_platform (self);
 
-	nm_assert (!priv->stats.timeout_id);
-	real_rate = _stats_refresh_rate_real (priv->stats.refresh_rate_ms);
-	if (real_rate)
-		priv->stats.timeout_id = g_timeout_add (real_rate, _stats_timeout_cb, self);
+	nm_assert (c_list_is_empty (&priv->stats.lst));
+	_stats_start (self);
 
 	klass->realize_start_notify (self, plink);
 
@@ -4551,8 +4844,8 @@ nm_device_unrealize (NMDevice *self, gboolean remove_resources, GError **error)
 		_notify (self, PROP_PHYSICAL_PORT_ID);
 	}
 
-	nm_clear_g_source (&priv->stats.timeout_id);
-	_stats_update_counters (self, 0, 0);
+	_stats_stop (self);
+	_stats_update_counters (self, NULL);
 
 	priv->hw_addr_len_ = 0;
 	if (nm_clear_g_free (&priv->hw_addr))
@@ -7509,6 +7802,15 @@ get_dhcp_timeout (NMDevice *self, int addr_family)
 	return timeout ?: NM_DHCP_TIMEOUT_DEFAULT;
 }
 
+static guint
+get_dhcp4_renewal_jitter (NMDevice *self)
+{
+	return nm_config_data_get_connection_default_int64 (NM_CONFIG_GET_DATA,
+	                                                    NM_CON_DEFAULT ("ipv4.dhcp-renewal-jitter"),
+	                                                    self,
+	                                                    0, 50, 0);
+}
+
 static GBytes *
 dhcp4_get_client_id (NMDevice *self,
                      NMConnection *connection,
@@ -7680,6 +7982,7 @@ dhcp4_start (NMDevice *self)
 	                                                nm_setting_ip4_config_get_dhcp_fqdn (NM_SETTING_IP4_CONFIG (s_ip4)),
 	                                                client_id,
 	                                                get_dhcp_timeout (self, AF_INET),
+	                                                get_dhcp4_renewal_jitter (self),
 	                                                priv->dhcp_anycast_address,
 	                                                NULL,
 	                                                &error);
@@ -9119,11 +9422,28 @@ nm_device_commit_mtu (NMDevice *self)
 		_LOGT (LOGD_DEVICE, "mtu: commit-mtu... skip due to state %s", nm_device_state_to_str (state));
 }
 
+/* When only the lifetimes of the RA data change, we postpone rebuilding
+ * the IPv6 configuration of the device by that much. */
+#define NDISC_REBUILD_DELAY_SEC 30
+
+static gboolean
+ndisc_rebuild_cb (gpointer user_data)
+{
+	NMDevice *self = user_data;
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+
+	priv->ndisc_rebuild.timeout_id = 0;
+	_LOGD (LOGD_IP6, "ndisc: rebuild IPv6 configuration after lifetime updates");
+	nm_device_activate_schedule_ip_config_result (self, AF_INET6, NULL);
+	return G_SOURCE_REMOVE;
+}
+
 static void
 ndisc_config_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, NMDevice *self)
 {
 	NMNDiscConfigMap changed = changed_int;
 	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	gboolean lifetimes_only;
 	guint i;
 
 	g_return_if_fail (priv->act_request.obj);
@@ -9131,6 +9451,17 @@ ndisc_config_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_in
 	if (!applied_config_get_current (&priv->ac_ip6_config))
 		applied_config_init_new (&priv->ac_ip6_config, self, AF_INET6);
 
+	/* Routers re-announce the same prefixes, routes and DNS information
+	 * periodically and only extend their lifetimes. In that case, there is
+	 * no need to rebuild and commit the entire IPv6 configuration on each RA.
+	 * Instead, update the address lifetimes in place and rebuild the
+	 * configuration once, later. */
+	changed = nm_ndisc_rebuild_check (&priv->ndisc_rebuild,
+	                                  rdata,
+	                                  changed,
+	                                  priv->ip_state_6 == NM_DEVICE_IP_STATE_DONE,
+	                                  &lifetimes_only);
+
 	if (changed & NM_NDISC_CONFIG_ADDRESSES) {
 		guint8 plen;
 		guint32 ifa_flags;
@@ -9233,6 +9564,22 @@ ndisc_config_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_in
 		}
 	}
 
+	if (lifetimes_only) {
+		const NMIPConfig *config;
+
+		config = applied_config_get_current (&priv->ac_ip6_config);
+		if (   config
+		    && (changed & NM_NDISC_CONFIG_ADDRESSES)) {
+			nm_ip6_config_refresh_addresses_ndisc ((const NMIP6Config *) config,
+			                                       nm_device_get_platform (self),
+			                                       nm_utils_get_monotonic_timestamp_s ());
+		}
+		nm_ndisc_rebuild_postpone (&priv->ndisc_rebuild, NDISC_REBUILD_DELAY_SEC, ndisc_rebuild_cb, self);
+		_LOGD (LOGD_IP6, "ndisc: only lifetimes changed, postpone rebuilding IPv6 configuration (%u rebuilds avoided)",
+		       priv->ndisc_rebuild.avoided);
+		return;
+	}
+
 	nm_device_activate_schedule_ip_config_result (self, AF_INET6, NULL);
 }
 
@@ -9400,6 +9747,7 @@ addrconf6_cleanup (NMDevice *self)
 	priv->ndisc_started = FALSE;
 	nm_clear_g_signal_handler (priv->ndisc, &priv->ndisc_changed_id);
 	nm_clear_g_signal_handler (priv->ndisc, &priv->ndisc_timeout_id);
+	nm_ndisc_rebuild_reset (&priv->ndisc_rebuild);
 
 	nm_device_remove_pending_action (self, NM_PENDING_ACTION_AUTOCONF6, FALSE);
 
@@ -16014,6 +16362,8 @@ nm_device_init (NMDevice *self)
 	c_list_init (&priv->concheck_lst_head);
 	c_list_init (&self->devices_lst);
 	c_list_init (&priv->slaves);
+	c_list_init (&priv->stats.lst);
+	priv->stats.self = self;
 
 	priv->concheck_x[0].state = NM_CONNECTIVITY_UNKNOWN;
 	priv->concheck_x[1].state = NM_CONNECTIVITY_UNKNOWN;
@@ -16184,7 +16534,7 @@ dispose (GObject *object)
 
 	nm_clear_g_source (&priv->check_delete_unrealized_id);
 
-	nm_clear_g_source (&priv->stats.timeout_id);
+	_stats_stop (self);
 
 	carrier_disconnected_action_cancel (self);
 
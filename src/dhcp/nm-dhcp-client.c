@@ -60,6 +60,7 @@ NM_GOBJECT_PROPERTIES_DEFINE (NMDhcpClient,
 	PROP_TIMEOUT,
 	PROP_UUID,
 	PROP_HOSTNAME,
+	PROP_RENEWAL_JITTER,
 );
 
 typedef struct _NMDhcpClientPrivate {
@@ -77,6 +78,7 @@ typedef struct _NMDhcpClientPrivate {
 	guint32      route_table;
 	guint32      route_metric;
 	guint32      timeout;
+	guint        renewal_jitter;
 	NMDhcpState  state;
 	bool         info_only:1;
 	bool         use_fqdn:1;
@@ -190,6 +192,21 @@ nm_dhcp_client_get_timeout (NMDhcpClient *self)
 	return NM_DHCP_CLIENT_GET_PRIVATE (self)->timeout;
 }
 
+/**
+ * nm_dhcp_client_get_renewal_jitter:
+ * @self: the #NMDhcpClient
+ *
+ * Returns: by how many percent at most the client should randomly move
+ *   renewal (T1) and rebinding (T2) forward. Zero for no extra jitter.
+ */
+guint
+nm_dhcp_client_get_renewal_jitter (NMDhcpClient *self)
+{
+	g_return_val_if_fail (NM_IS_DHCP_CLIENT (self), 0);
+
+	return NM_DHCP_CLIENT_GET_PRIVATE (self)->renewal_jitter;
+}
+
 GBytes *
 nm_dhcp_client_get_client_id (NMDhcpClient *self)
 {
@@ -857,6 +874,9 @@ get_property (GObject *object, guint prop_id,
 	case PROP_TIMEOUT:
 		g_value_set_uint (value, priv->timeout);
 		break;
+	case PROP_RENEWAL_JITTER:
+		g_value_set_uint (value, priv->renewal_jitter);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -924,6 +944,10 @@ set_property (GObject *object, guint prop_id,
 		/* construct-only */
 		priv->timeout = g_value_get_uint (value);
 		break;
+	case PROP_RENEWAL_JITTER:
+		/* construct-only */
+		priv->renewal_jitter = g_value_get_uint (value);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -1046,6 +1070,12 @@ nm_dhcp_client_class_init (NMDhcpClientClass *client_class)
 	                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
 	                       G_PARAM_STATIC_STRINGS);
 
+	obj_properties[PROP_RENEWAL_JITTER] =
+	    g_param_spec_uint (NM_DHCP_CLIENT_RENEWAL_JITTER, "", "",
+	                       0, 50, 0,
+	                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+	                       G_PARAM_STATIC_STRINGS);
+
 	obj_properties[PROP_FLAGS] =
 	    g_param_spec_uint (NM_DHCP_CLIENT_FLAGS, "", "",
 	                       0, G_MAXUINT32, 0,
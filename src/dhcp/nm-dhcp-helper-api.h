@@ -33,4 +33,20 @@
 
 /*****************************************************************************/
 
+/* Besides the D-Bus method above, NetworkManager accepts events as datagrams
+ * on a unix socket. That spares the helper to set up a D-Bus connection for
+ * each event. The helper falls back to D-Bus if the socket is not there.
+ *
+ * A datagram starts with NM_DHCP_HELPER_EVENT_MAGIC. Then follows one
+ * record per variable: the length of the name and of the value as guint16
+ * in host byte order, and the bytes of the name and of the value, without
+ * trailing NUL. */
+
+#define NM_DHCP_HELPER_EVENT_SOCKET_PATH        NMRUNDIR "/private-dhcp-event"
+#define NM_DHCP_HELPER_EVENT_MAGIC              "NMD1"
+#define NM_DHCP_HELPER_EVENT_MAGIC_LEN          4
+#define NM_DHCP_HELPER_EVENT_MAX_SIZE           (64 * 1024)
+
+/*****************************************************************************/
+
 #endif /* __NM_DHCP_HELPER_API_H__ */
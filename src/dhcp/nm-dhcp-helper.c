@@ -23,6 +23,8 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 #include "nm-utils/nm-vpn-plugin-macros.h"
 
@@ -63,6 +65,104 @@
 
 static const char * ignore[] = {"PATH", "SHLVL", "_", "PWD", "dhc_dbus", NULL};
 
+static gboolean
+is_ignored (const char *name)
+{
+	const char **p;
+
+	/* Ignore non-DCHP-related environment variables */
+	for (p = ignore; *p; p++) {
+		if (strncmp (name, *p, strlen (*p)) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/* Sends the environment as one datagram to NetworkManager, in the format
+ * described in nm-dhcp-helper-api.h. This is done for every DHCP event,
+ * so it sticks to plain syscalls and sets up no D-Bus connection.
+ *
+ * Returns: %FALSE if the event could not be sent and the caller
+ *   should fall back to D-Bus. */
+static gboolean
+notify_dgram (void)
+{
+	static guint8 buf[NM_DHCP_HELPER_EVENT_MAX_SIZE];
+	const struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+		.sun_path = NM_DHCP_HELPER_EVENT_SOCKET_PATH,
+	};
+	const struct timeval timeout = {
+		.tv_sec = 1,
+	};
+	gsize len;
+	char **item;
+	ssize_t n;
+	int errsv;
+	int fd;
+
+	memcpy (buf, NM_DHCP_HELPER_EVENT_MAGIC, NM_DHCP_HELPER_EVENT_MAGIC_LEN);
+	len = NM_DHCP_HELPER_EVENT_MAGIC_LEN;
+
+	for (item = environ; *item; item++) {
+		const char *val;
+		gsize name_len, val_len;
+		guint16 l;
+
+		val = strchr (*item, '=');
+		if (!val || val == *item)
+			continue;
+		if (is_ignored (*item))
+			continue;
+
+		name_len = val - *item;
+		val++;
+		val_len = strlen (val);
+
+		if (   name_len > G_MAXUINT16
+		    || val_len > G_MAXUINT16
+		    || sizeof (buf) - len < 4 + name_len + val_len) {
+			_LOGi ("event too large to send via socket");
+			return FALSE;
+		}
+
+		l = name_len;
+		memcpy (&buf[len], &l, sizeof (l));
+		l = val_len;
+		memcpy (&buf[len + 2], &l, sizeof (l));
+		memcpy (&buf[len + 4], *item, name_len);
+		memcpy (&buf[len + 4 + name_len], val, val_len);
+		len += 4 + name_len + val_len;
+	}
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		errsv = errno;
+		_LOGi ("could not create socket: %s", strerror (errsv));
+		return FALSE;
+	}
+
+	/* if NetworkManager does not keep up, give up eventually and
+	 * let D-Bus queue the event. */
+	(void) setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof (timeout));
+
+	n = sendto (fd, buf, len, MSG_NOSIGNAL, (const struct sockaddr *) &addr, sizeof (addr));
+	errsv = errno;
+	close (fd);
+
+	if (n != (ssize_t) len) {
+		/* ENOENT or ECONNREFUSED if NetworkManager is older and does
+		 * not listen on the socket. That is expected, don't be loud. */
+		if (   n < 0
+		    && NM_IN_SET (errsv, ENOENT, ECONNREFUSED))
+			_LOGd ("could not send event via socket: %s", strerror (errsv));
+		else
+			_LOGi ("could not send event via socket: %s", n < 0 ? strerror (errsv) : "short write");
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static GVariant *
 build_signal_parameters (void)
 {
@@ -73,7 +173,7 @@ build_signal_parameters (void)
 
 	/* List environment and format for dbus dict */
 	for (item = environ; *item; item++) {
-		char *name, *val, **p;
+		char *name, *val;
 
 		/* Split on the = */
 		name = g_strdup (*item);
@@ -82,11 +182,8 @@ build_signal_parameters (void)
 			goto next;
 		*val++ = '\0';
 
-		/* Ignore non-DCHP-related environment variables */
-		for (p = (char **) ignore; *p; p++) {
-			if (strncmp (name, *p, strlen (*p)) == 0)
-				goto next;
-		}
+		if (is_ignored (name))
+			goto next;
 
 		/* Value passed as a byte array rather than a string, because there are
 		 * no character encoding guarantees with DHCP, and D-Bus requires
@@ -133,6 +230,9 @@ main (int argc, char *argv[])
 	guint try_count = 0;
 	gint64 time_end;
 
+	if (notify_dgram ())
+		return EXIT_SUCCESS;
+
 	/* FIXME: g_dbus_connection_new_for_address_sync() tries to connect to the socket in
 	 * non-blocking mode, which can easily fail with EAGAIN, causing the creation of the
 	 * socket to fail with "Could not connect: Resource temporarily unavailable".
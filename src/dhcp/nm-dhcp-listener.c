@@ -22,6 +22,8 @@
 #include "nm-dhcp-listener.h"
 
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <signal.h>
 #include <stdlib.h>
@@ -62,6 +64,9 @@ typedef struct {
 	gulong              new_conn_id;
 	gulong              dis_conn_id;
 	GHashTable *        connections;
+	GIOChannel *        event_channel;
+	guint               event_id;
+	guint8 *            event_buf;
 } NMDhcpListenerPrivate;
 
 struct _NMDhcpListener {
@@ -137,18 +142,15 @@ get_option (GVariant *options, const char *key)
 }
 
 static void
-_method_call_handle (NMDhcpListener *self,
-                     GVariant *parameters)
+_event_handle (NMDhcpListener *self,
+               GVariant *options)
 {
 	gs_free char *iface = NULL;
 	gs_free char *pid_str = NULL;
 	gs_free char *reason = NULL;
-	gs_unref_variant GVariant *options = NULL;
 	int pid;
 	gboolean handled = FALSE;
 
-	g_variant_get (parameters, "(@a{sv})", &options);
-
 	iface = get_option (options, "interface");
 	if (iface == NULL) {
 		_LOGW ("dhcp-event: didn't have associated interface.");
@@ -189,6 +191,7 @@ _method_call (GDBusConnection *connection,
               gpointer user_data)
 {
 	NMDhcpListener *self = NM_DHCP_LISTENER (user_data);
+	gs_unref_variant GVariant *options = NULL;
 
 	if (   !nm_streq (interface_name, NM_DHCP_HELPER_SERVER_INTERFACE_NAME)
 	    || !nm_streq (method_name, NM_DHCP_HELPER_SERVER_METHOD_NOTIFY)) {
@@ -200,7 +203,8 @@ _method_call (GDBusConnection *connection,
 		return;
 	}
 
-	_method_call_handle (self, parameters);
+	g_variant_get (parameters, "(@a{sv})", &options);
+	_event_handle (self, options);
 	g_dbus_method_invocation_return_value (invocation, NULL);
 }
 
@@ -274,6 +278,172 @@ dis_connection_cb (NMDBusManager *mgr,
 
 /*****************************************************************************/
 
+/* Parses a datagram from nm-dhcp-helper (see nm-dhcp-helper-api.h) into
+ * the same a{sv} dictionary that the helper sends via D-Bus. */
+static GVariant *
+_event_parse (const guint8 *buf, gsize len)
+{
+	GVariantBuilder builder;
+	gsize pos;
+
+	if (   len < NM_DHCP_HELPER_EVENT_MAGIC_LEN
+	    || memcmp (buf, NM_DHCP_HELPER_EVENT_MAGIC, NM_DHCP_HELPER_EVENT_MAGIC_LEN) != 0)
+		return NULL;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+
+	pos = NM_DHCP_HELPER_EVENT_MAGIC_LEN;
+	while (pos < len) {
+		gs_free char *name = NULL;
+		guint16 name_len, val_len;
+
+		if (len - pos < 4)
+			goto fail;
+		memcpy (&name_len, &buf[pos], sizeof (name_len));
+		memcpy (&val_len, &buf[pos + 2], sizeof (val_len));
+		pos += 4;
+
+		if (   name_len == 0
+		    || len - pos < (gsize) name_len + val_len)
+			goto fail;
+
+		if (   memchr (&buf[pos], '\0', name_len)
+		    || !g_utf8_validate ((const char *) &buf[pos], name_len, NULL))
+			goto fail;
+		name = g_strndup ((const char *) &buf[pos], name_len);
+		pos += name_len;
+
+		g_variant_builder_add (&builder, "{sv}",
+		                       name,
+		                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+		                                                  &buf[pos], val_len, 1));
+		pos += val_len;
+	}
+
+	return g_variant_ref_sink (g_variant_builder_end (&builder));
+
+fail:
+	g_variant_builder_clear (&builder);
+	return NULL;
+}
+
+GVariant *
+_nmtst_dhcp_listener_event_parse (const guint8 *buf, gsize len)
+{
+	return _event_parse (buf, len);
+}
+
+static gboolean
+_event_socket_cb (GIOChannel *channel,
+                  GIOCondition condition,
+                  gpointer user_data)
+{
+	NMDhcpListener *self = NM_DHCP_LISTENER (user_data);
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+	int fd = g_io_channel_unix_get_fd (channel);
+
+	/* when many leases renew at the same time, events arrive in bursts.
+	 * Handle all queued events at once. */
+	while (TRUE) {
+		union {
+			struct cmsghdr cmsghdr;
+			guint8 buf[CMSG_SPACE (sizeof (struct ucred))];
+		} control;
+		struct iovec iov = {
+			.iov_base = priv->event_buf,
+			.iov_len = NM_DHCP_HELPER_EVENT_MAX_SIZE,
+		};
+		struct msghdr msg = {
+			.msg_iov = &iov,
+			.msg_iovlen = 1,
+			.msg_control = &control,
+			.msg_controllen = sizeof (control),
+		};
+		gs_unref_variant GVariant *options = NULL;
+		const struct ucred *cred = NULL;
+		struct cmsghdr *cmsg;
+		ssize_t n;
+		int errsv;
+
+		n = recvmsg (fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+		if (n < 0) {
+			errsv = errno;
+			if (errsv == EINTR)
+				continue;
+			if (errsv != EAGAIN)
+				_LOGW ("dhcp-event: failure to receive event: %s", strerror (errsv));
+			break;
+		}
+
+		for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+			if (   cmsg->cmsg_level == SOL_SOCKET
+			    && cmsg->cmsg_type == SCM_CREDENTIALS
+			    && cmsg->cmsg_len >= CMSG_LEN (sizeof (struct ucred)))
+				cred = (const struct ucred *) CMSG_DATA (cmsg);
+		}
+
+		/* like the private D-Bus socket, only accept events from our own user. */
+		if (!cred || cred->uid != geteuid ()) {
+			_LOGW ("dhcp-event: ignore event from unauthorized sender");
+			continue;
+		}
+
+		if (NM_FLAGS_HAS (msg.msg_flags, MSG_TRUNC)) {
+			_LOGW ("dhcp-event: ignore truncated event");
+			continue;
+		}
+
+		options = _event_parse (priv->event_buf, n);
+		if (!options) {
+			_LOGW ("dhcp-event: ignore malformed event");
+			continue;
+		}
+
+		_event_handle (self, options);
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+_event_socket_setup (NMDhcpListener *self)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+	const struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+		.sun_path = NM_DHCP_HELPER_EVENT_SOCKET_PATH,
+	};
+	const int one = 1;
+	int fd;
+	int errsv;
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+	if (fd < 0) {
+		errsv = errno;
+		_LOGW ("failure to create socket for DHCP events: %s", strerror (errsv));
+		return;
+	}
+
+	(void) unlink (NM_DHCP_HELPER_EVENT_SOCKET_PATH);
+
+	if (   setsockopt (fd, SOL_SOCKET, SO_PASSCRED, &one, sizeof (one)) < 0
+	    || bind (fd, (const struct sockaddr *) &addr, sizeof (addr)) < 0
+	    || chmod (NM_DHCP_HELPER_EVENT_SOCKET_PATH, 0600) < 0) {
+		errsv = errno;
+		_LOGW ("failure to listen on %s for DHCP events: %s",
+		       NM_DHCP_HELPER_EVENT_SOCKET_PATH, strerror (errsv));
+		nm_close (fd);
+		return;
+	}
+
+	priv->event_buf = g_malloc (NM_DHCP_HELPER_EVENT_MAX_SIZE);
+	priv->event_channel = g_io_channel_unix_new (fd);
+	g_io_channel_set_close_on_unref (priv->event_channel, TRUE);
+	priv->event_id = g_io_add_watch (priv->event_channel, G_IO_IN, _event_socket_cb, self);
+}
+
+/*****************************************************************************/
+
 static void
 nm_dhcp_listener_init (NMDhcpListener *self)
 {
@@ -294,6 +464,9 @@ nm_dhcp_listener_init (NMDhcpListener *self)
 	                                      NM_DBUS_MANAGER_PRIVATE_CONNECTION_DISCONNECTED "::" PRIV_SOCK_TAG,
 	                                      G_CALLBACK (dis_connection_cb),
 	                                      self);
+
+	/* the D-Bus socket stays for helpers that don't know about this one. */
+	_event_socket_setup (self);
 }
 
 static void
@@ -307,6 +480,13 @@ dispose (GObject *object)
 
 	g_clear_pointer (&priv->connections, g_hash_table_destroy);
 
+	nm_clear_g_source (&priv->event_id);
+	if (priv->event_channel) {
+		g_clear_pointer (&priv->event_channel, g_io_channel_unref);
+		(void) unlink (NM_DHCP_HELPER_EVENT_SOCKET_PATH);
+	}
+	nm_clear_g_free (&priv->event_buf);
+
 	G_OBJECT_CLASS (nm_dhcp_listener_parent_class)->dispose (object);
 }
 
@@ -33,4 +33,6 @@ GType nm_dhcp_listener_get_type (void);
 
 NMDhcpListener *nm_dhcp_listener_get (void);
 
+GVariant *_nmtst_dhcp_listener_event_parse (const guint8 *buf, gsize len);
+
 #endif /* __NETWORKMANAGER_DHCP_LISTENER_H__ */
@@ -43,6 +43,11 @@ typedef struct {
 	const NMDhcpClientFactory *client_factory;
 	char *default_hostname;
 	CList dhcp_client_lst_head;
+
+	/* The clients of dhcp_client_lst_head by ifindex, one table for
+	 * IPv4 and one for IPv6. There is at most one client per ifindex
+	 * and address family. */
+	GHashTable *dhcp_client_idx[2];
 } NMDhcpManagerPrivate;
 
 struct _NMDhcpManager {
@@ -92,24 +97,26 @@ _client_factory_available (const NMDhcpClientFactory *client_factory)
 
 /*****************************************************************************/
 
+static GHashTable *
+_client_idx (NMDhcpManagerPrivate *priv, int addr_family)
+{
+	nm_assert_addr_family (addr_family);
+
+	return priv->dhcp_client_idx[addr_family == AF_INET6];
+}
+
 static NMDhcpClient *
 get_client_for_ifindex (NMDhcpManager *manager, int addr_family, int ifindex)
 {
 	NMDhcpManagerPrivate *priv;
-	NMDhcpClient *client;
 
 	g_return_val_if_fail (NM_IS_DHCP_MANAGER (manager), NULL);
 	g_return_val_if_fail (ifindex > 0, NULL);
 
 	priv = NM_DHCP_MANAGER_GET_PRIVATE (manager);
 
-	c_list_for_each_entry (client, &priv->dhcp_client_lst_head, dhcp_client_lst) {
-		if (   nm_dhcp_client_get_ifindex (client) == ifindex
-		    && nm_dhcp_client_get_addr_family (client) == addr_family)
-			return client;
-	}
-
-	return NULL;
+	return g_hash_table_lookup (_client_idx (priv, addr_family),
+	                            GINT_TO_POINTER (ifindex));
 }
 
 static void client_state_changed (NMDhcpClient *client,
@@ -122,8 +129,14 @@ static void client_state_changed (NMDhcpClient *client,
 static void
 remove_client (NMDhcpManager *self, NMDhcpClient *client)
 {
+	NMDhcpManagerPrivate *priv = NM_DHCP_MANAGER_GET_PRIVATE (self);
+	GHashTable *idx = _client_idx (priv, nm_dhcp_client_get_addr_family (client));
+	gpointer key = GINT_TO_POINTER (nm_dhcp_client_get_ifindex (client));
+
 	g_signal_handlers_disconnect_by_func (client, client_state_changed, self);
 	c_list_unlink (&client->dhcp_client_lst);
+	if (g_hash_table_lookup (idx, key) == client)
+		g_hash_table_remove (idx, key);
 
 	/* Stopping the client is left up to the controlling device
 	 * explicitly since we may want to quit NetworkManager but not terminate
@@ -164,6 +177,7 @@ client_start (NMDhcpManager *self,
               GBytes *dhcp_client_id,
               gboolean enforce_duid,
               guint32 timeout,
+              guint renewal_jitter,
               const char *dhcp_anycast_addr,
               const char *hostname,
               gboolean hostname_use_fqdn,
@@ -224,6 +238,7 @@ client_start (NMDhcpManager *self,
 	                       NM_DHCP_CLIENT_ROUTE_TABLE, (guint) route_table,
 	                       NM_DHCP_CLIENT_ROUTE_METRIC, (guint) route_metric,
 	                       NM_DHCP_CLIENT_TIMEOUT, (guint) timeout,
+	                       NM_DHCP_CLIENT_RENEWAL_JITTER, renewal_jitter,
 	                       NM_DHCP_CLIENT_FLAGS, (guint) (0
 	                           | (hostname_use_fqdn ? NM_DHCP_CLIENT_FLAGS_USE_FQDN  : 0)
 	                           | (info_only         ? NM_DHCP_CLIENT_FLAGS_INFO_ONLY : 0)
@@ -231,6 +246,8 @@ client_start (NMDhcpManager *self,
 	                       NULL);
 	nm_assert (client && c_list_is_empty (&client->dhcp_client_lst));
 	c_list_link_tail (&priv->dhcp_client_lst_head, &client->dhcp_client_lst);
+	nm_assert (!g_hash_table_contains (_client_idx (priv, addr_family), GINT_TO_POINTER (ifindex)));
+	g_hash_table_insert (_client_idx (priv, addr_family), GINT_TO_POINTER (ifindex), client);
 	g_signal_connect (client, NM_DHCP_CLIENT_SIGNAL_STATE_CHANGED, G_CALLBACK (client_state_changed), self);
 
 	/* unfortunately, our implementations work differently per address-family regarding client-id/DUID.
@@ -299,6 +316,7 @@ nm_dhcp_manager_start_ip4 (NMDhcpManager *self,
                            const char *dhcp_fqdn,
                            GBytes *dhcp_client_id,
                            guint32 timeout,
+                           guint renewal_jitter,
                            const char *dhcp_anycast_addr,
                            const char *last_ip_address,
                            GError **error)
@@ -348,6 +366,7 @@ nm_dhcp_manager_start_ip4 (NMDhcpManager *self,
 	                     dhcp_client_id,
 	                     FALSE,
 	                     timeout,
+	                     renewal_jitter,
 	                     dhcp_anycast_addr,
 	                     hostname,
 	                     use_fqdn,
@@ -403,6 +422,7 @@ nm_dhcp_manager_start_ip6 (NMDhcpManager *self,
 	                     duid,
 	                     enforce_duid,
 	                     timeout,
+	                     0,
 	                     dhcp_anycast_addr,
 	                     hostname,
 	                     TRUE,
@@ -459,6 +479,8 @@ nm_dhcp_manager_init (NMDhcpManager *self)
 	const NMDhcpClientFactory *client_factory = NULL;
 
 	c_list_init (&priv->dhcp_client_lst_head);
+	priv->dhcp_client_idx[0] = g_hash_table_new (g_direct_hash, g_direct_equal);
+	priv->dhcp_client_idx[1] = g_hash_table_new (g_direct_hash, g_direct_equal);
 
 	for (i = 0; i < G_N_ELEMENTS (_nm_dhcp_manager_factories); i++) {
 		const NMDhcpClientFactory *f = _nm_dhcp_manager_factories[i];
@@ -532,10 +554,22 @@ dispose (GObject *object)
 	nm_clear_g_free (&priv->default_hostname);
 }
 
+static void
+finalize (GObject *object)
+{
+	NMDhcpManagerPrivate *priv = NM_DHCP_MANAGER_GET_PRIVATE ((NMDhcpManager *) object);
+
+	g_hash_table_unref (priv->dhcp_client_idx[0]);
+	g_hash_table_unref (priv->dhcp_client_idx[1]);
+
+	G_OBJECT_CLASS (nm_dhcp_manager_parent_class)->finalize (object);
+}
+
 static void
 nm_dhcp_manager_class_init (NMDhcpManagerClass *manager_class)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (manager_class);
 
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
 }
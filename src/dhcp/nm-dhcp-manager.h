@@ -58,6 +58,7 @@ NMDhcpClient * nm_dhcp_manager_start_ip4     (NMDhcpManager *manager,
                                               const char *dhcp_fqdn,
                                               GBytes *dhcp_client_id,
                                               guint32 timeout,
+                                              guint renewal_jitter,
                                               const char *dhcp_anycast_addr,
                                               const char *last_ip_address,
                                               GError **error);
@@ -25,6 +25,7 @@
 #include <arpa/inet.h>
 #include <ctype.h>
 #include <net/if_arp.h>
+#include <sys/stat.h>
 
 #include "nm-utils/nm-dedup-multi.h"
 #include "nm-utils/unaligned.h"
@@ -59,6 +60,10 @@ typedef struct {
 	sd_dhcp6_client *client6;
 	char *lease_file;
 
+	/* a bound IPv4 lease that is not yet written to lease_file. */
+	sd_dhcp_lease *lease_save;
+	CList lease_save_lst;
+
 	guint request_count;
 
 	bool privacy:1;
@@ -223,6 +228,66 @@ add_requests_to_options (GHashTable *options, const ReqOption *requests)
 	}
 }
 
+/* Writing a lease file means creating a temporary file and renaming it
+ * over the old one. When many interfaces get or renew their lease at
+ * the same time (for example after the switch they are connected to
+ * rebooted), doing that right away for each of them piles up. Instead,
+ * queue the bound leases and write all pending ones from a single
+ * timeout. A client with a pending lease writes it right away when it
+ * stops, so the file is current when the next client starts. */
+
+#define LEASE_SAVE_DELAY_MSEC 1000
+
+static CList _lease_save_lst_head = C_LIST_INIT (_lease_save_lst_head);
+static guint _lease_save_id;
+
+static void
+_lease_save_flush (NMDhcpSystemd *self)
+{
+	NMDhcpSystemdPrivate *priv = NM_DHCP_SYSTEMD_GET_PRIVATE (self);
+	nm_auto (sd_dhcp_lease_unrefp) sd_dhcp_lease *lease = g_steal_pointer (&priv->lease_save);
+
+	if (!lease)
+		return;
+
+	c_list_unlink (&priv->lease_save_lst);
+	if (c_list_is_empty (&_lease_save_lst_head))
+		nm_clear_g_source (&_lease_save_id);
+
+	dhcp_lease_save (lease, priv->lease_file);
+}
+
+static gboolean
+_lease_save_cb (gpointer user_data)
+{
+	NMDhcpSystemd *self;
+
+	_lease_save_id = 0;
+
+	while ((self = c_list_first_entry (&_lease_save_lst_head, NMDhcpSystemd, _priv.lease_save_lst)))
+		_lease_save_flush (self);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_lease_save_queue (NMDhcpSystemd *self, sd_dhcp_lease *lease)
+{
+	NMDhcpSystemdPrivate *priv = NM_DHCP_SYSTEMD_GET_PRIVATE (self);
+
+	sd_dhcp_lease_ref (lease);
+	if (priv->lease_save)
+		sd_dhcp_lease_unref (priv->lease_save);
+	else
+		c_list_link_tail (&_lease_save_lst_head, &priv->lease_save_lst);
+	priv->lease_save = lease;
+
+	if (!_lease_save_id)
+		_lease_save_id = g_timeout_add (LEASE_SAVE_DELAY_MSEC, _lease_save_cb, NULL);
+}
+
+/*****************************************************************************/
+
 static GHashTable *
 create_options_dict (void)
 {
@@ -628,7 +693,7 @@ bound4_handle (NMDhcpSystemd *self)
 	}
 
 	add_requests_to_options (options, dhcp4_requests);
-	dhcp_lease_save (lease, priv->lease_file);
+	_lease_save_queue (self, lease);
 
 	nm_dhcp_client_set_state (NM_DHCP_CLIENT (self),
 	                          NM_DHCP_STATE_BOUND,
@@ -664,6 +729,27 @@ dhcp_event_cb (sd_dhcp_client *client, int event, gpointer user_data)
 	}
 }
 
+/* The lease file is rewritten whenever a lease gets bound, so its
+ * modification time tells when the lease was obtained. If the lease
+ * expired since then, requesting its address in INIT-REBOOT only
+ * delays getting a new one: the server may silently ignore the
+ * request and we would wait for the retransmissions to time out. */
+static gboolean
+_lease_file_expired (sd_dhcp_lease *lease, const char *lease_file)
+{
+	struct stat st;
+	uint32_t lifetime;
+
+	if (sd_dhcp_lease_get_lifetime (lease, &lifetime) < 0)
+		return FALSE;
+	if (lifetime == 0xffffffffu)
+		return FALSE;
+	if (stat (lease_file, &st) != 0)
+		return FALSE;
+
+	return (gint64) st.st_mtime + lifetime <= (gint64) time (NULL);
+}
+
 static gboolean
 ip4_start (NMDhcpClient *client,
            const char *dhcp_anycast_addr,
@@ -736,8 +822,12 @@ ip4_start (NMDhcpClient *client,
 		nm_auto (sd_dhcp_lease_unrefp) sd_dhcp_lease *lease = NULL;
 
 		dhcp_lease_load (&lease, lease_file);
-		if (lease)
-			sd_dhcp_lease_get_address (lease, &last_addr);
+		if (lease) {
+			if (_lease_file_expired (lease, lease_file))
+				_LOGD ("saved lease already expired, start with DISCOVER");
+			else
+				sd_dhcp_lease_get_address (lease, &last_addr);
+		}
 	}
 
 	if (last_addr.s_addr) {
@@ -797,6 +887,15 @@ ip4_start (NMDhcpClient *client,
 		}
 	}
 
+	if (nm_dhcp_client_get_renewal_jitter (client)) {
+		r = sd_dhcp_client_set_renewal_jitter (sd_client,
+		                                       nm_dhcp_client_get_renewal_jitter (client));
+		if (r < 0) {
+			nm_utils_error_set_errno (error, r, "failed to set renewal jitter: %s");
+			return FALSE;
+		}
+	}
+
 	r = sd_dhcp_client_set_callback (sd_client, dhcp_event_cb, client);
 	if (r < 0) {
 		nm_utils_error_set_errno (error, r, "failed to set callback: %s");
@@ -1124,6 +1223,8 @@ stop (NMDhcpClient *client, gboolean release)
 
 	NM_DHCP_CLIENT_CLASS (nm_dhcp_systemd_parent_class)->stop (client, release);
 
+	_lease_save_flush (self);
+
 	_LOGT ("dhcp-client%d: stop %p",
 	       priv->client4 ? '4' : '6',
 	       priv->client4 ? (gpointer) priv->client4 : (gpointer) priv->client6);
@@ -1145,6 +1246,9 @@ stop (NMDhcpClient *client, gboolean release)
 static void
 nm_dhcp_systemd_init (NMDhcpSystemd *self)
 {
+	NMDhcpSystemdPrivate *priv = NM_DHCP_SYSTEMD_GET_PRIVATE (self);
+
+	c_list_init (&priv->lease_save_lst);
 }
 
 static void
@@ -1152,6 +1256,7 @@ dispose (GObject *object)
 {
 	NMDhcpSystemdPrivate *priv = NM_DHCP_SYSTEMD_GET_PRIVATE ((NMDhcpSystemd *) object);
 
+	_lease_save_flush ((NMDhcpSystemd *) object);
 	g_clear_pointer (&priv->lease_file, g_free);
 
 	if (priv->client4) {
@@ -27,6 +27,8 @@
 #include "nm-utils.h"
 
 #include "dhcp/nm-dhcp-utils.h"
+#include "dhcp/nm-dhcp-listener.h"
+#include "dhcp/nm-dhcp-helper-api.h"
 #include "platform/nm-platform.h"
 
 #include "nm-test-utils-core.h"
@@ -719,6 +721,165 @@ test_client_id_from_string (void)
 	COMPARE_ID (endcolon, TRUE, endcolon, strlen (endcolon));
 }
 
+/*****************************************************************************/
+
+static GByteArray *
+_event_new (void)
+{
+	GByteArray *event;
+
+	event = g_byte_array_new ();
+	g_byte_array_append (event, (const guint8 *) NM_DHCP_HELPER_EVENT_MAGIC, NM_DHCP_HELPER_EVENT_MAGIC_LEN);
+	return event;
+}
+
+static void
+_event_add (GByteArray *event,
+            const char *name, guint16 name_len,
+            const char *value, guint16 val_len)
+{
+	g_byte_array_append (event, (const guint8 *) &name_len, sizeof (name_len));
+	g_byte_array_append (event, (const guint8 *) &val_len, sizeof (val_len));
+	g_byte_array_append (event, (const guint8 *) name, name_len);
+	g_byte_array_append (event, (const guint8 *) value, val_len);
+}
+
+static void
+_event_assert_value (GVariant *options, const char *name, const char *value, gsize val_len)
+{
+	gs_unref_variant GVariant *v = NULL;
+	const guint8 *data;
+	gsize len;
+
+	v = g_variant_lookup_value (options, name, G_VARIANT_TYPE_BYTESTRING);
+	g_assert (v);
+	data = g_variant_get_fixed_array (v, &len, 1);
+	g_assert_cmpint (len, ==, val_len);
+	g_assert (memcmp (data, value, val_len) == 0);
+}
+
+static void
+test_event_parse (void)
+{
+	gs_unref_variant GVariant *options = NULL;
+	GByteArray *event;
+
+	/* no variables at all is fine. */
+	event = _event_new ();
+	options = _nmtst_dhcp_listener_event_parse (event->data, event->len);
+	g_assert (options);
+	g_assert_cmpint (g_variant_n_children (options), ==, 0);
+	g_clear_pointer (&options, g_variant_unref);
+
+	_event_add (event, "reason", 6, "BOUND", 5);
+	_event_add (event, "new_ip_address", 14, "192.0.2.5", 9);
+	_event_add (event, "empty", 5, "", 0);
+	options = _nmtst_dhcp_listener_event_parse (event->data, event->len);
+	g_assert (options);
+	g_assert_cmpint (g_variant_n_children (options), ==, 3);
+	_event_assert_value (options, "reason", "BOUND", 5);
+	_event_assert_value (options, "new_ip_address", "192.0.2.5", 9);
+	_event_assert_value (options, "empty", "", 0);
+	g_clear_pointer (&options, g_variant_unref);
+
+	/* too short for the magic, or a wrong one. */
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, NM_DHCP_HELPER_EVENT_MAGIC_LEN - 1));
+	event->data[0] = 'X';
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+
+	/* a value can contain NUL bytes, it is passed on as is. */
+	event = _event_new ();
+	_event_add (event, "vendor", 6, "a\0b", 3);
+	options = _nmtst_dhcp_listener_event_parse (event->data, event->len);
+	g_assert (options);
+	_event_assert_value (options, "vendor", "a\0b", 3);
+	g_clear_pointer (&options, g_variant_unref);
+	g_byte_array_unref (event);
+}
+
+static void
+test_event_parse_invalid (void)
+{
+	GByteArray *event;
+	guint i;
+
+	/* truncated within the lengths of a record. */
+	event = _event_new ();
+	_event_add (event, "reason", 6, "BOUND", 5);
+	for (i = NM_DHCP_HELPER_EVENT_MAGIC_LEN + 1; i < event->len; i++)
+		g_assert (!_nmtst_dhcp_listener_event_parse (event->data, i));
+	g_byte_array_unref (event);
+
+	/* a value that is longer than the rest of the datagram. */
+	event = _event_new ();
+	_event_add (event, "reason", 6, "BOUND", 5);
+	g_byte_array_set_size (event, event->len - 1);
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+
+	/* zero-length names. */
+	event = _event_new ();
+	_event_add (event, "", 0, "BOUND", 5);
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+
+	event = _event_new ();
+	_event_add (event, "", 0, "", 0);
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+
+	/* a NUL byte in the name. */
+	event = _event_new ();
+	_event_add (event, "rea\0son", 7, "BOUND", 5);
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+
+	/* a name that is not UTF-8. */
+	event = _event_new ();
+	_event_add (event, "\xff", 1, "BOUND", 5);
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+}
+
+static void
+test_event_parse_max_size (void)
+{
+	gs_unref_variant GVariant *options = NULL;
+	gs_free char *value = NULL;
+	GByteArray *event;
+	gsize val_len;
+	guint16 l;
+
+	/* a single record that fills a datagram of the maximum size. */
+	val_len = NM_DHCP_HELPER_EVENT_MAX_SIZE - NM_DHCP_HELPER_EVENT_MAGIC_LEN - 4 - 1;
+	g_assert_cmpint (val_len, <=, G_MAXUINT16);
+	value = g_malloc (val_len);
+	memset (value, 'v', val_len);
+
+	event = _event_new ();
+	_event_add (event, "x", 1, value, val_len);
+	g_assert_cmpint (event->len, ==, NM_DHCP_HELPER_EVENT_MAX_SIZE);
+
+	options = _nmtst_dhcp_listener_event_parse (event->data, event->len);
+	g_assert (options);
+	_event_assert_value (options, "x", value, val_len);
+
+	/* one byte less is truncated. */
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len - 1));
+	g_byte_array_unref (event);
+
+	/* the largest length the record can announce, with the value missing. */
+	event = _event_new ();
+	_event_add (event, "x", 1, value, 0);
+	l = G_MAXUINT16;
+	memcpy (&event->data[NM_DHCP_HELPER_EVENT_MAGIC_LEN + 2], &l, sizeof (l));
+	g_assert (!_nmtst_dhcp_listener_event_parse (event->data, event->len));
+	g_byte_array_unref (event);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -746,6 +907,9 @@ int main (int argc, char **argv)
 	g_test_add_func ("/dhcp/ip4-prefix-classless", test_ip4_prefix_classless);
 	g_test_add_func ("/dhcp/client-id-from-string", test_client_id_from_string);
 	g_test_add_func ("/dhcp/vendor-option-metered", test_vendor_option_metered);
+	g_test_add_func ("/dhcp/event-parse", test_event_parse);
+	g_test_add_func ("/dhcp/event-parse-invalid", test_event_parse_invalid);
+	g_test_add_func ("/dhcp/event-parse-max-size", test_event_parse_max_size);
 
 	return g_test_run ();
 }
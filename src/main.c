@@ -397,7 +397,11 @@ main (int argc, char *argv[])
 	nm_auth_manager_setup (nm_config_data_get_value_boolean (nm_config_get_data_orig (config),
 	                                                         NM_CONFIG_KEYFILE_GROUP_MAIN,
 	                                                         NM_CONFIG_KEYFILE_KEY_MAIN_AUTH_POLKIT,
-	                                                         NM_CONFIG_DEFAULT_MAIN_AUTH_POLKIT_BOOL));
+	                                                         NM_CONFIG_DEFAULT_MAIN_AUTH_POLKIT_BOOL),
+	                       nm_config_data_get_value_int64 (nm_config_get_data_orig (config),
+	                                                       NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                                       NM_CONFIG_KEYFILE_KEY_MAIN_AUTH_POLKIT_CACHE_TTL,
+	                                                       10, 0, G_MAXUINT32, 0));
 
 	if (!nm_config_get_configure_and_quit (config)) {
 		/* D-Bus is useless in configure and quit mode -- we're eventually dropping
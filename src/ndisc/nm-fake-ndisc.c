@@ -240,10 +240,9 @@ send_rs (NMNDisc *ndisc, GError **error)
 	return TRUE;
 }
 
-static gboolean
-receive_ra (gpointer user_data)
+static void
+receive_one_ra (NMFakeNDisc *self)
 {
-	NMFakeNDisc *self = user_data;
 	NMFakeNDiscPrivate *priv = NM_FAKE_NDISC_GET_PRIVATE (self);
 	NMNDisc *ndisc = NM_NDISC (self);
 	NMNDiscDataInternal *rdata = ndisc->rdata;
@@ -253,8 +252,6 @@ receive_ra (gpointer user_data)
 	guint i;
 	NMNDiscDHCPLevel dhcp_level;
 
-	priv->receive_ra_id = 0;
-
 	/* preserve the "most managed" level  on updates. */
 	dhcp_level = MAX (rdata->public.dhcp_level, ra->dhcp_level);
 
@@ -328,6 +325,18 @@ receive_ra (gpointer user_data)
 	fake_ra_free (ra);
 
 	nm_ndisc_ra_received (NM_NDISC (self), now, changed);
+}
+
+static gboolean
+receive_ra (gpointer user_data)
+{
+	NMFakeNDisc *self = user_data;
+	NMFakeNDiscPrivate *priv = NM_FAKE_NDISC_GET_PRIVATE (self);
+	FakeRa *ra;
+
+	priv->receive_ra_id = 0;
+
+	receive_one_ra (self);
 
 	/* Schedule next RA */
 	if (priv->ras) {
@@ -338,6 +347,27 @@ receive_ra (gpointer user_data)
 	return G_SOURCE_REMOVE;
 }
 
+/**
+ * nm_fake_ndisc_receive_next_ra:
+ * @self: the #NMFakeNDisc
+ *
+ * Processes the first queued RA right away, regardless of its delay and
+ * without a main loop. Benchmarks use this to replay many RAs in a row.
+ *
+ * Returns: %FALSE if there was no RA queued.
+ */
+gboolean
+nm_fake_ndisc_receive_next_ra (NMFakeNDisc *self)
+{
+	NMFakeNDiscPrivate *priv = NM_FAKE_NDISC_GET_PRIVATE (self);
+
+	nm_clear_g_source (&priv->receive_ra_id);
+	if (!priv->ras)
+		return FALSE;
+	receive_one_ra (self);
+	return TRUE;
+}
+
 static void
 start (NMNDisc *ndisc)
 {
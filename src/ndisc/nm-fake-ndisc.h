@@ -76,6 +76,8 @@ void nm_fake_ndisc_add_dns_domain (NMFakeNDisc *self,
 
 void nm_fake_ndisc_emit_new_ras (NMFakeNDisc *self);
 
+gboolean nm_fake_ndisc_receive_next_ra (NMFakeNDisc *self);
+
 gboolean nm_fake_ndisc_done (NMFakeNDisc *self);
 
 #endif /* __NETWORKMANAGER_FAKE_NDISC_H__ */
@@ -54,6 +54,7 @@ struct _NMNDiscPrivate {
 	};
 	guint ra_timeout_id;  /* first RA timeout */
 	guint timeout_id;   /* prefix/dns/etc lifetime timeout */
+	gint32 timeout_expiry;
 	char *last_error;
 	NMUtilsIPv6IfaceId iid;
 
@@ -70,6 +71,10 @@ struct _NMNDiscPrivate {
 
 	NMPlatform *platform;
 	NMPNetns *netns;
+
+	/* the distinct finite expiry times of the items in rdata. */
+	GHashTable *expiry_idx;
+	GPtrArray *expiry_heap;
 };
 
 typedef struct _NMNDiscPrivate NMNDiscPrivate;
@@ -196,6 +201,199 @@ _get_exp (char *buf, gsize buf_size, gint64 now_ns, gint64 expiry_time)
 
 /*****************************************************************************/
 
+/* All items in rdata expire at some point, and DNS items also want a
+ * refresh at half of their lifetime. Instead of scanning all lists for
+ * the next event on every RA, keep the distinct finite expiry times per
+ * kind in a min-heap. An entry counts the items that share its time,
+ * so updating an item costs O(log n) and the top of the heap is the
+ * exact next event. The lists are only scanned when something in them
+ * actually expires. */
+
+typedef enum {
+	EXPIRY_KIND_GATEWAY,
+	EXPIRY_KIND_ADDRESS,
+	EXPIRY_KIND_ROUTE,
+	EXPIRY_KIND_DNS_SERVER,
+	EXPIRY_KIND_DNS_SERVER_REFRESH,
+	EXPIRY_KIND_DNS_DOMAIN,
+	EXPIRY_KIND_DNS_DOMAIN_REFRESH,
+} ExpiryKind;
+
+typedef struct {
+	gint64 expiry;
+	ExpiryKind kind;
+	guint ref_count;
+
+	/* the position in expiry_heap. G_MAXUINT for a refresh that
+	 * already fired. */
+	guint heap_idx;
+} ExpiryEntry;
+
+static guint
+_expiry_entry_hash (gconstpointer ptr)
+{
+	const ExpiryEntry *e = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1771384501);
+	nm_hash_update_vals (&h, e->expiry, e->kind);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_expiry_entry_equal (gconstpointer pa, gconstpointer pb)
+{
+	const ExpiryEntry *a = pa;
+	const ExpiryEntry *b = pb;
+
+	return    a->expiry == b->expiry
+	       && a->kind == b->kind;
+}
+
+static void
+_expiry_entry_free (gpointer ptr)
+{
+	g_slice_free (ExpiryEntry, ptr);
+}
+
+#define _heap_at(heap, idx) ((ExpiryEntry *) ((heap)->pdata[(idx)]))
+
+static void
+_heap_set (GPtrArray *heap, guint idx, ExpiryEntry *e)
+{
+	heap->pdata[idx] = e;
+	e->heap_idx = idx;
+}
+
+static void
+_heap_sift_up (GPtrArray *heap, guint idx)
+{
+	ExpiryEntry *e = _heap_at (heap, idx);
+
+	while (idx > 0) {
+		guint parent = (idx - 1) / 2;
+
+		if (_heap_at (heap, parent)->expiry <= e->expiry)
+			break;
+		_heap_set (heap, idx, _heap_at (heap, parent));
+		idx = parent;
+	}
+	_heap_set (heap, idx, e);
+}
+
+static void
+_heap_sift_down (GPtrArray *heap, guint idx)
+{
+	ExpiryEntry *e = _heap_at (heap, idx);
+
+	for (;;) {
+		guint child = 2 * idx + 1;
+
+		if (child >= heap->len)
+			break;
+		if (   child + 1 < heap->len
+		    && _heap_at (heap, child + 1)->expiry < _heap_at (heap, child)->expiry)
+			child++;
+		if (e->expiry <= _heap_at (heap, child)->expiry)
+			break;
+		_heap_set (heap, idx, _heap_at (heap, child));
+		idx = child;
+	}
+	_heap_set (heap, idx, e);
+}
+
+static void
+_heap_remove (GPtrArray *heap, ExpiryEntry *e)
+{
+	guint idx = e->heap_idx;
+	ExpiryEntry *last;
+
+	nm_assert (idx < heap->len && _heap_at (heap, idx) == e);
+
+	last = g_ptr_array_remove_index (heap, heap->len - 1);
+	e->heap_idx = G_MAXUINT;
+	if (last == e)
+		return;
+
+	_heap_set (heap, idx, last);
+	_heap_sift_up (heap, idx);
+	_heap_sift_down (heap, last->heap_idx);
+}
+
+static void
+_expiry_track (NMNDiscPrivate *priv, ExpiryKind kind, gint64 expiry, gboolean add)
+{
+	ExpiryEntry needle = {
+		.expiry = expiry,
+		.kind = kind,
+	};
+	ExpiryEntry *e;
+
+	if (expiry == _EXPIRY_INFINITY)
+		return;
+
+	e = g_hash_table_lookup (priv->expiry_idx, &needle);
+
+	if (add) {
+		if (!e) {
+			e = g_slice_new (ExpiryEntry);
+			*e = needle;
+			e->ref_count = 0;
+			g_hash_table_add (priv->expiry_idx, e);
+			g_ptr_array_add (priv->expiry_heap, e);
+			_heap_sift_up (priv->expiry_heap, priv->expiry_heap->len - 1);
+		}
+		/* an item that joins a refresh which already fired does not
+		 * re-arm it. The refresh fires once for its time. */
+		e->ref_count++;
+		return;
+	}
+
+	if (!e || e->ref_count == 0)
+		g_return_if_reached ();
+
+	if (--e->ref_count > 0)
+		return;
+
+	if (e->heap_idx != G_MAXUINT)
+		_heap_remove (priv->expiry_heap, e);
+	g_hash_table_remove (priv->expiry_idx, e);
+}
+
+static void
+_track_gateway (NMNDiscPrivate *priv, const NMNDiscGateway *item, gboolean add)
+{
+	_expiry_track (priv, EXPIRY_KIND_GATEWAY, get_expiry (item), add);
+}
+
+static void
+_track_address (NMNDiscPrivate *priv, const NMNDiscAddress *item, gboolean add)
+{
+	_expiry_track (priv, EXPIRY_KIND_ADDRESS, get_expiry (item), add);
+}
+
+static void
+_track_route (NMNDiscPrivate *priv, const NMNDiscRoute *item, gboolean add)
+{
+	_expiry_track (priv, EXPIRY_KIND_ROUTE, get_expiry (item), add);
+}
+
+static void
+_track_dns_server (NMNDiscPrivate *priv, const NMNDiscDNSServer *item, gboolean add)
+{
+	_expiry_track (priv, EXPIRY_KIND_DNS_SERVER, get_expiry (item), add);
+	_expiry_track (priv, EXPIRY_KIND_DNS_SERVER_REFRESH, get_expiry_half (item), add);
+}
+
+static void
+_track_dns_domain (NMNDiscPrivate *priv, const NMNDiscDNSDomain *item, gboolean add)
+{
+	_expiry_track (priv, EXPIRY_KIND_DNS_DOMAIN, get_expiry (item), add);
+	_expiry_track (priv, EXPIRY_KIND_DNS_DOMAIN_REFRESH, get_expiry_half (item), add);
+}
+
+/*****************************************************************************/
+
 NMPNetns *
 nm_ndisc_netns_get (NMNDisc *self)
 {
@@ -317,7 +515,8 @@ nm_ndisc_emit_config_change (NMNDisc *self, NMNDiscConfigMap changed)
 gboolean
 nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 {
-	NMNDiscDataInternal *rdata = &NM_NDISC_GET_PRIVATE(ndisc)->rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 	guint insert_idx = G_MAXUINT;
 
@@ -326,12 +525,14 @@ nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 
 		if (IN6_ARE_ADDR_EQUAL (&item->address, &new->address)) {
 			if (new->lifetime == 0) {
+				_track_gateway (priv, item, FALSE);
 				g_array_remove_index (rdata->gateways, i);
 				_ASSERT_data_gateways (rdata);
 				return TRUE;
 			}
 
 			if (item->preference != new->preference) {
+				_track_gateway (priv, item, FALSE);
 				g_array_remove_index (rdata->gateways, i);
 				continue;
 			}
@@ -339,7 +540,9 @@ nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 			if (get_expiry (item) == get_expiry (new))
 				return FALSE;
 
+			_track_gateway (priv, item, FALSE);
 			*item = *new;
+			_track_gateway (priv, item, TRUE);
 			_ASSERT_data_gateways (rdata);
 			return TRUE;
 		}
@@ -358,6 +561,7 @@ nm_ndisc_add_gateway (NMNDisc *ndisc, const NMNDiscGateway *new)
 		                      ? rdata->gateways->len
 		                      : insert_idx,
 		                    *new);
+		_track_gateway (priv, new, TRUE);
 	}
 	_ASSERT_data_gateways (rdata);
 	return !!new->lifetime;
@@ -462,6 +666,8 @@ nm_ndisc_add_address (NMNDisc *ndisc,
 			old_expiry_lifetime = get_expiry (existing);
 			old_expiry_preferred = get_expiry_preferred (existing);
 
+			_track_address (priv, existing, FALSE);
+
 			if (new->lifetime == NM_NDISC_INFINITY)
 				existing->lifetime = NM_NDISC_INFINITY;
 			else {
@@ -496,11 +702,14 @@ nm_ndisc_add_address (NMNDisc *ndisc,
 					existing->preferred = MIN (existing->preferred, existing->lifetime);
 			}
 
+			_track_address (priv, existing, TRUE);
+
 			return    old_expiry_lifetime != get_expiry (existing)
 			       || old_expiry_preferred != get_expiry_preferred (existing);
 		}
 
 		if (new->lifetime == 0) {
+			_track_address (priv, existing, FALSE);
 			g_array_remove_index (rdata->addresses, i);
 			return TRUE;
 		}
@@ -509,9 +718,11 @@ nm_ndisc_add_address (NMNDisc *ndisc,
 		    && get_expiry_preferred (existing) == get_expiry_preferred (new))
 			return FALSE;
 
+		_track_address (priv, existing, FALSE);
 		existing->timestamp = new->timestamp;
 		existing->lifetime = new->lifetime;
 		existing->preferred = new->preferred;
+		_track_address (priv, existing, TRUE);
 		return TRUE;
 	}
 
@@ -535,6 +746,7 @@ nm_ndisc_add_address (NMNDisc *ndisc,
 	}
 
 	g_array_append_val (rdata->addresses, *new);
+	_track_address (priv, new, TRUE);
 	return TRUE;
 }
 
@@ -574,11 +786,13 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 		if (   IN6_ARE_ADDR_EQUAL (&item->network, &new->network)
 		    && item->plen == new->plen) {
 			if (new->lifetime == 0) {
+				_track_route (priv, item, FALSE);
 				g_array_remove_index (rdata->routes, i);
 				return TRUE;
 			}
 
 			if (item->preference != new->preference) {
+				_track_route (priv, item, FALSE);
 				g_array_remove_index (rdata->routes, i);
 				continue;
 			}
@@ -587,7 +801,9 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 			    && IN6_ARE_ADDR_EQUAL (&item->gateway, &new->gateway))
 				return FALSE;
 
+			_track_route (priv, item, FALSE);
 			*item = *new;
+			_track_route (priv, item, TRUE);
 			return TRUE;
 		}
 
@@ -605,6 +821,7 @@ nm_ndisc_add_route (NMNDisc *ndisc, const NMNDiscRoute *new)
 		                      ? 0u
 		                      : insert_idx,
 		                    *new);
+		_track_route (priv, new, TRUE);
 	}
 	return !!new->lifetime;
 }
@@ -624,6 +841,7 @@ nm_ndisc_add_dns_server (NMNDisc *ndisc, const NMNDiscDNSServer *new)
 
 		if (IN6_ARE_ADDR_EQUAL (&item->address, &new->address)) {
 			if (new->lifetime == 0) {
+				_track_dns_server (priv, item, FALSE);
 				g_array_remove_index (rdata->dns_servers, i);
 				return TRUE;
 			}
@@ -631,13 +849,17 @@ nm_ndisc_add_dns_server (NMNDisc *ndisc, const NMNDiscDNSServer *new)
 			if (get_expiry (item) == get_expiry (new))
 				return FALSE;
 
+			_track_dns_server (priv, item, FALSE);
 			*item = *new;
+			_track_dns_server (priv, item, TRUE);
 			return TRUE;
 		}
 	}
 
-	if (new->lifetime)
+	if (new->lifetime) {
 		g_array_append_val (rdata->dns_servers, *new);
+		_track_dns_server (priv, new, TRUE);
+	}
 	return !!new->lifetime;
 }
 
@@ -658,6 +880,7 @@ nm_ndisc_add_dns_domain (NMNDisc *ndisc, const NMNDiscDNSDomain *new)
 
 		if (!g_strcmp0 (item->domain, new->domain)) {
 			if (new->lifetime == 0) {
+				_track_dns_domain (priv, item, FALSE);
 				g_array_remove_index (rdata->dns_domains, i);
 				return TRUE;
 			}
@@ -665,8 +888,10 @@ nm_ndisc_add_dns_domain (NMNDisc *ndisc, const NMNDiscDNSDomain *new)
 			if (get_expiry (item) == get_expiry (new))
 				return FALSE;
 
+			_track_dns_domain (priv, item, FALSE);
 			item->timestamp = new->timestamp;
 			item->lifetime = new->lifetime;
+			_track_dns_domain (priv, item, TRUE);
 			return TRUE;
 		}
 	}
@@ -677,6 +902,7 @@ nm_ndisc_add_dns_domain (NMNDisc *ndisc, const NMNDiscDNSDomain *new)
 		                       NMNDiscDNSDomain,
 		                       rdata->dns_domains->len - 1);
 		item->domain = g_strdup (new->domain);
+		_track_dns_domain (priv, item, TRUE);
 	}
 	return !!new->lifetime;
 }
@@ -831,6 +1057,128 @@ announce_router_solicited (NMNDisc *ndisc)
 
 /*****************************************************************************/
 
+/**
+ * nm_ndisc_data_get_shape:
+ * @rdata: the RA data
+ *
+ * Returns: a hash of @rdata that ignores all timestamps and lifetimes. When
+ *   it stays the same across a change, the router only refreshed the
+ *   lifetimes of what it announced before. It is never zero.
+ */
+guint64
+nm_ndisc_data_get_shape (const NMNDiscData *rdata)
+{
+	NMHashState h;
+	guint i;
+
+	nm_hash_init (&h, 1917339661u);
+	nm_hash_update_vals (&h,
+	                     rdata->gateways_n,
+	                     rdata->addresses_n,
+	                     rdata->routes_n,
+	                     rdata->dns_servers_n,
+	                     rdata->dns_domains_n);
+	for (i = 0; i < rdata->gateways_n; i++) {
+		nm_hash_update_in6addr (&h, &rdata->gateways[i].address);
+		nm_hash_update_val (&h, rdata->gateways[i].preference);
+	}
+	for (i = 0; i < rdata->addresses_n; i++)
+		nm_hash_update_in6addr (&h, &rdata->addresses[i].address);
+	for (i = 0; i < rdata->routes_n; i++) {
+		nm_hash_update_in6addr (&h, &rdata->routes[i].network);
+		nm_hash_update_in6addr (&h, &rdata->routes[i].gateway);
+		nm_hash_update_vals (&h,
+		                     rdata->routes[i].plen,
+		                     rdata->routes[i].preference);
+	}
+	for (i = 0; i < rdata->dns_servers_n; i++)
+		nm_hash_update_in6addr (&h, &rdata->dns_servers[i].address);
+	for (i = 0; i < rdata->dns_domains_n; i++)
+		nm_hash_update_str0 (&h, rdata->dns_domains[i].domain);
+	return nm_hash_complete_u64 (&h) ?: 1;
+}
+
+/**
+ * nm_ndisc_rebuild_check:
+ * @rebuild: the rebuild state of the caller
+ * @rdata: the RA data after the change
+ * @changed: what changed
+ * @configured: whether the caller finished the IPv6 configuration based
+ *   on earlier RA data
+ * @out_lifetimes_only: (out): whether the change only refreshed lifetimes
+ *
+ * Routers re-announce the same information periodically and only extend
+ * its lifetimes. In that case, the caller only needs to refresh the
+ * lifetimes of the addresses, and can postpone rebuilding the whole IPv6
+ * configuration with nm_ndisc_rebuild_postpone().
+ *
+ * Returns: the part of @changed that the caller must apply now. If
+ *   @out_lifetimes_only is set, that is at most %NM_NDISC_CONFIG_ADDRESSES.
+ *   Otherwise, it is @changed and a postponed rebuild is canceled, because
+ *   the caller rebuilds the configuration right away.
+ */
+NMNDiscConfigMap
+nm_ndisc_rebuild_check (NMNDiscRebuild *rebuild,
+                        const NMNDiscData *rdata,
+                        NMNDiscConfigMap changed,
+                        gboolean configured,
+                        gboolean *out_lifetimes_only)
+{
+	guint64 shape;
+
+	nm_assert (rebuild);
+	nm_assert (rdata);
+	nm_assert (out_lifetimes_only);
+
+	shape = nm_ndisc_data_get_shape (rdata);
+	if (   rebuild->shape == shape
+	    && configured
+	    && nm_ndisc_config_map_is_lifetime_update (changed)) {
+		*out_lifetimes_only = TRUE;
+		return changed & NM_NDISC_CONFIG_ADDRESSES;
+	}
+
+	rebuild->shape = shape;
+	nm_clear_g_source (&rebuild->timeout_id);
+	*out_lifetimes_only = FALSE;
+	return changed;
+}
+
+/**
+ * nm_ndisc_rebuild_postpone:
+ * @rebuild: the rebuild state of the caller
+ * @delay_sec: the delay of the rebuild
+ * @func: the function that rebuilds the configuration. It must reset
+ *   @rebuild's timeout_id to zero.
+ * @user_data: the argument for @func
+ *
+ * Counts a rebuild that was avoided and schedules @func in @delay_sec seconds,
+ * unless it is already scheduled. Later refreshes don't move the scheduled
+ * rebuild, so the configuration is rebuilt at least every @delay_sec seconds.
+ */
+void
+nm_ndisc_rebuild_postpone (NMNDiscRebuild *rebuild,
+                           guint delay_sec,
+                           GSourceFunc func,
+                           gpointer user_data)
+{
+	nm_assert (rebuild);
+	nm_assert (func);
+
+	rebuild->avoided++;
+	if (!rebuild->timeout_id)
+		rebuild->timeout_id = g_timeout_add_seconds (delay_sec, func, user_data);
+}
+
+void
+nm_ndisc_rebuild_reset (NMNDiscRebuild *rebuild)
+{
+	nm_clear_g_source (&rebuild->timeout_id);
+	rebuild->shape = 0;
+}
+
+/*****************************************************************************/
+
 void
 nm_ndisc_set_config (NMNDisc *ndisc,
                      const GArray *addresses,
@@ -896,7 +1244,11 @@ nm_ndisc_set_iid (NMNDisc *ndisc, const NMUtilsIPv6IfaceId iid)
 			return FALSE;
 
 		if (rdata->addresses->len) {
+			guint i;
+
 			_LOGD ("IPv6 interface identifier changed, flushing addresses");
+			for (i = 0; i < rdata->addresses->len; i++)
+				_track_address (priv, &g_array_index (rdata->addresses, NMNDiscAddress, i), FALSE);
 			g_array_remove_range (rdata->addresses, 0, rdata->addresses->len);
 			nm_ndisc_emit_config_change (ndisc, NM_NDISC_CONFIG_ADDRESSES);
 			solicit_routers (ndisc);
@@ -954,12 +1306,11 @@ nm_ndisc_start (NMNDisc *ndisc)
 NMNDiscConfigMap
 nm_ndisc_dad_failed (NMNDisc *ndisc, const struct in6_addr *address, gboolean emit_changed_signal)
 {
-	NMNDiscDataInternal *rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 	gboolean changed = FALSE;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
 	for (i = 0; i < rdata->addresses->len; ) {
 		NMNDiscAddress *item = &g_array_index (rdata->addresses, NMNDiscAddress, i);
 
@@ -969,6 +1320,7 @@ nm_ndisc_dad_failed (NMNDisc *ndisc, const struct in6_addr *address, gboolean em
 			_LOGD ("DAD failed for discovered address %s", nm_utils_inet6_ntop (address, sbuf));
 			changed = TRUE;
 			if (!complete_address (ndisc, item)) {
+				_track_address (priv, item, FALSE);
 				g_array_remove_index (rdata->addresses, i);
 				continue;
 			}
@@ -1081,17 +1433,17 @@ _config_changed_log (NMNDisc *ndisc, NMNDiscConfigMap changed)
 }
 
 static void
-clean_gateways (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
+clean_gateways (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed)
 {
-	NMNDiscDataInternal *rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
 	for (i = 0; i < rdata->gateways->len; ) {
 		NMNDiscGateway *item = &g_array_index (rdata->gateways, NMNDiscGateway, i);
 
-		if (!expiry_next (now, get_expiry (item), nextevent)) {
+		if (!expiry_next (now, get_expiry (item), NULL)) {
+			_track_gateway (priv, item, FALSE);
 			g_array_remove_index (rdata->gateways, i);
 			*changed |= NM_NDISC_CONFIG_GATEWAYS;
 			continue;
@@ -1104,17 +1456,17 @@ clean_gateways (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *n
 }
 
 static void
-clean_addresses (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
+clean_addresses (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed)
 {
-	NMNDiscDataInternal *rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
 	for (i = 0; i < rdata->addresses->len; ) {
 		const NMNDiscAddress *item = &g_array_index (rdata->addresses, NMNDiscAddress, i);
 
-		if (!expiry_next (now, get_expiry (item), nextevent)) {
+		if (!expiry_next (now, get_expiry (item), NULL)) {
+			_track_address (priv, item, FALSE);
 			g_array_remove_index (rdata->addresses, i);
 			*changed |= NM_NDISC_CONFIG_ADDRESSES;
 			continue;
@@ -1125,17 +1477,17 @@ clean_addresses (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *
 }
 
 static void
-clean_routes (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
+clean_routes (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed)
 {
-	NMNDiscDataInternal *rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
 	for (i = 0; i < rdata->routes->len; ) {
 		NMNDiscRoute *item = &g_array_index (rdata->routes, NMNDiscRoute, i);
 
-		if (!expiry_next (now, get_expiry (item), nextevent)) {
+		if (!expiry_next (now, get_expiry (item), NULL)) {
+			_track_route (priv, item, FALSE);
 			g_array_remove_index (rdata->routes, i);
 			*changed |= NM_NDISC_CONFIG_ROUTES;
 			continue;
@@ -1146,59 +1498,43 @@ clean_routes (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nex
 }
 
 static void
-clean_dns_servers (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
+clean_dns_servers (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed)
 {
-	NMNDiscDataInternal *rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
 	for (i = 0; i < rdata->dns_servers->len; ) {
 		NMNDiscDNSServer *item = &g_array_index (rdata->dns_servers, NMNDiscDNSServer, i);
-		gint64 refresh;
-
-		refresh = get_expiry_half (item);
-		if (refresh != _EXPIRY_INFINITY) {
-			if (!expiry_next (now, get_expiry (item), NULL)) {
-				g_array_remove_index (rdata->dns_servers, i);
-				*changed |= NM_NDISC_CONFIG_DNS_SERVERS;
-				continue;
-			}
 
-			if (now >= refresh)
-				solicit_routers (ndisc);
-			else if (*nextevent > refresh)
-				*nextevent = refresh;
+		if (!expiry_next (now, get_expiry (item), NULL)) {
+			_track_dns_server (priv, item, FALSE);
+			g_array_remove_index (rdata->dns_servers, i);
+			*changed |= NM_NDISC_CONFIG_DNS_SERVERS;
+			continue;
 		}
+
 		i++;
 	}
 }
 
 static void
-clean_dns_domains (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed, gint32 *nextevent)
+clean_dns_domains (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap *changed)
 {
-	NMNDiscDataInternal *rdata;
+	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
+	NMNDiscDataInternal *rdata = &priv->rdata;
 	guint i;
 
-	rdata = &NM_NDISC_GET_PRIVATE (ndisc)->rdata;
-
 	for (i = 0; i < rdata->dns_domains->len; ) {
 		NMNDiscDNSDomain *item = &g_array_index (rdata->dns_domains, NMNDiscDNSDomain, i);
-		gint64 refresh;
-
-		refresh = get_expiry_half (item);
-		if (refresh != _EXPIRY_INFINITY) {
-			if (!expiry_next (now, get_expiry (item), NULL)) {
-				g_array_remove_index (rdata->dns_domains, i);
-				*changed |= NM_NDISC_CONFIG_DNS_DOMAINS;
-				continue;
-			}
 
-			if (now >= refresh)
-				solicit_routers (ndisc);
-			else if (*nextevent > refresh)
-				*nextevent = refresh;
+		if (!expiry_next (now, get_expiry (item), NULL)) {
+			_track_dns_domain (priv, item, FALSE);
+			g_array_remove_index (rdata->dns_domains, i);
+			*changed |= NM_NDISC_CONFIG_DNS_DOMAINS;
+			continue;
 		}
+
 		i++;
 	}
 }
@@ -1209,23 +1545,69 @@ static void
 check_timestamps (NMNDisc *ndisc, gint32 now, NMNDiscConfigMap changed)
 {
 	NMNDiscPrivate *priv = NM_NDISC_GET_PRIVATE (ndisc);
-	/* Use a magic date in the distant future (~68 years) */
-	gint32 nextevent = G_MAXINT32;
-
-	nm_clear_g_source (&priv->timeout_id);
+	GPtrArray *heap = priv->expiry_heap;
+	ExpiryEntry *e;
+	ExpiryKind kind;
+	gint64 expiry;
+	gint32 nextevent;
+
+	while (   heap->len > 0
+	       && !expiry_next (now, (e = _heap_at (heap, 0))->expiry, NULL)) {
+		/* cleaning may free @e. */
+		kind = e->kind;
+		expiry = e->expiry;
+
+		switch (kind) {
+		case EXPIRY_KIND_GATEWAY:
+			clean_gateways (ndisc, now, &changed);
+			break;
+		case EXPIRY_KIND_ADDRESS:
+			clean_addresses (ndisc, now, &changed);
+			break;
+		case EXPIRY_KIND_ROUTE:
+			clean_routes (ndisc, now, &changed);
+			break;
+		case EXPIRY_KIND_DNS_SERVER:
+			clean_dns_servers (ndisc, now, &changed);
+			break;
+		case EXPIRY_KIND_DNS_DOMAIN:
+			clean_dns_domains (ndisc, now, &changed);
+			break;
+		case EXPIRY_KIND_DNS_SERVER_REFRESH:
+		case EXPIRY_KIND_DNS_DOMAIN_REFRESH:
+			/* the entry stays in expiry_idx until its items go away, so
+			 * that it fires only once. */
+			_heap_remove (heap, e);
+			solicit_routers (ndisc);
+			break;
+		}
 
-	clean_gateways (ndisc, now, &changed, &nextevent);
-	clean_addresses (ndisc, now, &changed, &nextevent);
-	clean_routes (ndisc, now, &changed, &nextevent);
-	clean_dns_servers (ndisc, now, &changed, &nextevent);
-	clean_dns_domains (ndisc, now, &changed, &nextevent);
+		/* cleaning removes all expired items of that kind, hence the
+		 * entry must be gone from the top of the heap. */
+		if (   heap->len > 0
+		    && _heap_at (heap, 0)->kind == kind
+		    && _heap_at (heap, 0)->expiry == expiry) {
+			nm_assert_not_reached ();
+			break;
+		}
+	}
 
-	if (nextevent != G_MAXINT32) {
-		if (nextevent <= now)
-			g_return_if_reached ();
-		_LOGD ("scheduling next now/lifetime check: %d seconds",
-		       (int) (nextevent - now));
-		priv->timeout_id = g_timeout_add_seconds (nextevent - now, timeout_cb, ndisc);
+	/* Use a magic date in the distant future (~68 years) */
+	nextevent = G_MAXINT32;
+	if (heap->len > 0)
+		expiry_next (now, _heap_at (heap, 0)->expiry, &nextevent);
+
+	if (   !priv->timeout_id
+	    || priv->timeout_expiry != nextevent) {
+		nm_clear_g_source (&priv->timeout_id);
+		if (nextevent != G_MAXINT32) {
+			if (nextevent <= now)
+				g_return_if_reached ();
+			_LOGD ("scheduling next now/lifetime check: %d seconds",
+			       (int) (nextevent - now));
+			priv->timeout_id = g_timeout_add_seconds (nextevent - now, timeout_cb, ndisc);
+			priv->timeout_expiry = nextevent;
+		}
 	}
 
 	if (changed)
@@ -1356,6 +1738,9 @@ nm_ndisc_init (NMNDisc *ndisc)
 	g_array_set_clear_func (rdata->dns_domains, dns_domain_free);
 	priv->rdata.public.hop_limit = 64;
 
+	priv->expiry_idx = g_hash_table_new_full (_expiry_entry_hash, _expiry_entry_equal, _expiry_entry_free, NULL);
+	priv->expiry_heap = g_ptr_array_new ();
+
 	/* Start at very low number so that last_rs - router_solicitation_interval
 	 * is much lower than nm_utils_get_monotonic_timestamp_s() at startup.
 	 */
@@ -1394,6 +1779,9 @@ finalize (GObject *object)
 	g_array_unref (rdata->dns_servers);
 	g_array_unref (rdata->dns_domains);
 
+	g_ptr_array_unref (priv->expiry_heap);
+	g_hash_table_unref (priv->expiry_idx);
+
 	g_clear_object (&priv->netns);
 	g_clear_object (&priv->platform);
 
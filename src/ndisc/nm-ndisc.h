@@ -192,6 +192,39 @@ void nm_ndisc_set_config (NMNDisc *ndisc,
                           const GArray *dns_servers,
                           const GArray *dns_domains);
 
+guint64 nm_ndisc_data_get_shape (const NMNDiscData *rdata);
+
+/* Whether a change can be a mere refresh of timestamps and lifetimes. Whether
+ * it is one, tells the shape of the data before and after the change. */
+static inline gboolean
+nm_ndisc_config_map_is_lifetime_update (NMNDiscConfigMap changed)
+{
+	return !NM_FLAGS_ANY (changed, ~(  NM_NDISC_CONFIG_GATEWAYS
+	                                 | NM_NDISC_CONFIG_ADDRESSES
+	                                 | NM_NDISC_CONFIG_ROUTES
+	                                 | NM_NDISC_CONFIG_DNS_SERVERS
+	                                 | NM_NDISC_CONFIG_DNS_DOMAINS));
+}
+
+/* Tracks for the user of NMNDisc whether the IPv6 configuration must be
+ * rebuilt after a change of the RA data. See nm_ndisc_rebuild_check(). */
+typedef struct {
+	guint64 shape;
+	guint timeout_id;
+	guint avoided;
+} NMNDiscRebuild;
+
+NMNDiscConfigMap nm_ndisc_rebuild_check (NMNDiscRebuild *rebuild,
+                                         const NMNDiscData *rdata,
+                                         NMNDiscConfigMap changed,
+                                         gboolean configured,
+                                         gboolean *out_lifetimes_only);
+void nm_ndisc_rebuild_postpone (NMNDiscRebuild *rebuild,
+                                guint delay_sec,
+                                GSourceFunc func,
+                                gpointer user_data);
+void nm_ndisc_rebuild_reset (NMNDiscRebuild *rebuild);
+
 NMPlatform *nm_ndisc_get_platform (NMNDisc *self);
 NMPNetns *nm_ndisc_netns_get (NMNDisc *self);
 gboolean nm_ndisc_netns_push (NMNDisc *self, NMPNetns **netns);
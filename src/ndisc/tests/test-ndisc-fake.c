@@ -21,11 +21,13 @@
 #include "nm-default.h"
 
 #include <syslog.h>
+#include <time.h>
 
 #include "ndisc/nm-ndisc.h"
 #include "ndisc/nm-fake-ndisc.h"
 
 #include "platform/nm-fake-platform.h"
+#include "nm-ip6-config.h"
 
 #include "nm-test-utils-core.h"
 
@@ -141,6 +143,7 @@ typedef struct {
 	guint32 timestamp1;
 	guint32 first_solicit;
 	guint32 timeout_id;
+	guint64 shape;
 } TestData;
 
 static void
@@ -438,6 +441,252 @@ test_preference_changed (void)
 	g_main_loop_unref (data.loop);
 }
 
+static void
+test_lifetime_update_cb (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, TestData *data)
+{
+	NMNDiscConfigMap changed = changed_int;
+	guint64 shape = nm_ndisc_data_get_shape (rdata);
+
+	if (data->counter == 1) {
+		/* Same items, only the expiries moved: NMDevice may skip the rebuild. */
+		g_assert_cmpint (changed, ==, NM_NDISC_CONFIG_GATEWAYS |
+		                              NM_NDISC_CONFIG_ADDRESSES |
+		                              NM_NDISC_CONFIG_ROUTES |
+		                              NM_NDISC_CONFIG_DNS_SERVERS |
+		                              NM_NDISC_CONFIG_DNS_DOMAINS);
+		g_assert (nm_ndisc_config_map_is_lifetime_update (changed));
+		g_assert_cmpuint (shape, ==, data->shape);
+	} else if (data->counter == 2) {
+		/* A new route. */
+		g_assert_cmpint (rdata->routes_n, ==, 2);
+		g_assert_cmpuint (shape, !=, data->shape);
+	} else if (data->counter == 3) {
+		/* The gateway changed its preference. */
+		g_assert_cmpint (changed, ==, NM_NDISC_CONFIG_GATEWAYS);
+		match_gateway (rdata, 0, "fe80::1", data->timestamp1 + 3, 10, NM_ICMPV6_ROUTER_PREF_HIGH);
+		g_assert_cmpuint (shape, !=, data->shape);
+	} else if (data->counter == 4) {
+		/* The DNS server went away. */
+		g_assert_cmpint (changed, ==, NM_NDISC_CONFIG_DNS_SERVERS);
+		g_assert_cmpint (rdata->dns_servers_n, ==, 0);
+		g_assert_cmpuint (shape, !=, data->shape);
+
+		g_assert (nm_fake_ndisc_done (NM_FAKE_NDISC (ndisc)));
+		g_main_loop_quit (data->loop);
+	}
+
+	data->shape = shape;
+	data->counter++;
+}
+
+static void
+test_lifetime_update (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	TestData data = { g_main_loop_new (NULL, FALSE), 0, 0, now };
+	guint id;
+
+	/* Test that an RA which only refreshes lifetimes keeps the shape of the
+	 * configuration, while a new route, a preference change or a removed
+	 * DNS server do not.
+	 */
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", now, 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", now, 10, 10, 10);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", now, 10);
+	nm_fake_ndisc_add_dns_domain (ndisc, id, "foo.bar", now, 10);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", ++now, 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", now, 10, 10, 10);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", now, 10);
+	nm_fake_ndisc_add_dns_domain (ndisc, id, "foo.bar", now, 10);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:b::", 64, "fe80::1", ++now, 10, 10, 10);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", ++now, 10, NM_ICMPV6_ROUTER_PREF_HIGH);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", ++now, 0);
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (test_lifetime_update_cb),
+	                  &data);
+
+	nm_ndisc_start (NM_NDISC (ndisc));
+	g_main_loop_run (data.loop);
+	g_assert_cmpint (data.counter, ==, 5);
+
+	g_object_unref (ndisc);
+	g_main_loop_unref (data.loop);
+}
+
+typedef struct {
+	GMainLoop *loop;
+	guint counter;
+	guint rebuilds;
+	guint timeout_id;
+	NMNDiscRebuild rebuild;
+	NMDedupMultiIndex *multi_idx;
+	NMIP6Config *config;
+} RebuildData;
+
+static gboolean
+test_rebuild_cb (gpointer user_data)
+{
+	RebuildData *data = user_data;
+
+	data->rebuild.timeout_id = 0;
+	data->rebuilds++;
+	return G_SOURCE_REMOVE;
+}
+
+static void
+test_rebuild_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, RebuildData *data)
+{
+	NMNDiscConfigMap changed = changed_int;
+	NMNDiscConfigMap apply;
+	const NMPlatformIP6Address *address;
+	gboolean lifetimes_only;
+	struct in6_addr addr;
+
+	/* the NMDevice part: all RAs but the first come after IPv6 is configured. */
+	apply = nm_ndisc_rebuild_check (&data->rebuild, rdata, changed, data->counter > 0, &lifetimes_only);
+
+	if (apply & NM_NDISC_CONFIG_ADDRESSES) {
+		nm_ip6_config_reset_addresses_ndisc (data->config, rdata->addresses, rdata->addresses_n, 64, 0);
+		if (lifetimes_only)
+			nm_ip6_config_refresh_addresses_ndisc (data->config, NM_PLATFORM_GET, nm_utils_get_monotonic_timestamp_s ());
+	}
+	if (lifetimes_only)
+		nm_ndisc_rebuild_postpone (&data->rebuild, 2, test_rebuild_cb, data);
+
+	inet_pton (AF_INET6, "2001:db8:a:a::1", &addr);
+
+	switch (data->counter) {
+	case 0:
+		/* the initial RA must be applied in full. */
+		g_assert (!lifetimes_only);
+		g_assert_cmpint (apply, ==, changed);
+		g_assert (!data->rebuild.timeout_id);
+		break;
+	case 1:
+		/* only the lifetimes were refreshed. Only the addresses are applied,
+		 * in place, and the rebuild is postponed. */
+		g_assert (lifetimes_only);
+		g_assert_cmpint (changed, !=, NM_NDISC_CONFIG_ADDRESSES);
+		g_assert_cmpint (apply, ==, NM_NDISC_CONFIG_ADDRESSES);
+		g_assert_cmpint (data->rebuild.avoided, ==, 1);
+		g_assert (data->rebuild.timeout_id);
+		data->timeout_id = data->rebuild.timeout_id;
+
+		address = nm_platform_ip6_address_get (NM_PLATFORM_GET, 1, addr);
+		g_assert (address);
+		g_assert_cmpint (address->lifetime, >, 10);
+		g_assert_cmpint (address->lifetime, <=, 20);
+		break;
+	case 2:
+		/* another refresh doesn't move the postponed rebuild. */
+		g_assert (lifetimes_only);
+		g_assert_cmpint (data->rebuild.avoided, ==, 2);
+		g_assert_cmpint (data->rebuild.timeout_id, ==, data->timeout_id);
+		g_assert_cmpint (data->rebuilds, ==, 0);
+		break;
+	case 3:
+		/* meanwhile, the postponed rebuild happened, once. The next
+		 * refresh schedules a new one. */
+		g_assert (lifetimes_only);
+		g_assert_cmpint (data->rebuilds, ==, 1);
+		g_assert_cmpint (data->rebuild.avoided, ==, 3);
+		g_assert (data->rebuild.timeout_id);
+		break;
+	case 4:
+		/* a new route needs an immediate rebuild, which cancels the
+		 * postponed one. */
+		g_assert (!lifetimes_only);
+		g_assert_cmpint (apply, ==, changed);
+		g_assert (NM_FLAGS_HAS (apply, NM_NDISC_CONFIG_ROUTES));
+		g_assert (!data->rebuild.timeout_id);
+		g_assert_cmpint (data->rebuild.avoided, ==, 3);
+
+		nm_platform_ip6_address_delete (NM_PLATFORM_GET, 1, addr, 64);
+		g_assert (nm_fake_ndisc_done (NM_FAKE_NDISC (ndisc)));
+		g_main_loop_quit (data->loop);
+		break;
+	default:
+		g_assert_not_reached ();
+	}
+
+	data->counter++;
+}
+
+static void
+test_rebuild (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	RebuildData data = {
+		.loop = g_main_loop_new (NULL, FALSE),
+	};
+	guint id;
+
+	/* Test how NMDevice uses the RA data: a lifetime refresh is applied
+	 * in place and the rebuild of the configuration is postponed, but not
+	 * further than the delay (here 2 seconds). */
+
+	data.multi_idx = nm_dedup_multi_index_new ();
+	data.config = nm_ip6_config_new (data.multi_idx, 1);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", now, 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", now, 10, 10, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", now, 10);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", now + 1, 20, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", now + 1, 20, 20, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", now + 1, 20);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 0, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", now + 1, 30, 30, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 5, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:a::", 64, "fe80::1", now + 6, 30, 30, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 0, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_prefix (ndisc, id, "2001:db8:a:b::", 64, "fe80::1", now + 6, 30, 30, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (test_rebuild_changed),
+	                  &data);
+
+	nm_ndisc_start (NM_NDISC (ndisc));
+	g_main_loop_run (data.loop);
+	g_assert_cmpint (data.counter, ==, 5);
+
+	nm_ndisc_rebuild_reset (&data.rebuild);
+	g_object_unref (data.config);
+	nm_dedup_multi_index_unref (data.multi_idx);
+	g_object_unref (ndisc);
+	g_main_loop_unref (data.loop);
+}
+
 static void
 test_dns_solicit_loop_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, TestData *data)
 {
@@ -520,11 +769,406 @@ test_dns_solicit_loop (void)
 	g_main_loop_unref (data.loop);
 }
 
+static void
+test_dns_refresh_once_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, TestData *data)
+{
+	data->counter++;
+	if (data->counter == 2) {
+		/* the second DNS server joined the refresh that fired with the
+		 * first RA. Wait past the retry interval for solicitations. */
+		g_assert_cmpint (rdata->dns_servers_n, ==, 2);
+		data->timeout_id = g_timeout_add_seconds (5, (GSourceFunc) success_timeout, data);
+	}
+}
+
+static void
+test_dns_refresh_once_rs_sent (NMFakeNDisc *ndisc, TestData *data)
+{
+	if (data->counter >= 2)
+		data->rs_counter++;
+}
+
+static void
+test_dns_refresh_once (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	TestData data = { g_main_loop_new (NULL, FALSE), 0, 0, now, 0 };
+	guint id;
+
+	/* The first RA arrives at half the lifetime of its DNS server, so the
+	 * refresh fires right away. The second RA carries a
+	 * DNS server with the same refresh time. It must not fire that
+	 * refresh again, which would solicit after the RA already answered. */
+
+	id = nm_fake_ndisc_add_ra (ndisc, 4, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", now, 30, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", now, 6);
+
+	id = nm_fake_ndisc_add_ra (ndisc, 0, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", now, 30, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::1", now, 6);
+	nm_fake_ndisc_add_dns_server (ndisc, id, "2001:db8:c:c::2", now, 6);
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (test_dns_refresh_once_changed),
+	                  &data);
+	g_signal_connect (ndisc,
+	                  NM_FAKE_NDISC_RS_SENT,
+	                  G_CALLBACK (test_dns_refresh_once_rs_sent),
+	                  &data);
+
+	nm_ndisc_start (NM_NDISC (ndisc));
+	g_main_loop_run (data.loop);
+
+	/* the two RAs, and the expiry of both DNS servers. */
+	g_assert_cmpint (data.counter, ==, 3);
+	g_assert_cmpint (data.rs_counter, ==, 0);
+
+	g_object_unref (ndisc);
+	g_main_loop_unref (data.loop);
+}
+
+#define MANY_ROUTES_N 3000
+
+static guint
+_many_routes_lifetime (guint i)
+{
+	/* three groups of routes, that expire two seconds apart. */
+	return 3 + 2 * (i % 3);
+}
+
+static void
+test_many_routes_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, TestData *data)
+{
+	NMNDiscConfigMap changed = changed_int;
+	gint64 now = nm_utils_get_monotonic_timestamp_s ();
+	guint expected = 0;
+	guint i;
+
+	g_assert (changed & NM_NDISC_CONFIG_ROUTES);
+
+	for (i = 0; i < MANY_ROUTES_N; i++) {
+		if ((gint64) data->timestamp1 + _many_routes_lifetime (i) > now)
+			expected++;
+	}
+	g_assert_cmpint (rdata->routes_n, ==, expected);
+
+	for (i = 0; i < rdata->routes_n; i++) {
+		const NMNDiscRoute *route = &rdata->routes[i];
+
+		g_assert_cmpint ((gint64) route->timestamp + route->lifetime, >, now);
+	}
+
+	data->counter++;
+	if (rdata->routes_n == 0) {
+		g_assert (nm_fake_ndisc_done (NM_FAKE_NDISC (ndisc)));
+		g_main_loop_quit (data->loop);
+	}
+}
+
+static void
+test_many_routes (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	TestData data = { g_main_loop_new (NULL, FALSE), 0, 0, now };
+	guint id;
+	guint i;
+
+	/* An RA with thousands of route information options. Each group
+	 * must be dropped when it expires, without a full rescan of the
+	 * routes on every RA and timeout. */
+
+	id = nm_fake_ndisc_add_ra (ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+	g_assert (id);
+	for (i = 0; i < MANY_ROUTES_N; i++) {
+		char network[INET6_ADDRSTRLEN];
+
+		nm_sprintf_buf (network, "2001:db8::%x", i);
+		nm_fake_ndisc_add_prefix (ndisc, id, network, 128, "fe80::1", now,
+		                          _many_routes_lifetime (i), 0, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+	}
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (test_many_routes_changed),
+	                  &data);
+
+	nm_ndisc_start (NM_NDISC (ndisc));
+	g_main_loop_run (data.loop);
+
+	/* the initial RA, and one change per expiring group. The timeouts
+	 * have a granularity of one second, which is less than the spacing
+	 * of the groups. */
+	g_assert_cmpint (data.counter, ==, 4);
+
+	g_object_unref (ndisc);
+	g_main_loop_unref (data.loop);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	guint n_emitted;
+	guint n_gateways;
+	guint n_routes;
+	guint n_dns_servers;
+	guint n_dns_domains;
+} RaChurnData;
+
+static void
+ra_churn_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, RaChurnData *data)
+{
+	NMNDiscConfigMap changed = changed_int;
+
+	data->n_emitted++;
+	if (changed & NM_NDISC_CONFIG_GATEWAYS)
+		data->n_gateways++;
+	if (changed & NM_NDISC_CONFIG_ROUTES)
+		data->n_routes++;
+	if (changed & NM_NDISC_CONFIG_DNS_SERVERS)
+		data->n_dns_servers++;
+	if (changed & NM_NDISC_CONFIG_DNS_DOMAINS)
+		data->n_dns_domains++;
+}
+
+static gint64
+_cpu_time_ns (void)
+{
+	struct timespec ts;
+
+	clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (((gint64) ts.tv_sec) * NM_UTILS_NS_PER_SECOND) + ts.tv_nsec;
+}
+
+typedef struct {
+	const char *name;
+	guint n_ras;
+	guint n_routes;
+	guint n_dns_servers;
+	guint n_dns_domains;
+
+	/* every churn_mod-th item gets a new lifetime in each RA.
+	 * Zero for a stream of identical RAs. */
+	guint churn_mod;
+} RaBenchmark;
+
+static void
+test_ra_benchmark (gconstpointer test_data)
+{
+	const RaBenchmark *bench = test_data;
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	RaChurnData data = { };
+	gint64 t_total = 0;
+	gint64 t_max = 0;
+	guint r, i;
+
+	/* Replays a synthetic stream of RAs and reports the CPU time spent per
+	 * RA, and how often NMNDisc told its users about a changed config. Each
+	 * such change means updating the IPv6 config of the device. */
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (ra_churn_changed),
+	                  &data);
+
+	for (r = 0; r < bench->n_ras; r++) {
+		guint id;
+		gint64 t;
+
+		id = nm_fake_ndisc_add_ra (ndisc, 0, NM_NDISC_DHCP_LEVEL_NONE, 64, 1500);
+		nm_fake_ndisc_add_gateway (ndisc, id, "fe80::1", now, 1800, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+
+		for (i = 0; i < bench->n_routes; i++) {
+			char network[INET6_ADDRSTRLEN];
+			guint32 lifetime = 1800;
+
+			if (bench->churn_mod && (i + r) % bench->churn_mod == 0)
+				lifetime += r;
+			nm_sprintf_buf (network, "2001:db8:%x::", i);
+			nm_fake_ndisc_add_prefix (ndisc, id, network, 48, "fe80::1", now,
+			                          lifetime, 0, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+		}
+
+		for (i = 0; i < bench->n_dns_servers; i++) {
+			char address[INET6_ADDRSTRLEN];
+			guint32 lifetime = 1800;
+
+			if (bench->churn_mod && (i + r) % bench->churn_mod == 0)
+				lifetime += r;
+			nm_sprintf_buf (address, "2001:db8:c::%x", i);
+			nm_fake_ndisc_add_dns_server (ndisc, id, address, now, lifetime);
+		}
+
+		for (i = 0; i < bench->n_dns_domains; i++) {
+			char domain[64];
+			guint32 lifetime = 1800;
+
+			if (bench->churn_mod && (i + r) % bench->churn_mod == 0)
+				lifetime += r;
+			nm_sprintf_buf (domain, "d%u.example.com", i);
+			nm_fake_ndisc_add_dns_domain (ndisc, id, domain, now, lifetime);
+		}
+
+		t = _cpu_time_ns ();
+		g_assert (nm_fake_ndisc_receive_next_ra (ndisc));
+		t = _cpu_time_ns () - t;
+
+		t_total += t;
+		t_max = MAX (t_max, t);
+	}
+
+	g_test_message ("%s: %u RAs with %u routes, %u DNS servers, %u DNS domains: "
+	                "%.1f usec CPU per RA (max %.1f), %u config changes "
+	                "(%u gateways, %u routes, %u DNS servers, %u DNS domains)",
+	                bench->name, bench->n_ras,
+	                bench->n_routes, bench->n_dns_servers, bench->n_dns_domains,
+	                (double) t_total / bench->n_ras / 1000.0,
+	                (double) t_max / 1000.0,
+	                data.n_emitted,
+	                data.n_gateways, data.n_routes,
+	                data.n_dns_servers, data.n_dns_domains);
+
+	g_assert_cmpint (data.n_emitted, <=, bench->n_ras);
+	if (!bench->churn_mod) {
+		/* RAs that repeat the known config must not cause any churn. */
+		g_assert_cmpint (data.n_emitted, ==, 1);
+	}
+
+	g_object_unref (ndisc);
+}
+
+static const RaBenchmark ra_benchmarks[] = {
+	{ .name = "small",      .n_ras = 1000, .n_routes = 4,    .n_dns_servers = 2,  .n_dns_domains = 2,  },
+	{ .name = "many-rio",   .n_ras = 50,   .n_routes = 1000, .n_dns_servers = 2,  .n_dns_domains = 2,  },
+	{ .name = "many-dns",   .n_ras = 200,  .n_routes = 4,    .n_dns_servers = 64, .n_dns_domains = 64, },
+	{ .name = "churn",      .n_ras = 50,   .n_routes = 1000, .n_dns_servers = 64, .n_dns_domains = 64, .churn_mod = 100, },
+};
+
+/*****************************************************************************/
+
+#define FUZZ_POOL_N 32
+
+typedef struct {
+	/* the lifetime that the last RA announced for each pool item,
+	 * zero if the item should be gone. */
+	guint32 routes[FUZZ_POOL_N];
+	guint32 dns_servers[FUZZ_POOL_N];
+	guint32 dns_domains[FUZZ_POOL_N];
+	guint n_emitted;
+} RaFuzzData;
+
+static void
+ra_fuzz_changed (NMNDisc *ndisc, const NMNDiscData *rdata, guint changed_int, RaFuzzData *data)
+{
+	guint i, j, n;
+
+	data->n_emitted++;
+
+	for (i = 0; i < rdata->routes_n; i++) {
+		const NMNDiscRoute *route = &rdata->routes[i];
+
+		g_assert_cmpint (route->lifetime, >, 0);
+		for (j = 0; j < i; j++) {
+			g_assert (   !IN6_ARE_ADDR_EQUAL (&route->network, &rdata->routes[j].network)
+			          || route->plen != rdata->routes[j].plen);
+		}
+	}
+	for (n = 0, i = 0; i < FUZZ_POOL_N; i++) {
+		if (data->routes[i])
+			n++;
+	}
+	g_assert_cmpint (rdata->routes_n, ==, n);
+
+	for (n = 0, i = 0; i < FUZZ_POOL_N; i++) {
+		if (data->dns_servers[i])
+			n++;
+	}
+	g_assert_cmpint (rdata->dns_servers_n, ==, n);
+
+	for (n = 0, i = 0; i < FUZZ_POOL_N; i++) {
+		if (data->dns_domains[i])
+			n++;
+	}
+	g_assert_cmpint (rdata->dns_domains_n, ==, n);
+}
+
+static void
+test_ra_fuzz (void)
+{
+	NMFakeNDisc *ndisc = ndisc_new ();
+	guint32 now = nm_utils_get_monotonic_timestamp_s ();
+	RaFuzzData data = { };
+	guint r, i;
+
+	/* Random RAs that add, refresh, re-prioritize and withdraw items of a
+	 * small pool. After each RA, NMNDisc must have exactly the items whose
+	 * last announced lifetime was non-zero. Lifetimes are long enough that
+	 * nothing expires while the test runs. */
+
+	g_signal_connect (ndisc,
+	                  NM_NDISC_CONFIG_RECEIVED,
+	                  G_CALLBACK (ra_fuzz_changed),
+	                  &data);
+
+	for (r = 0; r < 500; r++) {
+		guint id;
+
+		id = nm_fake_ndisc_add_ra (ndisc, 0, NM_NDISC_DHCP_LEVEL_NONE, 64, 1500);
+
+		for (i = 0; i < FUZZ_POOL_N; i++) {
+			char buf[64];
+			guint32 lifetime;
+			NMIcmpv6RouterPref pref;
+
+			if (nmtst_get_rand_int () % 4 == 0) {
+				lifetime = (nmtst_get_rand_int () % 3 == 0) ? 0 : 600 + nmtst_get_rand_int () % 3;
+				pref = (NMIcmpv6RouterPref[]) {
+					NM_ICMPV6_ROUTER_PREF_LOW,
+					NM_ICMPV6_ROUTER_PREF_MEDIUM,
+					NM_ICMPV6_ROUTER_PREF_HIGH,
+				}[nmtst_get_rand_int () % 3];
+
+				nm_sprintf_buf (buf, "2001:db8:%x::", i);
+				nm_fake_ndisc_add_prefix (ndisc, id, buf, 48, "fe80::1", now, lifetime, 0, pref);
+				data.routes[i] = lifetime;
+			}
+
+			if (nmtst_get_rand_int () % 8 == 0) {
+				lifetime = (nmtst_get_rand_int () % 3 == 0) ? 0 : 600 + nmtst_get_rand_int () % 3;
+				nm_sprintf_buf (buf, "2001:db8:c::%x", i);
+				nm_fake_ndisc_add_dns_server (ndisc, id, buf, now, lifetime);
+				data.dns_servers[i] = lifetime;
+			}
+
+			if (nmtst_get_rand_int () % 8 == 0) {
+				lifetime = (nmtst_get_rand_int () % 3 == 0) ? 0 : 600 + nmtst_get_rand_int () % 3;
+				nm_sprintf_buf (buf, "d%u.example.com", i);
+				nm_fake_ndisc_add_dns_domain (ndisc, id, buf, now, lifetime);
+				data.dns_domains[i] = lifetime;
+			}
+		}
+
+		g_assert (nm_fake_ndisc_receive_next_ra (ndisc));
+	}
+
+	g_assert_cmpint (data.n_emitted, >, 0);
+
+	g_object_unref (ndisc);
+}
+
 NMTST_DEFINE ();
 
 int
 main (int argc, char **argv)
 {
+	guint i;
+
 	nmtst_init_with_logging (&argc, &argv, NULL, "DEFAULT");
 
 	if (nmtst_test_quick ()) {
@@ -538,7 +1182,17 @@ main (int argc, char **argv)
 	g_test_add_func ("/ndisc/everything-changed", test_everything);
 	g_test_add_func ("/ndisc/preference-order", test_preference_order);
 	g_test_add_func ("/ndisc/preference-changed", test_preference_changed);
+	g_test_add_func ("/ndisc/lifetime-update", test_lifetime_update);
+	g_test_add_func ("/ndisc/rebuild", test_rebuild);
 	g_test_add_func ("/ndisc/dns-solicit-loop", test_dns_solicit_loop);
+	g_test_add_func ("/ndisc/dns-refresh-once", test_dns_refresh_once);
+	g_test_add_func ("/ndisc/many-routes", test_many_routes);
+	g_test_add_func ("/ndisc/ra-fuzz", test_ra_fuzz);
+	for (i = 0; i < G_N_ELEMENTS (ra_benchmarks); i++) {
+		gs_free char *path = g_strdup_printf ("/ndisc/ra-benchmark/%s", ra_benchmarks[i].name);
+
+		g_test_add_data_func (path, &ra_benchmarks[i], test_ra_benchmark);
+	}
 
 	return g_test_run ();
 }
@@ -25,6 +25,7 @@
 #include "c-list/src/c-list.h"
 #include "nm-errors.h"
 #include "nm-core-internal.h"
+#include "nm-session-monitor.h"
 #include "NetworkManagerUtils.h"
 
 #define POLKIT_SERVICE                      "org.freedesktop.PolicyKit1"
@@ -34,10 +35,15 @@
 #define CANCELLATION_ID_PREFIX "cancellation-id-"
 #define CANCELLATION_TIMEOUT_MS 5000
 
+/* upper bound for the number of cached authorization results. When
+ * exceeded, the cache is flushed entirely. */
+#define CACHE_MAX_ENTRIES 1024
+
 /*****************************************************************************/
 
 NM_GOBJECT_PROPERTIES_DEFINE_BASE (
 	PROP_POLKIT_ENABLED,
+	PROP_CACHE_TTL,
 );
 
 enum {
@@ -52,7 +58,16 @@ typedef struct {
 	GDBusProxy *proxy;
 	GCancellable *new_proxy_cancellable;
 	GCancellable *cancel_cancellable;
+	NMSessionMonitor *session_monitor;
 	guint64 call_numid_counter;
+	struct {
+		/* maps "subject|action-id|flags" to AuthCacheEntry */
+		GHashTable *hash;
+		guint64 generation;
+		guint ttl_sec;
+		guint hits;
+		guint misses;
+	} cache;
 	bool polkit_enabled:1;
 	bool disposing:1;
 	bool shutting_down:1;
@@ -126,8 +141,15 @@ typedef enum {
 typedef enum {
 	IDLE_REASON_AUTHORIZED,
 	IDLE_REASON_NO_DBUS,
+	IDLE_REASON_CACHED,
 } IdleReason;
 
+typedef struct {
+	gint64 timestamp_ms;
+	bool is_authorized:1;
+	bool is_challenge:1;
+} AuthCacheEntry;
+
 struct _NMAuthManagerCallId {
 	CList calls_lst;
 	NMAuthManager *self;
@@ -135,9 +157,14 @@ struct _NMAuthManagerCallId {
 	GCancellable *dbus_cancellable;
 	NMAuthManagerCheckAuthorizationCallback callback;
 	gpointer user_data;
+	char *cache_key;
 	guint64 call_numid;
+	guint64 cache_generation;
 	guint idle_id;
 	IdleReason idle_reason:8;
+	bool allow_user_interaction:1;
+	bool cached_is_authorized:1;
+	bool cached_is_challenge:1;
 };
 
 #define cancellation_id_to_str_a(call_numid) \
@@ -145,11 +172,114 @@ struct _NMAuthManagerCallId {
 	                 CANCELLATION_ID_PREFIX"%"G_GUINT64_FORMAT, \
 	                 (call_numid))
 
+/*****************************************************************************/
+
+static void
+_cache_entry_free (gpointer data)
+{
+	g_slice_free (AuthCacheEntry, data);
+}
+
+static void
+_cache_log_stats (NMAuthManager *self, const char *reason)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	guint total = priv->cache.hits + priv->cache.misses;
+
+	_LOGD ("cache: %s (%u entries, hits %u/%u, %u%%)",
+	       reason,
+	       priv->cache.hash ? g_hash_table_size (priv->cache.hash) : 0u,
+	       priv->cache.hits,
+	       total,
+	       total > 0 ? (guint) (((guint64) priv->cache.hits * 100u) / total) : 0u);
+}
+
+static void
+_cache_invalidate (NMAuthManager *self, const char *reason)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+
+	if (!priv->cache.hash)
+		return;
+
+	/* bump the generation, so that results of pending requests that were
+	 * started before the invalidation are not added to the cache. */
+	priv->cache.generation++;
+	_cache_log_stats (self, reason);
+	g_hash_table_remove_all (priv->cache.hash);
+}
+
+static char *
+_cache_key_new (NMAuthSubject *subject,
+                const char *action_id,
+                PolkitCheckAuthorizationFlags flags)
+{
+	char subject_buf[64];
+
+	/* the subject string contains pid, uid and the process start-time.
+	 * That is the same information that we pass on to polkit. */
+	return g_strdup_printf ("%s|%s|%u",
+	                        nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)),
+	                        action_id,
+	                        (guint) flags);
+}
+
+static const AuthCacheEntry *
+_cache_lookup (NMAuthManager *self, const char *cache_key)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	AuthCacheEntry *entry;
+
+	nm_assert (priv->cache.hash);
+
+	entry = g_hash_table_lookup (priv->cache.hash, cache_key);
+	if (   entry
+	    && entry->timestamp_ms + ((gint64) priv->cache.ttl_sec * 1000) <= nm_utils_get_monotonic_timestamp_ms ()) {
+		g_hash_table_remove (priv->cache.hash, cache_key);
+		entry = NULL;
+	}
+
+	if (entry)
+		priv->cache.hits++;
+	else
+		priv->cache.misses++;
+	return entry;
+}
+
+static void
+_cache_add (NMAuthManagerCallId *call_id,
+            gboolean is_authorized,
+            gboolean is_challenge)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (call_id->self);
+	AuthCacheEntry *entry;
+
+	if (   !call_id->cache_key
+	    || !priv->cache.hash
+	    || call_id->cache_generation != priv->cache.generation
+	    || !nm_auth_call_result_is_cacheable (call_id->allow_user_interaction, is_challenge))
+		return;
+
+	if (g_hash_table_size (priv->cache.hash) >= CACHE_MAX_ENTRIES)
+		_cache_invalidate (call_id->self, "flush due to size limit");
+
+	entry = g_slice_new (AuthCacheEntry);
+	entry->timestamp_ms = nm_utils_get_monotonic_timestamp_ms ();
+	entry->is_authorized = is_authorized;
+	entry->is_challenge = is_challenge;
+	g_hash_table_insert (priv->cache.hash,
+	                     g_steal_pointer (&call_id->cache_key),
+	                     entry);
+}
+
+/*****************************************************************************/
+
 static void
 _call_id_free (NMAuthManagerCallId *call_id)
 {
 	c_list_unlink (&call_id->calls_lst);
 	nm_clear_g_source (&call_id->idle_id);
+	nm_clear_g_free (&call_id->cache_key);
 	if (call_id->dbus_parameters)
 		g_variant_unref (g_steal_pointer (&call_id->dbus_parameters));
 
@@ -264,6 +394,7 @@ _call_check_authorize_cb (GObject *proxy,
 		               NULL);
 		_LOG2T (call_id, "completed: authorized=%d, challenge=%d",
 		        is_authorized, is_challenge);
+		_cache_add (call_id, is_authorized, is_challenge);
 	} else
 		_LOG2T (call_id, "completed: failed: %s", error->message);
 
@@ -308,6 +439,11 @@ _call_on_idle (gpointer user_data)
 		is_authorized = TRUE;
 		_LOG2T (call_id, "completed: authorized=%d, challenge=%d (simulated)",
 		        is_authorized, is_challenge);
+	} else if (call_id->idle_reason == IDLE_REASON_CACHED) {
+		is_authorized = call_id->cached_is_authorized;
+		is_challenge = call_id->cached_is_challenge;
+		_LOG2T (call_id, "completed: authorized=%d, challenge=%d (cached)",
+		        is_authorized, is_challenge);
 	} else {
 		nm_assert (call_id->idle_reason == IDLE_REASON_NO_DBUS);
 		error_msg = "failure creating GDBusProxy for authorization request";
@@ -348,6 +484,7 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 	GVariant *subject_value;
 	GVariant *details_value;
 	NMAuthManagerCallId *call_id;
+	const AuthCacheEntry *cache_entry;
 
 	g_return_val_if_fail (NM_IS_AUTH_MANAGER (self), NULL);
 	g_return_val_if_fail (NM_IN_SET (nm_auth_subject_get_subject_type (subject),
@@ -370,6 +507,7 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 	call_id->callback = callback;
 	call_id->user_data = user_data;
 	call_id->call_numid = ++priv->call_numid_counter;
+	call_id->allow_user_interaction = allow_user_interaction;
 	c_list_link_tail (&priv->calls_lst_head, &call_id->calls_lst);
 
 	if (!priv->polkit_enabled) {
@@ -389,7 +527,22 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 		_LOG2T (call_id, "CheckAuthorization(%s), subject=%s (failing due to invalid DBUS proxy)", action_id, nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)));
 		call_id->idle_reason = IDLE_REASON_NO_DBUS;
 		call_id->idle_id = g_idle_add (_call_on_idle, call_id);
+	} else if (   priv->cache.hash
+	           && !allow_user_interaction
+	           && (call_id->cache_key = _cache_key_new (subject, action_id, flags))
+	           && (cache_entry = _cache_lookup (self, call_id->cache_key))) {
+		_LOG2T (call_id, "CheckAuthorization(%s), subject=%s (cached result, hits %u/%u)",
+		        action_id,
+		        nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)),
+		        priv->cache.hits,
+		        priv->cache.hits + priv->cache.misses);
+		call_id->cached_is_authorized = cache_entry->is_authorized;
+		call_id->cached_is_challenge = cache_entry->is_challenge;
+		call_id->idle_reason = IDLE_REASON_CACHED;
+		call_id->idle_id = g_idle_add (_call_on_idle, call_id);
 	} else {
+		call_id->cache_generation = priv->cache.generation;
+
 		subject_value = nm_auth_subject_unix_process_to_polkit_gvariant (subject);
 		nm_assert (g_variant_is_floating (subject_value));
 
@@ -442,6 +595,8 @@ nm_auth_manager_check_authorization_cancel (NMAuthManagerCallId *call_id)
 static void
 _emit_changed_signal (NMAuthManager *self)
 {
+	_cache_invalidate (self, "invalidate due to authority change");
+
 	_LOGD ("emit changed signal");
 	g_signal_emit (self, signals[CHANGED_SIGNAL], 0);
 }
@@ -549,6 +704,13 @@ again:
 	_emit_changed_signal (self);
 }
 
+static void
+_session_monitor_changed_cb (NMSessionMonitor *session_monitor,
+                             gpointer user_data)
+{
+	_cache_invalidate (user_data, "invalidate due to session change");
+}
+
 /*****************************************************************************/
 
 NMAuthManager *
@@ -605,6 +767,10 @@ set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *p
 		/* construct-only */
 		priv->polkit_enabled = !!g_value_get_boolean (value);
 		break;
+	case PROP_CACHE_TTL:
+		/* construct-only */
+		priv->cache.ttl_sec = g_value_get_uint (value);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -629,7 +795,17 @@ constructed (GObject *object)
 
 	G_OBJECT_CLASS (nm_auth_manager_parent_class)->constructed (object);
 
-	_LOGD ("create auth-manager: polkit %s", priv->polkit_enabled ? "enabled" : "disabled");
+	_LOGD ("create auth-manager: polkit %s, cache-ttl %u", priv->polkit_enabled ? "enabled" : "disabled", priv->cache.ttl_sec);
+
+	if (   priv->polkit_enabled
+	    && priv->cache.ttl_sec > 0) {
+		priv->cache.hash = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _cache_entry_free);
+		priv->session_monitor = g_object_ref (nm_session_monitor_get ());
+		g_signal_connect (priv->session_monitor,
+		                  NM_SESSION_MONITOR_CHANGED,
+		                  G_CALLBACK (_session_monitor_changed_cb),
+		                  self);
+	}
 
 	if (priv->polkit_enabled) {
 		priv->new_proxy_cancellable = g_cancellable_new ();
@@ -646,7 +822,7 @@ constructed (GObject *object)
 }
 
 NMAuthManager *
-nm_auth_manager_setup (gboolean polkit_enabled)
+nm_auth_manager_setup (gboolean polkit_enabled, guint cache_ttl_sec)
 {
 	NMAuthManager *self;
 
@@ -654,6 +830,7 @@ nm_auth_manager_setup (gboolean polkit_enabled)
 
 	self = g_object_new (NM_TYPE_AUTH_MANAGER,
 	                     NM_AUTH_MANAGER_POLKIT_ENABLED, polkit_enabled,
+	                     NM_AUTH_MANAGER_CACHE_TTL, cache_ttl_sec,
 	                     NULL);
 	_LOGD ("set instance");
 
@@ -685,6 +862,16 @@ dispose (GObject *object)
 		g_clear_object (&priv->proxy);
 	}
 
+	if (priv->session_monitor) {
+		g_signal_handlers_disconnect_by_func (priv->session_monitor, _session_monitor_changed_cb, self);
+		g_clear_object (&priv->session_monitor);
+	}
+
+	if (priv->cache.hash) {
+		_cache_log_stats (self, "destroy");
+		g_clear_pointer (&priv->cache.hash, g_hash_table_unref);
+	}
+
 	G_OBJECT_CLASS (nm_auth_manager_parent_class)->dispose (object);
 }
 
@@ -704,6 +891,13 @@ nm_auth_manager_class_init (NMAuthManagerClass *klass)
 	                           G_PARAM_CONSTRUCT_ONLY |
 	                           G_PARAM_STATIC_STRINGS);
 
+	obj_properties[PROP_CACHE_TTL] =
+	     g_param_spec_uint (NM_AUTH_MANAGER_CACHE_TTL, "", "",
+	                        0, G_MAXUINT32, 0,
+	                        G_PARAM_WRITABLE |
+	                        G_PARAM_CONSTRUCT_ONLY |
+	                        G_PARAM_STATIC_STRINGS);
+
 	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
 
 	signals[CHANGED_SIGNAL] = g_signal_new (NM_AUTH_MANAGER_SIGNAL_CHANGED,
@@ -46,6 +46,20 @@ nm_auth_call_result_eval (gboolean is_authorized,
 	return NM_AUTH_CALL_RESULT_NO;
 }
 
+/* Whether the result of a CheckAuthorization call may be cached.
+ *
+ * A result of an interactive check depends on what the user answered
+ * to the authentication agent (and an "auth_admin" grant is only valid
+ * once), and a challenge means that asking again with interaction could
+ * succeed. polkit does not signal when such results become stale. */
+static inline gboolean
+nm_auth_call_result_is_cacheable (gboolean allow_user_interaction,
+                                  gboolean is_challenge)
+{
+	return    !allow_user_interaction
+	       && !is_challenge;
+}
+
 /*****************************************************************************/
 
 #define NM_TYPE_AUTH_MANAGER            (nm_auth_manager_get_type ())
@@ -56,6 +70,7 @@ nm_auth_call_result_eval (gboolean is_authorized,
 #define NM_AUTH_MANAGER_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  NM_TYPE_AUTH_MANAGER, NMAuthManagerClass))
 
 #define NM_AUTH_MANAGER_POLKIT_ENABLED "polkit-enabled"
+#define NM_AUTH_MANAGER_CACHE_TTL      "cache-ttl"
 
 #define NM_AUTH_MANAGER_SIGNAL_CHANGED "changed"
 
@@ -64,7 +79,7 @@ typedef struct _NMAuthManagerClass NMAuthManagerClass;
 
 GType nm_auth_manager_get_type (void);
 
-NMAuthManager *nm_auth_manager_setup (gboolean polkit_enabled);
+NMAuthManager *nm_auth_manager_setup (gboolean polkit_enabled, guint cache_ttl_sec);
 NMAuthManager *nm_auth_manager_get (void);
 
 void nm_auth_manager_force_shutdown (NMAuthManager *self);
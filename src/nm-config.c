@@ -751,10 +751,12 @@ static const ConfigGroup config_groups[] = {
 		.keys = NM_MAKE_STRV (
 			NM_CONFIG_KEYFILE_KEY_MAIN_ASSUME_IPV6LL_ONLY,
 			NM_CONFIG_KEYFILE_KEY_MAIN_AUTH_POLKIT,
+			NM_CONFIG_KEYFILE_KEY_MAIN_AUTH_POLKIT_CACHE_TTL,
 			NM_CONFIG_KEYFILE_KEY_MAIN_AUTOCONNECT_RETRIES_DEFAULT,
 			NM_CONFIG_KEYFILE_KEY_MAIN_CONFIGURE_AND_QUIT,
 			NM_CONFIG_KEYFILE_KEY_MAIN_DEBUG,
 			NM_CONFIG_KEYFILE_KEY_MAIN_DHCP,
+			NM_CONFIG_KEYFILE_KEY_MAIN_DISPATCHER_PARALLEL,
 			NM_CONFIG_KEYFILE_KEY_MAIN_DNS,
 			NM_CONFIG_KEYFILE_KEY_MAIN_HOSTNAME_MODE,
 			NM_CONFIG_KEYFILE_KEY_MAIN_IGNORE_CARRIER,
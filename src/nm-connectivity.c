@@ -37,6 +37,11 @@
 
 #define HEADER_STATUS_ONLINE "X-NetworkManager-Status: online\r\n"
 
+/* the minimum time for which the addresses that systemd-resolved returned
+ * for the connectivity check host are reused. See
+ * _nm_connectivity_resolve_cache_is_fresh(). */
+#define RESOLVE_CACHE_TTL_MIN_SEC 120
+
 /*****************************************************************************/
 
 NM_UTILS_LOOKUP_STR_DEFINE_STATIC (_state_to_string, int /*NMConnectivityState*/,
@@ -92,6 +97,8 @@ struct _NMConnectivityCheckHandle {
 
 		gsize response_good_cnt;
 
+		char *resolve_cache_key;
+
 		guint curl_timer;
 		int ch_ifindex;
 	} concheck;
@@ -121,6 +128,12 @@ typedef struct {
 	CList completed_handles_lst_head;
 	NMConfig *config;
 	ConConfig *con_config;
+#if WITH_CONCHECK
+	NMDnsManager *dns_manager;
+
+	/* maps "ifindex/addr-family/host" to ResolveCacheEntry */
+	GHashTable *resolve_cache;
+#endif
 	guint interval;
 
 	bool enabled:1;
@@ -203,6 +216,108 @@ _con_config_get_response (const ConConfig *con_config)
 
 /*****************************************************************************/
 
+/**
+ * _nm_connectivity_resolve_cache_is_fresh:
+ * @timestamp_ms: the time at which the addresses were resolved
+ * @now_ms: the current time
+ * @interval: the connectivity check interval in seconds
+ *
+ * The resolved addresses of the check host are reused for further
+ * checks on the same interface and address family. The lifetime is
+ * derived from @interval, so that the next periodic check still finds
+ * them. The device delays that check by up to 5% of the interval, and
+ * the addresses were resolved a bit after the previous check started.
+ *
+ * Returns: whether addresses resolved at @timestamp_ms can still be used.
+ */
+gboolean
+_nm_connectivity_resolve_cache_is_fresh (gint64 timestamp_ms, gint64 now_ms, guint interval)
+{
+	gint64 ttl_sec;
+
+	ttl_sec = MAX ((gint64) interval + (interval / 4), RESOLVE_CACHE_TTL_MIN_SEC);
+	return now_ms < timestamp_ms + (ttl_sec * 1000);
+}
+
+/*****************************************************************************/
+
+#if WITH_CONCHECK
+
+typedef struct {
+	gint64 timestamp_ms;
+	char **host_entries;
+} ResolveCacheEntry;
+
+static void
+_resolve_cache_entry_free (gpointer data)
+{
+	ResolveCacheEntry *entry = data;
+
+	g_strfreev (entry->host_entries);
+	g_slice_free (ResolveCacheEntry, entry);
+}
+
+static void
+_resolve_cache_clear (NMConnectivity *self)
+{
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+	if (   priv->resolve_cache
+	    && g_hash_table_size (priv->resolve_cache) > 0) {
+		_LOGT ("resolve-cache: flush %u entries", g_hash_table_size (priv->resolve_cache));
+		g_hash_table_remove_all (priv->resolve_cache);
+	}
+}
+
+static void
+_resolve_cache_dns_config_changed_cb (NMDnsManager *dns_manager,
+                                      gpointer user_data)
+{
+	_resolve_cache_clear (user_data);
+}
+
+static const ResolveCacheEntry *
+_resolve_cache_lookup (NMConnectivity *self, const char *key)
+{
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+	ResolveCacheEntry *entry;
+
+	if (!priv->resolve_cache)
+		return NULL;
+
+	entry = g_hash_table_lookup (priv->resolve_cache, key);
+	if (   entry
+	    && !_nm_connectivity_resolve_cache_is_fresh (entry->timestamp_ms,
+	                                                 nm_utils_get_monotonic_timestamp_ms (),
+	                                                 priv->interval)) {
+		g_hash_table_remove (priv->resolve_cache, key);
+		return NULL;
+	}
+	return entry;
+}
+
+static void
+_resolve_cache_add (NMConnectivity *self, const char *key, GPtrArray *host_entries)
+{
+	NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+	ResolveCacheEntry *entry;
+
+	if (!priv->resolve_cache) {
+		priv->resolve_cache = g_hash_table_new_full (nm_str_hash, g_str_equal,
+		                                             g_free, _resolve_cache_entry_free);
+	}
+
+	entry = g_slice_new (ResolveCacheEntry);
+	entry->timestamp_ms = nm_utils_get_monotonic_timestamp_ms ();
+	g_ptr_array_add (host_entries, NULL);
+	entry->host_entries = (char **) g_ptr_array_free (host_entries, FALSE);
+	g_hash_table_insert (priv->resolve_cache, g_strdup (key), entry);
+}
+
+#endif
+
+/*****************************************************************************/
+
 static void
 cb_data_complete (NMConnectivityCheckHandle *cb_data,
                   NMConnectivityState state,
@@ -250,6 +365,18 @@ cb_data_complete (NMConnectivityCheckHandle *cb_data,
 	}
 	nm_clear_g_source (&cb_data->concheck.curl_timer);
 	nm_clear_g_cancellable (&cb_data->concheck.resolve_cancellable);
+
+	if (   cb_data->concheck.resolve_cache_key
+	    && NM_IN_SET (state, NM_CONNECTIVITY_LIMITED,
+	                         NM_CONNECTIVITY_PORTAL,
+	                         NM_CONNECTIVITY_ERROR)) {
+		NMConnectivityPrivate *priv = NM_CONNECTIVITY_GET_PRIVATE (self);
+
+		/* the check did not succeed. Don't reuse the addresses that we
+		 * used, the next check shall resolve the name anew. */
+		if (priv->resolve_cache)
+			g_hash_table_remove (priv->resolve_cache, cb_data->concheck.resolve_cache_key);
+	}
 #endif
 
 	nm_clear_g_source (&cb_data->timeout_id);
@@ -269,6 +396,7 @@ cb_data_complete (NMConnectivityCheckHandle *cb_data,
 
 #if WITH_CONCHECK
 	_con_config_unref (cb_data->concheck.con_config);
+	g_free (cb_data->concheck.resolve_cache_key);
 #endif
 	g_free (cb_data->ifspec);
 	if (cb_data->completed_log_message_free)
@@ -744,6 +872,7 @@ resolve_cb (GObject *object, GAsyncResult *res, gpointer user_data)
 	int addr_family;
 	gsize len = 0;
 	gsize i;
+	GPtrArray *host_entries;
 	gs_free_error GError *error = NULL;
 
 	result = g_dbus_connection_call_finish (G_DBUS_CONNECTION (object), res, &error);
@@ -764,6 +893,8 @@ resolve_cb (GObject *object, GAsyncResult *res, gpointer user_data)
 	addresses = g_variant_get_child_value (result, 0);
 	no_addresses = g_variant_n_children (addresses);
 
+	host_entries = g_ptr_array_new_with_free_func (g_free);
+
 	for (i = 0; i < no_addresses; i++) {
 		gs_unref_variant GVariant *address = NULL;
 		char str_addr[NM_UTILS_INET_ADDRSTRLEN];
@@ -787,8 +918,14 @@ resolve_cb (GObject *object, GAsyncResult *res, gpointer user_data)
 		                              nm_utils_inet_ntop (addr_family, address_buf, str_addr));
 		cb_data->concheck.hosts = curl_slist_append (cb_data->concheck.hosts, host_entry);
 		_LOG2T ("adding '%s' to curl resolve list", host_entry);
+		g_ptr_array_add (host_entries, g_steal_pointer (&host_entry));
 	}
 
+	if (host_entries->len > 0)
+		_resolve_cache_add (cb_data->self, cb_data->concheck.resolve_cache_key, host_entries);
+	else
+		g_ptr_array_unref (host_entries);
+
 	do_curl_request (cb_data);
 }
 
@@ -831,6 +968,7 @@ nm_connectivity_check_start (NMConnectivity *self,
 	    && priv->enabled
 	    && priv->uri_valid) {
 		gboolean has_systemd_resolved;
+		const ResolveCacheEntry *cache_entry;
 
 		cb_data->concheck.ch_ifindex = ifindex;
 
@@ -857,6 +995,31 @@ nm_connectivity_check_start (NMConnectivity *self,
 				return cb_data;
 			}
 
+			if (!priv->dns_manager) {
+				priv->dns_manager = g_object_ref (nm_dns_manager_get ());
+				g_signal_connect (priv->dns_manager,
+				                  NM_DNS_MANAGER_CONFIG_CHANGED,
+				                  G_CALLBACK (_resolve_cache_dns_config_changed_cb),
+				                  self);
+			}
+
+			cb_data->concheck.resolve_cache_key = g_strdup_printf ("%d/%d/%s",
+			                                                       ifindex,
+			                                                       addr_family,
+			                                                       cb_data->concheck.con_config->host);
+			cache_entry = _resolve_cache_lookup (self, cb_data->concheck.resolve_cache_key);
+			if (cache_entry) {
+				char **iter;
+
+				for (iter = cache_entry->host_entries; *iter; iter++)
+					cb_data->concheck.hosts = curl_slist_append (cb_data->concheck.hosts, *iter);
+				_LOG2D ("start request to '%s' (using cached addresses for '%s')",
+				        cb_data->concheck.con_config->uri,
+				        cb_data->concheck.con_config->host);
+				do_curl_request (cb_data);
+				return cb_data;
+			}
+
 			cb_data->concheck.resolve_cancellable = g_cancellable_new ();
 
 			g_dbus_connection_call (nm_dbus_manager_get_dbus_connection (nm_dbus_manager_get ()),
@@ -1065,6 +1228,11 @@ update_config (NMConnectivity *self, NMConfigData *config_data)
 		changed = TRUE;
 	}
 
+#if WITH_CONCHECK
+	if (changed)
+		_resolve_cache_clear (self);
+#endif
+
 	if (changed)
 		g_signal_emit (self, signals[CONFIG_CHANGED], 0);
 }
@@ -1126,6 +1294,12 @@ dispose (GObject *object)
 	nm_clear_pointer (&priv->con_config, _con_config_unref);
 
 #if WITH_CONCHECK
+	if (priv->dns_manager) {
+		g_signal_handlers_disconnect_by_func (priv->dns_manager, _resolve_cache_dns_config_changed_cb, self);
+		g_clear_object (&priv->dns_manager);
+	}
+	nm_clear_pointer (&priv->resolve_cache, g_hash_table_unref);
+
 	curl_global_cleanup ();
 #endif
 
@@ -81,4 +81,10 @@ NMConnectivityCheckHandle *nm_connectivity_check_start (NMConnectivity *self,
 
 void nm_connectivity_check_cancel (NMConnectivityCheckHandle *handle);
 
+/*****************************************************************************/
+
+gboolean _nm_connectivity_resolve_cache_is_fresh (gint64 timestamp_ms,
+                                                  gint64 now_ms,
+                                                  guint interval);
+
 #endif /* __NETWORKMANAGER_CONNECTIVITY_H__ */
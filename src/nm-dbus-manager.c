@@ -81,6 +81,20 @@ typedef struct {
 	GDBusConnection *connection;
 	GDBusProxy *proxy;
 	guint objmgr_registration_id;
+
+	/* the serialized reply for GetManagedObjects(), built from the per-object
+	 * entries in NMDBusObjectInternal.objmgr_entry. */
+	GVariant *objmgr_reply;
+
+	struct {
+		/* objects with deferred property changes. */
+		CList lst_head;
+		guint timeout_id;
+		gint64 timeout_at_ms;
+		guint64 n_suppressed;
+		guint64 n_deferred;
+	} rate_limit;
+
 	bool started:1;
 	bool shutting_down:1;
 } NMDBusManagerPrivate;
@@ -873,6 +887,17 @@ dbus_vtable_method_call (GDBusConnection *connection,
 	                     parameters);
 }
 
+static void
+_objmgr_cache_invalidate (NMDBusManager *self,
+                          NMDBusObject *obj)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+
+	if (obj)
+		nm_clear_g_variant (&obj->internal.objmgr_entry);
+	nm_clear_g_variant (&priv->objmgr_reply);
+}
+
 static GVariant *
 _obj_get_property (RegistrationData *reg_data,
                    guint property_idx,
@@ -884,9 +909,10 @@ _obj_get_property (RegistrationData *reg_data,
 
 	property_info = (const NMDBusPropertyInfoExtended *) (interface_info->parent.properties[property_idx]);
 
-	if (refetch)
+	if (refetch) {
 		nm_clear_g_variant (&reg_data->property_cache[property_idx].value);
-	else {
+		_objmgr_cache_invalidate (reg_data->obj->internal.bus_manager, reg_data->obj);
+	} else {
 		value = reg_data->property_cache[property_idx].value;
 		if (value)
 			goto out;
@@ -1006,6 +1032,8 @@ _obj_register (NMDBusManager *self,
 
 	nm_assert (!c_list_is_empty (&obj->internal.registration_lst_head));
 
+	_objmgr_cache_invalidate (self, obj);
+
 	/* Currently the interfaces of an object do not changed and strictly depend on the object glib type.
 	 * We don't need more flixibility, and it simplifies the code. Hence, now emit interface-added
 	 * signal for the new object.
@@ -1049,6 +1077,8 @@ _obj_unregister (NMDBusManager *self,
 	nm_assert (!c_list_is_empty (&obj->internal.registration_lst_head));
 	nm_assert (priv->objmgr_registration_id);
 
+	_objmgr_cache_invalidate (self, obj);
+
 	g_variant_builder_init (&builder, G_VARIANT_TYPE ("as"));
 
 	while ((reg_data = c_list_last_entry (&obj->internal.registration_lst_head, RegistrationData, registration_lst))) {
@@ -1103,6 +1133,188 @@ nm_dbus_manager_lookup_object (NMDBusManager *self, const char *path)
 	return obj;
 }
 
+/*****************************************************************************/
+
+/* When a rate limited property becomes due while other deferred properties
+ * are due shortly after, emit them together. This reduces the number of
+ * wakeups for both the daemon and the clients. */
+#define RATE_LIMIT_SLACK_MS 250
+
+typedef struct {
+	const NMDBusPropertyInfoExtended *property_info;
+	const GParamSpec *pspec;
+	gint64 last_emit_ms;
+	bool pending:1;
+} RateLimitEntry;
+
+struct _NMDBusObjectRateLimit {
+	guint len;
+	RateLimitEntry entries[];
+};
+
+static gboolean _rate_limit_timeout_cb (gpointer user_data);
+
+static RateLimitEntry *
+_rate_limit_entry_get (NMDBusObject *obj,
+                       const NMDBusPropertyInfoExtended *property_info)
+{
+	struct _NMDBusObjectRateLimit *rl = obj->internal.rate_limit;
+	guint i;
+
+	if (rl) {
+		for (i = 0; i < rl->len; i++) {
+			if (rl->entries[i].property_info == property_info)
+				return &rl->entries[i];
+		}
+	}
+
+	/* there are only few rate limited properties per object. Grow one by one. */
+	i = rl ? rl->len : 0;
+	rl = g_realloc (rl, sizeof (struct _NMDBusObjectRateLimit) + (i + 1) * sizeof (RateLimitEntry));
+	rl->len = i + 1;
+	rl->entries[i] = (RateLimitEntry) {
+		.property_info = property_info,
+		.last_emit_ms  = G_MININT64 / 2,
+	};
+	obj->internal.rate_limit = rl;
+	return &rl->entries[i];
+}
+
+static void
+_rate_limit_schedule (NMDBusManager *self, gint64 now_ms)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	struct _NMDBusObjectInternal *internal;
+	gint64 next_ms = G_MAXINT64;
+	guint i;
+
+	c_list_for_each_entry (internal, &priv->rate_limit.lst_head, rate_limit_lst) {
+		for (i = 0; i < internal->rate_limit->len; i++) {
+			const RateLimitEntry *e = &internal->rate_limit->entries[i];
+
+			if (e->pending)
+				next_ms = NM_MIN (next_ms, e->last_emit_ms + e->property_info->rate_limit_ms);
+		}
+	}
+
+	if (next_ms == G_MAXINT64) {
+		nm_clear_g_source (&priv->rate_limit.timeout_id);
+		return;
+	}
+
+	if (   priv->rate_limit.timeout_id
+	    && priv->rate_limit.timeout_at_ms <= next_ms)
+		return;
+
+	nm_clear_g_source (&priv->rate_limit.timeout_id);
+	priv->rate_limit.timeout_at_ms = next_ms;
+	priv->rate_limit.timeout_id = g_timeout_add (NM_MAX (next_ms - now_ms, 0), _rate_limit_timeout_cb, self);
+}
+
+/* Returns %TRUE if the change of the property can be emitted now. Otherwise,
+ * the change is remembered and emitted once the rate limit allows. */
+static gboolean
+_rate_limit_check (NMDBusManager *self,
+                   NMDBusObject *obj,
+                   const NMDBusPropertyInfoExtended *property_info,
+                   const GParamSpec *pspec,
+                   gint64 *p_now_ms)
+{
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	RateLimitEntry *e;
+
+	nm_assert (property_info->rate_limit_ms > 0);
+
+	e = _rate_limit_entry_get (obj, property_info);
+
+	if (*p_now_ms == 0)
+		*p_now_ms = nm_utils_get_monotonic_timestamp_ms ();
+
+	if (*p_now_ms >= e->last_emit_ms + property_info->rate_limit_ms) {
+		e->last_emit_ms = *p_now_ms;
+		e->pending = FALSE;
+		return TRUE;
+	}
+
+	priv->rate_limit.n_suppressed++;
+	if (!e->pending) {
+		e->pending = TRUE;
+		e->pspec = pspec;
+		if (c_list_is_empty (&obj->internal.rate_limit_lst))
+			c_list_link_tail (&priv->rate_limit.lst_head, &obj->internal.rate_limit_lst);
+		_rate_limit_schedule (self, *p_now_ms);
+	}
+	return FALSE;
+}
+
+static gboolean
+_rate_limit_timeout_cb (gpointer user_data)
+{
+	NMDBusManager *self = user_data;
+	NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE (self);
+	struct _NMDBusObjectInternal *internal, *internal_safe;
+	gint64 now_ms;
+	guint n_emitted = 0;
+
+	priv->rate_limit.timeout_id = 0;
+
+	now_ms = nm_utils_get_monotonic_timestamp_ms ();
+
+	c_list_for_each_entry_safe (internal, internal_safe, &priv->rate_limit.lst_head, rate_limit_lst) {
+		NMDBusObject *obj = (NMDBusObject *) (((char *) internal) - G_STRUCT_OFFSET (NMDBusObject, internal));
+		gs_free const GParamSpec **pspecs = NULL;
+		gboolean any_pending = FALSE;
+		guint n_pspecs = 0;
+		guint i;
+
+		for (i = 0; i < internal->rate_limit->len; i++) {
+			RateLimitEntry *e = &internal->rate_limit->entries[i];
+
+			if (!e->pending)
+				continue;
+			if (now_ms + RATE_LIMIT_SLACK_MS < e->last_emit_ms + e->property_info->rate_limit_ms) {
+				any_pending = TRUE;
+				continue;
+			}
+
+			/* let _rate_limit_check() pass. */
+			e->last_emit_ms = now_ms - e->property_info->rate_limit_ms;
+			if (!pspecs)
+				pspecs = g_new (const GParamSpec *, internal->rate_limit->len);
+			pspecs[n_pspecs++] = e->pspec;
+		}
+
+		if (!any_pending)
+			c_list_unlink (&internal->rate_limit_lst);
+
+		if (n_pspecs > 0) {
+			n_emitted += n_pspecs;
+			_nm_dbus_manager_obj_notify (obj, n_pspecs, pspecs);
+		}
+	}
+
+	priv->rate_limit.n_deferred += n_emitted;
+	_LOGT ("rate-limit: emitted %u deferred property changes (%"G_GUINT64_FORMAT" deferred, %"G_GUINT64_FORMAT" suppressed in total)",
+	       n_emitted,
+	       priv->rate_limit.n_deferred,
+	       priv->rate_limit.n_suppressed);
+
+	_rate_limit_schedule (self, now_ms);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_rate_limit_clear (NMDBusManager *self, NMDBusObject *obj)
+{
+	if (!c_list_is_empty (&obj->internal.rate_limit_lst)) {
+		c_list_unlink (&obj->internal.rate_limit_lst);
+		_rate_limit_schedule (self, nm_utils_get_monotonic_timestamp_ms ());
+	}
+	nm_clear_g_free (&obj->internal.rate_limit);
+}
+
+/*****************************************************************************/
+
 void
 _nm_dbus_manager_obj_export (NMDBusObject *obj)
 {
@@ -1121,6 +1333,7 @@ _nm_dbus_manager_obj_export (NMDBusObject *obj)
 	if (!g_hash_table_add (priv->objects_by_path, &obj->internal))
 		nm_assert_not_reached ();
 	c_list_link_tail (&priv->objects_lst_head, &obj->internal.objects_lst);
+	_objmgr_cache_invalidate (self, NULL);
 
 	if (priv->connection && priv->started)
 		_obj_register (self, obj);
@@ -1145,6 +1358,9 @@ _nm_dbus_manager_obj_unexport (NMDBusObject *obj)
 
 	_obj_unregister (self, obj);
 
+	_rate_limit_clear (self, obj);
+	_objmgr_cache_invalidate (self, obj);
+
 	if (!g_hash_table_remove (priv->objects_by_path, &obj->internal))
 		nm_assert_not_reached ();
 	c_list_unlink (&obj->internal.objects_lst);
@@ -1163,6 +1379,7 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 	gboolean any_legacy_properties = FALSE;
 	GVariantBuilder legacy_builder;
 	GVariant *device_statistics_args = NULL;
+	gint64 now_ms = 0;
 
 	nm_assert (NM_IS_DBUS_OBJECT (obj));
 	nm_assert (obj->internal.path);
@@ -1206,6 +1423,10 @@ _nm_dbus_manager_obj_notify (NMDBusObject *obj,
 				if (!nm_streq (property_info->property_name, pspec->name))
 					continue;
 
+				if (   property_info->rate_limit_ms > 0
+				    && !_rate_limit_check (self, obj, property_info, pspec, &now_ms))
+					continue;
+
 				value = _obj_get_property (reg_data, i, TRUE);
 
 				if (   property_info->include_in_legacy_property_changed
@@ -1410,24 +1631,34 @@ dbus_vtable_objmgr_method_call (GDBusConnection *connection,
 		return;
 	}
 
-	g_variant_builder_init (&array_builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
-	c_list_for_each_entry (obj, &priv->objects_lst_head, internal.objects_lst) {
-		GVariantBuilder interfaces_builder;
-
-		/* note that we are called on an idle handler. Hence, all properties are
-		 * supposed to be in a consistent state. That is true, if you always
-		 * g_object_thaw_notify() before returning to the mainloop. Keeping
-		 * signals frozen between while returning from the current call stack
-		 * is anyway a very fragile thing, easy to get wrong. Don't do that. */
-		g_variant_builder_add (&array_builder,
-		                       "{oa{sa{sv}}}",
-		                       obj->internal.path,
-		                       _obj_collect_properties_all (obj,
-		                                                    &interfaces_builder));
+	/* GetManagedObjects() is called by every client on startup, often several at
+	 * once. Keep the serialized reply around and only rebuild the entries of objects
+	 * whose properties changed in the meantime. */
+	if (!priv->objmgr_reply) {
+		g_variant_builder_init (&array_builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+		c_list_for_each_entry (obj, &priv->objects_lst_head, internal.objects_lst) {
+			GVariantBuilder interfaces_builder;
+
+			if (!obj->internal.objmgr_entry) {
+				/* note that we are called on an idle handler. Hence, all properties are
+				 * supposed to be in a consistent state. That is true, if you always
+				 * g_object_thaw_notify() before returning to the mainloop. Keeping
+				 * signals frozen between while returning from the current call stack
+				 * is anyway a very fragile thing, easy to get wrong. Don't do that. */
+				obj->internal.objmgr_entry = g_variant_ref_sink (g_variant_new ("{oa{sa{sv}}}",
+				                                                                obj->internal.path,
+				                                                                _obj_collect_properties_all (obj,
+				                                                                                             &interfaces_builder)));
+			}
+			g_variant_builder_add_value (&array_builder, obj->internal.objmgr_entry);
+		}
+		priv->objmgr_reply = g_variant_ref_sink (g_variant_new ("(a{oa{sa{sv}}})",
+		                                                        &array_builder));
 	}
+
+	/* the reply is not floating, GDBus takes its own reference. */
 	g_dbus_method_invocation_return_value (invocation,
-	                                       g_variant_new ("(a{oa{sa{sv}}})",
-	                                                      &array_builder));
+	                                       priv->objmgr_reply);
 }
 
 static const GDBusInterfaceVTable dbus_vtable_objmgr = {
@@ -1619,6 +1850,7 @@ nm_dbus_manager_init (NMDBusManager *self)
 
 	c_list_init (&priv->private_servers_lst_head);
 	c_list_init (&priv->objects_lst_head);
+	c_list_init (&priv->rate_limit.lst_head);
 	priv->objects_by_path = g_hash_table_new ((GHashFunc) _objects_by_path_hash, (GEqualFunc) _objects_by_path_equal);
 }
 
@@ -1636,6 +1868,11 @@ dispose (GObject *object)
 
 	g_clear_pointer (&priv->objects_by_path, g_hash_table_destroy);
 
+	nm_clear_g_variant (&priv->objmgr_reply);
+
+	nm_assert (c_list_is_empty (&priv->rate_limit.lst_head));
+	nm_clear_g_source (&priv->rate_limit.timeout_id);
+
 	c_list_for_each_entry_safe (s, s_safe, &priv->private_servers_lst_head, private_servers_lst)
 		private_server_free (s);
 
@@ -95,6 +95,16 @@ struct _NMDBusObjectInternal {
 	 * unexported, or even re-exported afterwards. If that happens, we want
 	 * to fail the request. For that, we keep track of a version id.  */
 	guint64 export_version_id;
+
+	/* the state for properties with a rate limit, see "rate_limit_ms". Only
+	 * allocated once such a property changes. Owned by NMDBusManager. */
+	struct _NMDBusObjectRateLimit *rate_limit;
+	CList rate_limit_lst;
+
+	/* the cached "{oa{sa{sv}}}" entry of this object for GetManagedObjects().
+	 * Owned by NMDBusManager and cleared whenever a property changes. */
+	GVariant *objmgr_entry;
+
 	bool is_unexporting:1;
 };
 
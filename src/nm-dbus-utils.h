@@ -34,6 +34,11 @@ struct _NMDBusPropertyInfoExtendedBase {
 	 * PropertyChanged signal. This is only to preserve API, new
 	 * properties should not use this. */
 	bool include_in_legacy_property_changed;
+
+	/* If non-zero, the PropertiesChanged signal for this property is emitted
+	 * at most once per rate_limit_ms. Changes in between are coalesced and
+	 * the latest value is emitted once the interval passed. */
+	guint32 rate_limit_ms;
 };
 
 struct _NMDBusPropertyInfoExtendedReadWritable {
@@ -64,14 +69,17 @@ typedef struct {
 			 * PropertyChanged signal. This is only to preserve API, new
 			 * properties should not use this. */
 			bool include_in_legacy_property_changed;
+
+			guint32 rate_limit_ms;
 		};
 	};
 } NMDBusPropertyInfoExtended;
 
 G_STATIC_ASSERT (G_STRUCT_OFFSET (NMDBusPropertyInfoExtended, property_name) == G_STRUCT_OFFSET (struct _NMDBusPropertyInfoExtendedBase, property_name));
 G_STATIC_ASSERT (G_STRUCT_OFFSET (NMDBusPropertyInfoExtended, include_in_legacy_property_changed) == G_STRUCT_OFFSET (struct _NMDBusPropertyInfoExtendedBase, include_in_legacy_property_changed));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (NMDBusPropertyInfoExtended, rate_limit_ms) == G_STRUCT_OFFSET (struct _NMDBusPropertyInfoExtendedBase, rate_limit_ms));
 
-#define NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_FULL(m_name, m_signature, m_property_name, m_include_in_legacy_property_changed) \
+#define _NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE(m_name, m_signature, m_property_name, m_include_in_legacy_property_changed, m_rate_limit_ms) \
 	((GDBusPropertyInfo *) &((const struct _NMDBusPropertyInfoExtendedBase) { \
 		._parent = { \
 			.ref_count = -1, \
@@ -81,8 +89,22 @@ G_STATIC_ASSERT (G_STRUCT_OFFSET (NMDBusPropertyInfoExtended, include_in_legacy_
 		}, \
 		.property_name = m_property_name, \
 		.include_in_legacy_property_changed = m_include_in_legacy_property_changed, \
+		.rate_limit_ms = m_rate_limit_ms, \
 	}))
 
+#define NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_FULL(m_name, m_signature, m_property_name, m_include_in_legacy_property_changed) \
+	_NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE (m_name, m_signature, m_property_name, m_include_in_legacy_property_changed, 0)
+
+/* define a property whose changes are notified at most once per @m_rate_limit_ms.
+ * Use this for properties that change often but are not important to be notified
+ * about immediately, like the signal strength of an access point. */
+#define NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_RATE_LIMITED(m_name, m_signature, m_property_name, m_rate_limit_ms) \
+	_NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE (m_name, m_signature, m_property_name, FALSE, m_rate_limit_ms)
+
+/* like NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_RATE_LIMITED(), but for a legacy property. */
+#define NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_RATE_LIMITED_L(m_name, m_signature, m_property_name, m_rate_limit_ms) \
+	_NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE (m_name, m_signature, m_property_name, TRUE, m_rate_limit_ms)
+
 #define NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE(m_name, m_signature, m_property_name) \
 	NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_FULL (m_name, m_signature, m_property_name, FALSE)
 
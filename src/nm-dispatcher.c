@@ -35,6 +35,7 @@
 #include "nm-ip4-config.h"
 #include "nm-ip6-config.h"
 #include "nm-manager.h"
+#include "nm-config.h"
 #include "settings/nm-settings-connection.h"
 #include "platform/nm-platform.h"
 #include "nm-core-internal.h"
@@ -46,6 +47,8 @@
 
 static GDBusProxy *dispatcher_proxy;
 static GHashTable *requests = NULL;
+static GHashTable *coalesce_infos = NULL;
+static NMDispatcherNmtstSendFunc nmtst_send_func = NULL;
 
 typedef struct {
 	GFileMonitor *monitor;
@@ -329,6 +332,10 @@ typedef struct {
 	NMDispatcherFunc callback;
 	gpointer user_data;
 	guint idle_id;
+
+	/* the parameters for Action(), kept for retrying with an older
+	 * nm-dispatcher that doesn't know Action2(). */
+	GVariant *parameters;
 } DispatchInfo;
 
 static void
@@ -336,6 +343,8 @@ dispatcher_info_free (DispatchInfo *info)
 {
 	if (info->idle_id)
 		g_source_remove (info->idle_id);
+	if (info->parameters)
+		g_variant_unref (info->parameters);
 	g_free (info);
 }
 
@@ -375,21 +384,39 @@ dispatch_result_to_string (DispatchResult result)
 }
 
 static void
-dispatcher_results_process (guint request_id, NMDispatcherAction action, GVariantIter *results)
+dispatcher_results_process (guint request_id,
+                            NMDispatcherAction action,
+                            GVariant *v_results,
+                            GVariant *v_durations)
 {
 	const char *script, *err;
 	guint32 result;
 	const Monitor *monitor = _get_monitor_by_action (action);
+	const guint64 *durations = NULL;
+	gsize n_durations = 0;
+	gsize i, n;
 
-	g_return_if_fail (results != NULL);
+	g_return_if_fail (v_results != NULL);
 
-	if (g_variant_iter_n_children (results) == 0) {
+	n = g_variant_n_children (v_results);
+	if (n == 0) {
 		_LOGD ("(%u) succeeded but no scripts invoked", request_id);
 		return;
 	}
 
-	while (g_variant_iter_next (results, "(&su&s)", &script, &result, &err)) {
+	if (v_durations)
+		durations = g_variant_get_fixed_array (v_durations, &n_durations, sizeof (guint64));
+
+	for (i = 0; i < n; i++) {
 		const char *script_validation_msg = "";
+		char duration_buf[50];
+
+		g_variant_get_child (v_results, i, "(&su&s)", &script, &result, &err);
+
+		if (i < n_durations)
+			nm_sprintf_buf (duration_buf, " (%"G_GUINT64_FORMAT" msec)", durations[i] / 1000);
+		else
+			duration_buf[0] = '\0';
 
 		if (!*script) {
 			script_validation_msg = " (path is NULL)";
@@ -404,35 +431,99 @@ dispatcher_results_process (guint request_id, NMDispatcherAction action, GVarian
 			script_validation_msg = " (unexpected path)";
 
 		if (result == DISPATCH_RESULT_SUCCESS) {
-			_LOGD ("(%u) %s succeeded%s",
+			_LOGD ("(%u) %s succeeded%s%s",
 			       request_id,
-			       script, script_validation_msg);
+			       script, duration_buf, script_validation_msg);
 		} else {
-			_LOGW ("(%u) %s failed (%s): %s%s",
+			_LOGW ("(%u) %s failed (%s): %s%s%s",
 			       request_id,
 			       script,
 			       dispatch_result_to_string (result),
 			       err,
+			       duration_buf,
 			       script_validation_msg);
 		}
 	}
 }
 
+static void
+dispatcher_reply_process (guint request_id,
+                          NMDispatcherAction action,
+                          GVariant *ret)
+{
+	gs_unref_variant GVariant *v_results = NULL;
+	gs_unref_variant GVariant *v_durations = NULL;
+
+	/* Action2() also returns the durations of the scripts, Action()
+	 * doesn't. */
+	if (g_variant_n_children (ret) > 1)
+		g_variant_get (ret, "(@a(sus)@at)", &v_results, &v_durations);
+	else
+		g_variant_get (ret, "(@a(sus))", &v_results);
+
+	dispatcher_results_process (request_id, action, v_results, v_durations);
+}
+
+static GVariant *
+dispatcher_action2_parameters (GVariant *parameters)
+{
+	GVariantBuilder builder;
+	GVariantBuilder options;
+	GVariantIter iter;
+	GVariant *child;
+	gint64 parallel;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_TUPLE);
+	g_variant_iter_init (&iter, parameters);
+	while ((child = g_variant_iter_next_value (&iter))) {
+		g_variant_builder_add_value (&builder, child);
+		g_variant_unref (child);
+	}
+
+	g_variant_builder_init (&options, G_VARIANT_TYPE_VARDICT);
+	parallel = nm_config_data_get_value_int64 (NM_CONFIG_GET_DATA,
+	                                           NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                           NM_CONFIG_KEYFILE_KEY_MAIN_DISPATCHER_PARALLEL,
+	                                           10, 1, G_MAXUINT32, 0);
+	if (parallel > 0) {
+		g_variant_builder_add (&options, "{sv}",
+		                       NMD_OPTION_PARALLEL,
+		                       g_variant_new_uint32 (parallel));
+	}
+	g_variant_builder_add_value (&builder, g_variant_builder_end (&options));
+
+	return g_variant_builder_end (&builder);
+}
+
 static void
 dispatcher_done_cb (GObject *proxy, GAsyncResult *result, gpointer user_data)
 {
 	DispatchInfo *info = user_data;
 	GVariant *ret;
-	GVariantIter *results;
 	GError *error = NULL;
+	gboolean is_action2 = !!info->parameters;
 
 	ret = _nm_dbus_proxy_call_finish (G_DBUS_PROXY (proxy), result,
-	                                  G_VARIANT_TYPE ("(a(sus))"),
+	                                  is_action2
+	                                    ? G_VARIANT_TYPE ("(a(sus)at)")
+	                                    : G_VARIANT_TYPE ("(a(sus))"),
 	                                  &error);
+	if (   !ret
+	    && is_action2
+	    && g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD)) {
+		gs_unref_variant GVariant *parameters = g_steal_pointer (&info->parameters);
+
+		/* an older nm-dispatcher. Retry with Action(). */
+		g_clear_error (&error);
+		g_dbus_proxy_call (G_DBUS_PROXY (proxy), "Action",
+		                   parameters,
+		                   G_DBUS_CALL_FLAGS_NONE, CALL_TIMEOUT,
+		                   NULL, dispatcher_done_cb, info);
+		return;
+	}
+
 	if (ret) {
-		g_variant_get (ret, "(a(sus))", &results);
-		dispatcher_results_process (info->request_id, info->action, results);
-		g_variant_iter_free (results);
+		dispatcher_reply_process (info->request_id, info->action, ret);
 		g_variant_unref (ret);
 	} else {
 		if (_nm_dbus_error_has_name (error, "org.freedesktop.systemd1.LoadFailed")) {
@@ -513,6 +604,7 @@ _dispatcher_call (NMDispatcherAction action,
 	GVariantBuilder vpn_proxy_props;
 	GVariantBuilder vpn_ip4_props;
 	GVariantBuilder vpn_ip6_props;
+	GVariant *parameters;
 	DispatchInfo *info = NULL;
 	gboolean success = FALSE;
 	GError *error = NULL;
@@ -630,35 +722,45 @@ _dispatcher_call (NMDispatcherAction action,
 
 	connectivity_state_string = nm_connectivity_state_to_string (connectivity_state);
 
-	/* Send the action to the dispatcher */
+	parameters = g_variant_ref_sink (g_variant_new ("(s@a{sa{sv}}a{sv}a{sv}a{sv}a{sv}a{sv}@a{sv}@a{sv}ssa{sv}a{sv}a{sv}b)",
+	                                                action_to_string (action),
+	                                                connection_dict,
+	                                                &connection_props,
+	                                                &device_props,
+	                                                &device_proxy_props,
+	                                                &device_ip4_props,
+	                                                &device_ip6_props,
+	                                                device_dhcp4_props,
+	                                                device_dhcp6_props,
+	                                                connectivity_state_string,
+	                                                vpn_iface ?: "",
+	                                                &vpn_proxy_props,
+	                                                &vpn_ip4_props,
+	                                                &vpn_ip6_props,
+	                                                nm_logging_enabled (LOGL_DEBUG, LOGD_DISPATCH)));
+
+	/* Send the action to the dispatcher. Action2() additionally passes
+	 * options and returns the durations of the scripts. Fall back to
+	 * Action() for an older nm-dispatcher. */
 	if (blocking) {
 		GVariant *ret;
-		GVariantIter *results;
-
-		ret = _nm_dbus_proxy_call_sync (dispatcher_proxy, "Action",
-		                                g_variant_new ("(s@a{sa{sv}}a{sv}a{sv}a{sv}a{sv}a{sv}@a{sv}@a{sv}ssa{sv}a{sv}a{sv}b)",
-		                                               action_to_string (action),
-		                                               connection_dict,
-		                                               &connection_props,
-		                                               &device_props,
-		                                               &device_proxy_props,
-		                                               &device_ip4_props,
-		                                               &device_ip6_props,
-		                                               device_dhcp4_props,
-		                                               device_dhcp6_props,
-		                                               connectivity_state_string,
-		                                               vpn_iface ?: "",
-		                                               &vpn_proxy_props,
-		                                               &vpn_ip4_props,
-		                                               &vpn_ip6_props,
-		                                               nm_logging_enabled (LOGL_DEBUG, LOGD_DISPATCH)),
-		                                G_VARIANT_TYPE ("(a(sus))"),
+
+		ret = _nm_dbus_proxy_call_sync (dispatcher_proxy, "Action2",
+		                                dispatcher_action2_parameters (parameters),
+		                                G_VARIANT_TYPE ("(a(sus)at)"),
 		                                G_DBUS_CALL_FLAGS_NONE, CALL_TIMEOUT,
 		                                NULL, &error);
+		if (   !ret
+		    && g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD)) {
+			g_clear_error (&error);
+			ret = _nm_dbus_proxy_call_sync (dispatcher_proxy, "Action",
+			                                parameters,
+			                                G_VARIANT_TYPE ("(a(sus))"),
+			                                G_DBUS_CALL_FLAGS_NONE, CALL_TIMEOUT,
+			                                NULL, &error);
+		}
 		if (ret) {
-			g_variant_get (ret, "(a(sus))", &results);
-			dispatcher_results_process (reqid, action, results);
-			g_variant_iter_free (results);
+			dispatcher_reply_process (reqid, action, ret);
 			g_variant_unref (ret);
 			success = TRUE;
 		} else {
@@ -667,29 +769,16 @@ _dispatcher_call (NMDispatcherAction action,
 			g_clear_error (&error);
 			success = FALSE;
 		}
+		g_variant_unref (parameters);
 	} else {
 		info = g_malloc0 (sizeof (*info));
 		info->action = action;
 		info->request_id = reqid;
 		info->callback = callback;
 		info->user_data = user_data;
-		g_dbus_proxy_call (dispatcher_proxy, "Action",
-		                   g_variant_new ("(s@a{sa{sv}}a{sv}a{sv}a{sv}a{sv}a{sv}@a{sv}@a{sv}ssa{sv}a{sv}a{sv}b)",
-		                                  action_to_string (action),
-		                                  connection_dict,
-		                                  &connection_props,
-		                                  &device_props,
-		                                  &device_proxy_props,
-		                                  &device_ip4_props,
-		                                  &device_ip6_props,
-		                                  device_dhcp4_props,
-		                                  device_dhcp6_props,
-		                                  connectivity_state_string,
-		                                  vpn_iface ?: "",
-		                                  &vpn_proxy_props,
-		                                  &vpn_ip4_props,
-		                                  &vpn_ip6_props,
-		                                  nm_logging_enabled (LOGL_DEBUG, LOGD_DISPATCH)),
+		info->parameters = parameters;
+		g_dbus_proxy_call (dispatcher_proxy, "Action2",
+		                   dispatcher_action2_parameters (parameters),
 		                   G_DBUS_CALL_FLAGS_NONE, CALL_TIMEOUT,
 		                   NULL, dispatcher_done_cb, info);
 		success = TRUE;
@@ -733,6 +822,192 @@ nm_dispatcher_call_hostname (NMDispatcherFunc callback,
 	                         callback, user_data, out_call_id);
 }
 
+/*****************************************************************************/
+
+/* Tracks fire-and-forget "dhcp4-change"/"dhcp6-change" events of a device
+ * while a request for the same event is in flight. Further events are not
+ * sent right away, instead they are merged into one request that is issued
+ * once the pending one completes. That request then carries the latest state
+ * of the device.
+ *
+ * Scripts rely on seeing the events of a device in the order in which they
+ * happened. Hence, before any other action is dispatched for the device,
+ * a merged event that is still held back gets sent first. */
+typedef struct {
+	NMDevice *device;
+	NMDispatcherAction action;
+	guint request_id;
+	bool again:1;
+} CoalesceInfo;
+
+static guint
+_coalesce_info_hash (gconstpointer ptr)
+{
+	const CoalesceInfo *ci = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1572519437);
+	nm_hash_update_vals (&h, ci->device, ci->action);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_coalesce_info_equal (gconstpointer a, gconstpointer b)
+{
+	const CoalesceInfo *ci_a = a;
+	const CoalesceInfo *ci_b = b;
+
+	return    ci_a->device == ci_b->device
+	       && ci_a->action == ci_b->action;
+}
+
+static void
+_coalesce_info_free (gpointer ptr)
+{
+	CoalesceInfo *ci = ptr;
+
+	g_object_unref (ci->device);
+	g_slice_free (CoalesceInfo, ci);
+}
+
+static gboolean _dispatcher_call_device (NMDispatcherAction action,
+                                         NMDevice *device,
+                                         NMActRequest *act_request,
+                                         NMDispatcherFunc callback,
+                                         gpointer user_data,
+                                         guint *out_call_id);
+
+static void
+_coalesce_flush_device (NMDevice *device,
+                        NMDispatcherAction action)
+{
+	GHashTableIter iter;
+	CoalesceInfo *ci;
+
+	if (   !coalesce_infos
+	    || !g_hash_table_size (coalesce_infos))
+		return;
+
+	g_hash_table_iter_init (&iter, coalesce_infos);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &ci, NULL)) {
+		if (   ci->device != device
+		    || ci->action == action
+		    || !ci->again)
+			continue;
+
+		/* the request stays tracked by the pending one. Send this one without
+		 * callback, so that we don't merge into it anymore. */
+		ci->again = FALSE;
+		_LOGD ("(%u) (%s) dispatching coalesced action '%s' before action '%s'",
+		       ci->request_id,
+		       nm_device_get_iface (ci->device),
+		       action_to_string (ci->action),
+		       action_to_string (action));
+		_dispatcher_call_device (ci->action, ci->device, NULL,
+		                         NULL, NULL, NULL);
+	}
+}
+
+static void
+_coalesce_done_cb (guint call_id, gpointer user_data)
+{
+	CoalesceInfo *ci = user_data;
+
+	nm_assert (ci->request_id == call_id);
+
+	ci->request_id = 0;
+	if (ci->again) {
+		ci->again = FALSE;
+		_LOGD ("(%u) (%s) dispatching coalesced action '%s'",
+		       call_id,
+		       nm_device_get_iface (ci->device),
+		       action_to_string (ci->action));
+		if (_dispatcher_call_device (ci->action, ci->device, NULL,
+		                             _coalesce_done_cb, ci, &ci->request_id))
+			return;
+		ci->request_id = 0;
+	}
+
+	g_hash_table_remove (coalesce_infos, ci);
+}
+
+static gboolean
+_coalesce_call_device (NMDispatcherAction action,
+                       NMDevice *device)
+{
+	CoalesceInfo needle = {
+		.device = device,
+		.action = action,
+	};
+	CoalesceInfo *ci;
+
+	if (G_UNLIKELY (!coalesce_infos)) {
+		coalesce_infos = g_hash_table_new_full (_coalesce_info_hash,
+		                                        _coalesce_info_equal,
+		                                        _coalesce_info_free,
+		                                        NULL);
+	}
+
+	ci = g_hash_table_lookup (coalesce_infos, &needle);
+	if (ci) {
+		nm_assert (ci->request_id);
+		if (!ci->again) {
+			_LOGD ("(%u) (%s) coalescing action '%s' with pending request",
+			       ci->request_id,
+			       nm_device_get_iface (device),
+			       action_to_string (action));
+			ci->again = TRUE;
+		}
+		return TRUE;
+	}
+
+	ci = g_slice_new0 (CoalesceInfo);
+	ci->device = g_object_ref (device);
+	ci->action = action;
+	if (   !_dispatcher_call_device (action, device, NULL,
+	                                 _coalesce_done_cb, ci, &ci->request_id)
+	    || !ci->request_id) {
+		_coalesce_info_free (ci);
+		return FALSE;
+	}
+
+	g_hash_table_add (coalesce_infos, ci);
+	return TRUE;
+}
+
+/*****************************************************************************/
+
+static gboolean
+_dispatcher_call_device (NMDispatcherAction action,
+                         NMDevice *device,
+                         NMActRequest *act_request,
+                         NMDispatcherFunc callback,
+                         gpointer user_data,
+                         guint *out_call_id)
+{
+	nm_assert (NM_IS_DEVICE (device));
+
+	_coalesce_flush_device (device, action);
+
+	if (G_UNLIKELY (nmtst_send_func))
+		return nmtst_send_func (action, device, callback, user_data, out_call_id);
+
+	if (!act_request) {
+		act_request = nm_device_get_act_request (device);
+		if (!act_request)
+			return FALSE;
+	}
+	nm_assert (NM_IN_SET (nm_active_connection_get_device (NM_ACTIVE_CONNECTION (act_request)), NULL, device));
+	return _dispatcher_call (action, FALSE,
+	                         device,
+	                         nm_act_request_get_settings_connection (act_request),
+	                         nm_act_request_get_applied_connection (act_request),
+	                         nm_active_connection_get_activation_type (NM_ACTIVE_CONNECTION (act_request)) == NM_ACTIVATION_TYPE_EXTERNAL,
+	                         NM_CONNECTIVITY_UNKNOWN,
+	                         NULL, NULL, NULL, NULL,
+	                         callback, user_data, out_call_id);
+}
+
 /**
  * nm_dispatcher_call_device:
  * @action: the %NMDispatcherAction
@@ -747,6 +1022,11 @@ nm_dispatcher_call_hostname (NMDispatcherFunc callback,
  * This method always invokes the device dispatcher action asynchronously.  To ignore
  * the result, pass %NULL to @callback.
  *
+ * "dhcp4-change" and "dhcp6-change" actions without @callback and @out_call_id
+ * are coalesced: while such a request for @device is still pending, further
+ * ones are merged and sent as one request (with the then current state) after
+ * the pending one completes.
+ *
  * Returns: %TRUE if the action was dispatched, %FALSE on failure
  */
 gboolean
@@ -757,21 +1037,16 @@ nm_dispatcher_call_device (NMDispatcherAction action,
                            gpointer user_data,
                            guint *out_call_id)
 {
-	nm_assert (NM_IS_DEVICE (device));
-	if (!act_request) {
-		act_request = nm_device_get_act_request (device);
-		if (!act_request)
-			return FALSE;
-	}
-	nm_assert (NM_IN_SET (nm_active_connection_get_device (NM_ACTIVE_CONNECTION (act_request)), NULL, device));
-	return _dispatcher_call (action, FALSE,
-	                         device,
-	                         nm_act_request_get_settings_connection (act_request),
-	                         nm_act_request_get_applied_connection (act_request),
-	                         nm_active_connection_get_activation_type (NM_ACTIVE_CONNECTION (act_request)) == NM_ACTIVATION_TYPE_EXTERNAL,
-	                         NM_CONNECTIVITY_UNKNOWN,
-	                         NULL, NULL, NULL, NULL,
-	                         callback, user_data, out_call_id);
+	if (   NM_IN_SET (action, NM_DISPATCHER_ACTION_DHCP4_CHANGE,
+	                          NM_DISPATCHER_ACTION_DHCP6_CHANGE)
+	    && !callback
+	    && !out_call_id
+	    && (   !act_request
+	        || act_request == nm_device_get_act_request (device)))
+		return _coalesce_call_device (action, device);
+
+	return _dispatcher_call_device (action, device, act_request,
+	                                callback, user_data, out_call_id);
 }
 
 /**
@@ -792,6 +1067,9 @@ nm_dispatcher_call_device_sync (NMDispatcherAction action,
                                 NMActRequest *act_request)
 {
 	nm_assert (NM_IS_DEVICE (device));
+
+	_coalesce_flush_device (device, action);
+
 	if (!act_request) {
 		act_request = nm_device_get_act_request (device);
 		if (!act_request)
@@ -841,6 +1119,9 @@ nm_dispatcher_call_vpn (NMDispatcherAction action,
                         gpointer user_data,
                         guint *out_call_id)
 {
+	if (parent_device)
+		_coalesce_flush_device (parent_device, action);
+
 	return _dispatcher_call (action, FALSE,
 	                         parent_device,
 	                         settings_connection,
@@ -877,6 +1158,9 @@ nm_dispatcher_call_vpn_sync (NMDispatcherAction action,
                              NMIP4Config *vpn_ip4_config,
                              NMIP6Config *vpn_ip6_config)
 {
+	if (parent_device)
+		_coalesce_flush_device (parent_device, action);
+
 	return _dispatcher_call (action, TRUE,
 	                         parent_device,
 	                         settings_connection,
@@ -951,8 +1235,14 @@ dispatcher_dir_changed (GFileMonitor *monitor,
 		errno = 0;
 		while (!item->has_scripts
 		    && (name = g_dir_read_name (dir))) {
+			/* nm-dispatcher ignores hidden files and only executes
+			 * regular files. Especially, the subdirectories like
+			 * "no-wait.d" in the default directory are not scripts. */
+			if (name[0] == '.')
+				continue;
 			full_name = g_build_filename (item->dir, name, NULL);
-			item->has_scripts = g_file_test (full_name, G_FILE_TEST_IS_EXECUTABLE);
+			item->has_scripts =    g_file_test (full_name, G_FILE_TEST_IS_REGULAR)
+			                    && g_file_test (full_name, G_FILE_TEST_IS_EXECUTABLE);
 			g_free (full_name);
 		}
 		errsv = errno;
@@ -1009,3 +1299,13 @@ nm_dispatcher_init (void)
 	}
 }
 
+
+/*****************************************************************************/
+
+/* Replaces sending device actions to nm-dispatcher, so that unit tests can
+ * check which requests are issued and complete them. */
+void
+_nmtst_dispatcher_set_send_func (NMDispatcherNmtstSendFunc func)
+{
+	nmtst_send_func = func;
+}
@@ -86,4 +86,14 @@ void nm_dispatcher_call_cancel (guint call_id);
 
 void nm_dispatcher_init (void);
 
+/*****************************************************************************/
+
+typedef gboolean (*NMDispatcherNmtstSendFunc) (NMDispatcherAction action,
+                                               NMDevice *device,
+                                               NMDispatcherFunc callback,
+                                               gpointer user_data,
+                                               guint *out_call_id);
+
+void _nmtst_dispatcher_set_send_func (NMDispatcherNmtstSendFunc func);
+
 #endif /* __NM_DISPATCHER_H__ */
@@ -516,6 +516,7 @@ main (int argc, char *argv[])
 		                                          global_opt.dhcp4_fqdn,
 		                                          client_id,
 		                                          NM_DHCP_TIMEOUT_DEFAULT,
+		                                          0,
 		                                          NULL,
 		                                          global_opt.dhcp4_address,
 		                                          &error);
@@ -0,0 +1,295 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-ip-route-lpm.h"
+
+#include "nm-core-utils.h"
+
+/*****************************************************************************/
+
+/* A path-compressed binary trie (per route table) over the destinations of
+ * the direct routes (without gateway) of a NMIP4Config/NMIP6Config.
+ *
+ * Each node stands for a prefix. Nodes that correspond to a route prefix
+ * reference the best route for it (the one with the lowest metric, the first
+ * one on a tie). Other nodes only exist to branch. Looking up a host walks
+ * down the trie and remembers the last matching route, hence it takes at most
+ * as many steps as the address has bits, regardless of the number of routes.
+ *
+ * The index is immutable. It gets built from the routes of a config and is
+ * dropped whenever the routes change. */
+
+typedef struct _LpmNode LpmNode;
+
+struct _LpmNode {
+	LpmNode *child[2];
+	const NMPObject *obj;
+	NMIPAddr prefix;
+	guint8 plen;
+};
+
+typedef struct {
+	guint32 route_table;
+	LpmNode *root;
+} LpmTable;
+
+struct _NMIPRouteLpm {
+	int addr_family;
+	guint8 addr_bits;
+
+	/* nodes are allocated from one array. Each inserted route adds at
+	 * most two nodes. */
+	LpmNode *nodes;
+	guint nodes_len;
+	guint nodes_alloc;
+
+	/* there are usually only a few route tables. Search them linearly. */
+	GArray *tables;
+};
+
+/*****************************************************************************/
+
+static inline guint
+_addr_bit (const NMIPAddr *addr, guint8 idx)
+{
+	return (((const guint8 *) addr)[idx / 8] >> (7 - (idx % 8))) & 1;
+}
+
+static guint8
+_addr_common_plen (const NMIPAddr *a, const NMIPAddr *b, guint8 max_plen)
+{
+	const guint8 *pa = (const guint8 *) a;
+	const guint8 *pb = (const guint8 *) b;
+	guint8 plen = 0;
+	guint i;
+
+	for (i = 0; plen < max_plen; i++) {
+		guint8 x = pa[i] ^ pb[i];
+
+		if (x) {
+			while (!(x & 0x80)) {
+				x <<= 1;
+				plen++;
+			}
+			break;
+		}
+		plen += 8;
+	}
+	return MIN (plen, max_plen);
+}
+
+static LpmNode *
+_node_new (NMIPRouteLpm *lpm,
+           const NMIPAddr *prefix,
+           guint8 plen,
+           const NMPObject *obj)
+{
+	LpmNode *node;
+
+	nm_assert (lpm->nodes_len < lpm->nodes_alloc);
+
+	node = &lpm->nodes[lpm->nodes_len++];
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	node->obj = obj;
+	node->plen = plen;
+	nm_utils_ipx_address_clear_host_address (lpm->addr_family, &node->prefix, prefix, plen);
+	return node;
+}
+
+static gboolean
+_obj_better (int addr_family,
+             const NMPObject *obj,
+             const NMPObject *than)
+{
+	return   nm_utils_ip_route_metric_normalize (addr_family, NMP_OBJECT_CAST_IP_ROUTE (obj)->metric)
+	       < nm_utils_ip_route_metric_normalize (addr_family, NMP_OBJECT_CAST_IP_ROUTE (than)->metric);
+}
+
+static void
+_insert (NMIPRouteLpm *lpm,
+         LpmNode **p_node,
+         const NMIPAddr *prefix,
+         guint8 plen,
+         const NMPObject *obj)
+{
+	LpmNode *node;
+	LpmNode *branch;
+	guint8 common;
+
+	while ((node = *p_node)) {
+		common = _addr_common_plen (&node->prefix, prefix, MIN (node->plen, plen));
+
+		if (common < node->plen) {
+			/* the new prefix diverges from @node, or is a parent of it. */
+			if (common == plen) {
+				branch = _node_new (lpm, prefix, plen, obj);
+				branch->child[_addr_bit (&node->prefix, plen)] = node;
+			} else {
+				branch = _node_new (lpm, prefix, common, NULL);
+				branch->child[_addr_bit (&node->prefix, common)] = node;
+				branch->child[_addr_bit (prefix, common)] = _node_new (lpm, prefix, plen, obj);
+			}
+			*p_node = branch;
+			return;
+		}
+
+		if (node->plen == plen) {
+			if (   !node->obj
+			    || _obj_better (lpm->addr_family, obj, node->obj))
+				node->obj = obj;
+			return;
+		}
+
+		p_node = &node->child[_addr_bit (prefix, node->plen)];
+	}
+
+	*p_node = _node_new (lpm, prefix, plen, obj);
+}
+
+static LpmTable *
+_table_get (const NMIPRouteLpm *lpm, guint32 route_table)
+{
+	guint i;
+
+	for (i = 0; i < lpm->tables->len; i++) {
+		LpmTable *t = &g_array_index (lpm->tables, LpmTable, i);
+
+		if (t->route_table == route_table)
+			return t;
+	}
+	return NULL;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_ip_route_lpm_new:
+ * @addr_family: AF_INET or AF_INET6
+ * @head_entry: (allow-none): the routes of a NMIP4Config or NMIP6Config.
+ *
+ * Builds a longest-prefix-match index for the direct routes of @head_entry.
+ * The index does not take references to the routes. It must be freed before
+ * the routes in @head_entry change.
+ *
+ * Returns: (transfer full): the new index.
+ */
+NMIPRouteLpm *
+nm_ip_route_lpm_new (int addr_family,
+                     const NMDedupMultiHeadEntry *head_entry)
+{
+	NMIPRouteLpm *lpm;
+	CList *iter;
+
+	nm_assert_addr_family (addr_family);
+
+	lpm = g_slice_new0 (NMIPRouteLpm);
+	lpm->addr_family = addr_family;
+	lpm->addr_bits = addr_family == AF_INET ? 32 : 128;
+	lpm->tables = g_array_new (FALSE, FALSE, sizeof (LpmTable));
+
+	if (!head_entry)
+		return lpm;
+
+	lpm->nodes_alloc = 2 * head_entry->len;
+	lpm->nodes = g_new (LpmNode, lpm->nodes_alloc);
+
+	c_list_for_each (iter, &head_entry->lst_entries_head) {
+		const NMPObject *obj = c_list_entry (iter, NMDedupMultiEntry, lst_entries)->obj;
+		const NMPlatformIPRoute *r = NMP_OBJECT_CAST_IP_ROUTE (obj);
+		NMIPAddr prefix = { };
+		guint32 route_table;
+		LpmTable *t;
+
+		if (addr_family == AF_INET) {
+			if (NMP_OBJECT_CAST_IP4_ROUTE (obj)->gateway != 0)
+				continue;
+			prefix.addr4 = NMP_OBJECT_CAST_IP4_ROUTE (obj)->network;
+		} else {
+			if (!IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (obj)->gateway))
+				continue;
+			prefix.addr6 = NMP_OBJECT_CAST_IP6_ROUTE (obj)->network;
+		}
+
+		route_table = nm_platform_route_table_uncoerce (r->table_coerced, TRUE);
+		t = _table_get (lpm, route_table);
+		if (!t) {
+			g_array_append_val (lpm->tables, ((LpmTable) { .route_table = route_table }));
+			t = &g_array_index (lpm->tables, LpmTable, lpm->tables->len - 1);
+		}
+
+		_insert (lpm, &t->root, &prefix, MIN (r->plen, lpm->addr_bits), obj);
+	}
+
+	return lpm;
+}
+
+void
+nm_ip_route_lpm_free (NMIPRouteLpm *lpm)
+{
+	if (!lpm)
+		return;
+
+	g_free (lpm->nodes);
+	g_array_unref (lpm->tables);
+	g_slice_free (NMIPRouteLpm, lpm);
+}
+
+/**
+ * nm_ip_route_lpm_lookup_direct:
+ * @lpm: the index
+ * @route_table: the (uncoerced) route table
+ * @host: the address to look up, a in_addr_t or struct in6_addr.
+ *
+ * Returns: the direct route in @route_table with the longest prefix
+ *   that contains @host, and the lowest metric among those. Or %NULL.
+ */
+const NMPObject *
+nm_ip_route_lpm_lookup_direct (const NMIPRouteLpm *lpm,
+                               guint32 route_table,
+                               gconstpointer host)
+{
+	const LpmTable *t;
+	const LpmNode *node;
+	const NMPObject *best = NULL;
+	NMIPAddr addr = { };
+
+	nm_assert (lpm);
+	nm_assert (host);
+
+	t = _table_get (lpm, route_table);
+	if (!t)
+		return NULL;
+
+	memcpy (&addr, host, nm_utils_addr_family_to_size (lpm->addr_family));
+
+	for (node = t->root; node; ) {
+		if (_addr_common_plen (&node->prefix, &addr, node->plen) < node->plen)
+			break;
+		if (node->obj)
+			best = node->obj;
+		if (node->plen >= lpm->addr_bits)
+			break;
+		node = node->child[_addr_bit (&addr, node->plen)];
+	}
+	return best;
+}
@@ -0,0 +1,44 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#ifndef __NM_IP_ROUTE_LPM_H__
+#define __NM_IP_ROUTE_LPM_H__
+
+#include "nm-utils/nm-dedup-multi.h"
+#include "platform/nmp-object.h"
+
+/*****************************************************************************/
+
+/* The minimal number of routes for which NMIP4Config/NMIP6Config build a
+ * NMIPRouteLpm index. For fewer routes, iterating the list is cheaper. */
+#define NM_IP_ROUTE_LPM_MIN_ROUTES 32
+
+typedef struct _NMIPRouteLpm NMIPRouteLpm;
+
+NMIPRouteLpm *nm_ip_route_lpm_new (int addr_family,
+                                   const NMDedupMultiHeadEntry *head_entry);
+
+void nm_ip_route_lpm_free (NMIPRouteLpm *lpm);
+
+const NMPObject *nm_ip_route_lpm_lookup_direct (const NMIPRouteLpm *lpm,
+                                                guint32 route_table,
+                                                gconstpointer host);
+
+#endif /* __NM_IP_ROUTE_LPM_H__ */
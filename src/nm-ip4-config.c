@@ -35,6 +35,7 @@
 #include "platform/nm-platform-utils.h"
 #include "NetworkManagerUtils.h"
 #include "nm-core-internal.h"
+#include "nm-ip-route-lpm.h"
 #include "nm-dbus-object.h"
 
 /*****************************************************************************/
@@ -267,6 +268,50 @@ _nm_ip_config_lookup_ip_route (const NMDedupMultiIndex *multi_idx,
 	return entry;
 }
 
+/**
+ * _nm_ip_config_lookup_obj_ordered:
+ * @multi_idx:
+ * @idx_type:
+ * @iter: an iterator over the entries of @idx_type. It is positioned
+ *   after the entry found by the previous lookup.
+ * @needle: the object to look up.
+ *
+ * Like nm_dedup_multi_index_lookup_obj(). Configs that are derived from each
+ * other keep the order of their objects. When looking up the objects of one
+ * config in another, the entry following the previous result is therefore
+ * likely to hold @needle itself, which is checked without hashing @needle.
+ * Only if that fails, this falls back to a lookup in the index and moves @iter
+ * to the found entry.
+ *
+ * After the lookup, the caller may remove the returned entry, but no other.
+ *
+ * Returns: the found entry or %NULL.
+ */
+const NMDedupMultiEntry *
+_nm_ip_config_lookup_obj_ordered (const NMDedupMultiIndex *multi_idx,
+                                  const NMIPConfigDedupMultiIdxType *idx_type,
+                                  NMDedupMultiIter *iter,
+                                  const NMPObject *needle)
+{
+	const NMDedupMultiEntry *entry;
+
+	nm_assert (multi_idx);
+	nm_assert (idx_type);
+	nm_assert (iter);
+	nm_assert (NMP_OBJECT_GET_TYPE (needle) == idx_type->obj_type);
+
+	if (_nm_ip_config_iter_skip_obj (iter, needle))
+		return iter->current;
+
+	entry = nm_dedup_multi_index_lookup_obj (multi_idx, &idx_type->parent, needle);
+	if (entry) {
+		iter->_head = &entry->head->lst_entries_head;
+		iter->_next = entry->lst_entries.next != iter->_head ? entry->lst_entries.next : NULL;
+		iter->current = entry;
+	}
+	return entry;
+}
+
 /*****************************************************************************/
 
 NM_GOBJECT_PROPERTIES_DEFINE (NMIP4Config,
@@ -307,7 +352,12 @@ typedef struct {
 	GVariant *route_data_variant;
 	GVariant *routes_variant;
 	NMDedupMultiIndex *multi_idx;
+	/* changes whenever the addresses or routes change. See nm_ip4_config_get_version(). */
+	guint64 version;
 	const NMPObject *best_default_route;
+	/* index for nm_ip4_config_get_direct_route_for_host(). Built on demand
+	 * and dropped whenever the routes change. */
+	NMIPRouteLpm *route_lpm;
 	union {
 		NMIPConfigDedupMultiIdxType idx_ip4_addresses_;
 		NMDedupMultiIdxType idx_ip4_addresses;
@@ -353,6 +403,20 @@ nm_ip4_config_get_multi_idx (const NMIP4Config *self)
 	return NM_IP4_CONFIG_GET_PRIVATE (self)->multi_idx;
 }
 
+/**
+ * nm_ip4_config_get_version:
+ * @self: the #NMIP4Config
+ *
+ * Returns: a number that identifies the current addresses and routes
+ *   of @self. It changes whenever they change, and no two instances
+ *   share the same version.
+ */
+guint64
+nm_ip4_config_get_version (const NMIP4Config *self)
+{
+	return NM_IP4_CONFIG_GET_PRIVATE (self)->version;
+}
+
 /*****************************************************************************/
 
 static gboolean
@@ -504,11 +568,15 @@ nmtst_ip4_config_get_gateway (NMIP4Config *config)
 
 /*****************************************************************************/
 
+static guint64 _version_counter;
+
 static void
 _notify_addresses (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->version = ++_version_counter;
+
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
 	nm_gobject_notify_together (self, PROP_ADDRESS_DATA,
@@ -520,6 +588,9 @@ _notify_routes (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	priv->version = ++_version_counter;
+	nm_clear_pointer (&priv->route_lpm, nm_ip_route_lpm_free);
+
 	nm_assert (priv->best_default_route == _nm_ip4_config_best_default_route_find (self));
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
@@ -685,10 +756,12 @@ nm_ip4_config_add_dependent_routes (NMIP4Config *self,
                                     GPtrArray **out_ip4_dev_route_blacklist)
 {
 	GPtrArray *ip4_dev_route_blacklist = NULL;
+	gs_unref_array GArray *gw_routes = NULL;
 	const NMPlatformIP4Address *my_addr;
 	const NMPlatformIP4Route *my_route;
 	int ifindex;
 	NMDedupMultiIter iter;
+	guint i;
 
 	g_return_if_fail (NM_IS_IP4_CONFIG (self));
 
@@ -764,7 +837,10 @@ nm_ip4_config_add_dependent_routes (NMIP4Config *self,
 		}
 	}
 
-again:
+	/* Collect the direct routes to the gateways first, and add them
+	 * afterwards. Adding a route drops the lookup index of
+	 * nm_ip4_config_get_direct_route_for_host(), so it would otherwise be
+	 * rebuilt for every default route. */
 	nm_ip_config_iter_ip4_route_for_each (&iter, self, &my_route) {
 		NMPlatformIP4Route rt;
 
@@ -776,18 +852,48 @@ again:
 		                                                nm_platform_route_table_uncoerce (my_route->table_coerced, TRUE)))
 			continue;
 
+		/* another default route via the same gateway already needs it. */
+		for (i = 0; gw_routes && i < gw_routes->len; i++) {
+			const NMPlatformIP4Route *r = &g_array_index (gw_routes, NMPlatformIP4Route, i);
+
+			if (   r->network == my_route->gateway
+			    && r->table_coerced == my_route->table_coerced)
+				break;
+		}
+		if (gw_routes && i < gw_routes->len)
+			continue;
+
 		rt = *my_route;
 		rt.network = my_route->gateway;
 		rt.plen = 32;
 		rt.gateway = 0;
-		_add_route (self, NULL, &rt, NULL);
-		/* adding the route might have invalidated the iteration. Start again. */
-		goto again;
+		if (!gw_routes)
+			gw_routes = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP4Route));
+		g_array_append_val (gw_routes, rt);
 	}
 
+	for (i = 0; gw_routes && i < gw_routes->len; i++)
+		_add_route (self, NULL, &g_array_index (gw_routes, NMPlatformIP4Route, i), NULL);
+
 	NM_SET_OUT (out_ip4_dev_route_blacklist, ip4_dev_route_blacklist);
 }
 
+gboolean
+_nm_ip_config_addresses_all_synced (const GPtrArray *addresses)
+{
+	guint i;
+
+	/* the address sync leaves a NULL tombstone for addresses that
+	 * expired or could not be added. */
+	if (addresses) {
+		for (i = 0; i < addresses->len; i++) {
+			if (!addresses->pdata[i])
+				return FALSE;
+		}
+	}
+	return TRUE;
+}
+
 gboolean
 nm_ip4_config_commit (const NMIP4Config *self,
                       NMPlatform *platform,
@@ -796,6 +902,9 @@ nm_ip4_config_commit (const NMIP4Config *self,
 	gs_unref_ptrarray GPtrArray *addresses = NULL;
 	gs_unref_ptrarray GPtrArray *routes = NULL;
 	gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+	const NMDedupMultiHeadEntry *head_addresses;
+	const NMDedupMultiHeadEntry *head_routes;
+	guint64 version;
 	int ifindex;
 	gboolean success = TRUE;
 
@@ -804,10 +913,23 @@ nm_ip4_config_commit (const NMIP4Config *self,
 	ifindex = nm_ip4_config_get_ifindex (self);
 	g_return_val_if_fail (ifindex > 0, FALSE);
 
-	addresses = nm_dedup_multi_objs_to_ptr_array_head (nm_ip4_config_lookup_addresses (self),
+	head_addresses = nm_ip4_config_lookup_addresses (self);
+	head_routes = nm_ip4_config_lookup_routes (self);
+	version = nm_ip4_config_get_version (self);
+
+	if (nm_platform_ip_commit_is_unchanged (platform,
+	                                        AF_INET,
+	                                        ifindex,
+	                                        route_table_sync,
+	                                        version,
+	                                        head_addresses,
+	                                        head_routes))
+		return TRUE;
+
+	addresses = nm_dedup_multi_objs_to_ptr_array_head (head_addresses,
 	                                                   NULL, NULL);
 
-	routes = nm_dedup_multi_objs_to_ptr_array_head (nm_ip4_config_lookup_routes (self),
+	routes = nm_dedup_multi_objs_to_ptr_array_head (head_routes,
 	                                                NULL, NULL);
 
 	routes_prune = nm_platform_ip_route_get_prune_list (platform,
@@ -825,6 +947,16 @@ nm_ip4_config_commit (const NMIP4Config *self,
 	                                NULL))
 		success = FALSE;
 
+	nm_platform_ip_commit_remember (platform,
+	                                AF_INET,
+	                                ifindex,
+	                                route_table_sync,
+	                                version,
+	                                head_addresses,
+	                                head_routes,
+	                                   success
+	                                && _nm_ip_config_addresses_all_synced (addresses));
+
 	return success;
 }
 
@@ -840,14 +972,22 @@ _nm_ip_config_merge_route_attributes (int addr_family,
 	NMPlatformIP4Route *r4 = (NMPlatformIP4Route *) r;
 	NMPlatformIP6Route *r6 = (NMPlatformIP6Route *) r;
 	gboolean onlink;
+	gboolean has_attributes;
 
 	nm_assert (s_route);
 	nm_assert_addr_family (addr_family);
 	nm_assert (r);
 
+	/* the common case, especially for profiles with many static routes, is
+	 * a route without attributes. Skip the lookups then, and only assign
+	 * the defaults below. */
+	has_attributes = _nm_ip_route_has_attributes (s_route);
+
 #define GET_ATTR(name, dst, variant_type, type, dflt) \
 	G_STMT_START { \
-		GVariant *_variant = nm_ip_route_get_attribute (s_route, ""name""); \
+		GVariant *_variant =   has_attributes \
+		                     ? nm_ip_route_get_attribute (s_route, ""name"") \
+		                     : NULL; \
 		\
 		if (   _variant \
 		    && g_variant_is_of_type (_variant, G_VARIANT_TYPE_ ## variant_type)) \
@@ -880,6 +1020,9 @@ _nm_ip_config_merge_route_attributes (int addr_family,
 	GET_ATTR (NM_IP_ROUTE_ATTRIBUTE_LOCK_INITRWND,  r->lock_initrwnd,  BOOLEAN,  boolean, FALSE);
 	GET_ATTR (NM_IP_ROUTE_ATTRIBUTE_LOCK_MTU,       r->lock_mtu,       BOOLEAN,  boolean, FALSE);
 
+	if (!has_attributes)
+		return;
+
 	if (   (variant = nm_ip_route_get_attribute (s_route, NM_IP_ROUTE_ATTRIBUTE_SRC))
 	    && g_variant_is_of_type (variant, G_VARIANT_TYPE_STRING)) {
 		if (inet_pton (addr_family, g_variant_get_string (variant, NULL), &addr) == 1) {
@@ -985,14 +1128,14 @@ nm_ip4_config_merge_setting (NMIP4Config *self,
 		}
 
 		memset (&route, 0, sizeof (route));
-		nm_ip_route_get_dest_binary (s_route, &route.network);
+		route.network = _nm_ip_route_get_dest_direct (s_route)->addr4;
 
 		route.plen = nm_ip_route_get_prefix (s_route);
 		nm_assert (route.plen <= 32);
 		if (route.plen == 0)
 			continue;
 
-		nm_ip_route_get_next_hop_binary (s_route, &route.gateway);
+		route.gateway = _nm_ip_route_get_next_hop_direct (s_route)->addr4;
 		if (nm_ip_route_get_metric (s_route) == -1)
 			route.metric = route_metric;
 		else
@@ -1164,6 +1307,7 @@ nm_ip4_config_merge (NMIP4Config *dst,
 	const NMIP4ConfigPrivate *src_priv;
 	guint32 i;
 	NMDedupMultiIter ipconf_iter;
+	NMDedupMultiIter dst_iter;
 	const NMPlatformIP4Address *address = NULL;
 
 	g_return_if_fail (src != NULL);
@@ -1174,9 +1318,14 @@ nm_ip4_config_merge (NMIP4Config *dst,
 
 	g_object_freeze_notify (G_OBJECT (dst));
 
-	/* addresses */
-	nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, src, &address)
+	/* addresses. Objects that @dst already holds in the same order as @src
+	 * are skipped by comparing pointers, before hashing them. */
+	nm_ip_config_iter_ip4_address_init (&dst_iter, dst);
+	nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, src, &address) {
+		if (_nm_ip_config_iter_skip_obj (&dst_iter, ipconf_iter.current->obj))
+			continue;
 		_add_address (dst, NMP_OBJECT_UP_CAST (address), NULL);
+	}
 
 	/* nameservers */
 	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_DNS)) {
@@ -1188,6 +1337,7 @@ nm_ip4_config_merge (NMIP4Config *dst,
 	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_ROUTES)) {
 		const NMPlatformIP4Route *r_src;
 
+		nm_ip_config_iter_ip4_route_init (&dst_iter, dst);
 		nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, src, &r_src) {
 			if (NM_PLATFORM_IP_ROUTE_IS_DEFAULT (r_src)) {
 				if (NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES))
@@ -1200,6 +1350,8 @@ nm_ip4_config_merge (NMIP4Config *dst,
 					continue;
 				}
 			}
+			if (_nm_ip_config_iter_skip_obj (&dst_iter, ipconf_iter.current->obj))
+				continue;
 			_add_route (dst, ipconf_iter.current->obj, NULL, NULL);
 		}
 	}
@@ -1380,6 +1532,8 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 	const NMPlatformIP4Address *a;
 	const NMPlatformIP4Route *r;
 	NMDedupMultiIter ipconf_iter;
+	NMDedupMultiIter dst_iter;
+	const NMDedupMultiEntry *entry;
 	gboolean changed;
 	gboolean changed_default_route;
 
@@ -1392,12 +1546,17 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 
 	/* addresses */
 	changed = FALSE;
+	nm_ip_config_iter_ip4_address_init (&dst_iter, dst);
 	nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, src, &a) {
-		if (nm_dedup_multi_index_remove_obj (dst_priv->multi_idx,
-		                                     &dst_priv->idx_ip4_addresses,
-		                                     NMP_OBJECT_UP_CAST (a),
-		                                     NULL))
-			changed = TRUE;
+		entry = _nm_ip_config_lookup_obj_ordered (dst_priv->multi_idx,
+		                                          &dst_priv->idx_ip4_addresses_,
+		                                          &dst_iter,
+		                                          NMP_OBJECT_UP_CAST (a));
+		if (!entry)
+			continue;
+		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx, entry) != 1)
+			nm_assert_not_reached ();
+		changed = TRUE;
 	}
 	if (changed)
 		_notify_addresses (dst);
@@ -1412,11 +1571,11 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 	/* routes */
 	changed = FALSE;
 	changed_default_route = FALSE;
+	nm_ip_config_iter_ip4_route_init (&dst_iter, dst);
 	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, src, &r) {
 		const NMPObject *o_src = NMP_OBJECT_UP_CAST (r);
 		NMPObject o_lookup_copy;
 		const NMPObject *o_lookup;
-		nm_auto_nmpobj const NMPObject *obj_old = NULL;
 
 		if (   NM_PLATFORM_IP_ROUTE_IS_DEFAULT (r)
 		    && default_route_metric_penalty) {
@@ -1431,16 +1590,19 @@ nm_ip4_config_subtract (NMIP4Config *dst,
 		} else
 			o_lookup = o_src;
 
-		if (nm_dedup_multi_index_remove_obj (dst_priv->multi_idx,
-		                                     &dst_priv->idx_ip4_routes,
-		                                     o_lookup,
-		                                     (gconstpointer *) &obj_old)) {
-			if (dst_priv->best_default_route == obj_old) {
-				nm_clear_nmp_object (&dst_priv->best_default_route);
-				changed_default_route = TRUE;
-			}
-			changed = TRUE;
+		entry = _nm_ip_config_lookup_obj_ordered (dst_priv->multi_idx,
+		                                          &dst_priv->idx_ip4_routes_,
+		                                          &dst_iter,
+		                                          o_lookup);
+		if (!entry)
+			continue;
+		if (dst_priv->best_default_route == entry->obj) {
+			nm_clear_nmp_object (&dst_priv->best_default_route);
+			changed_default_route = TRUE;
 		}
+		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx, entry) != 1)
+			nm_assert_not_reached ();
+		changed = TRUE;
 	}
 	if (changed_default_route) {
 		_nm_ip_config_best_default_route_set (&dst_priv->best_default_route,
@@ -1519,6 +1681,7 @@ _nm_ip4_config_intersect_helper (NMIP4Config *dst,
 	NMIP4ConfigPrivate *dst_priv;
 	const NMIP4ConfigPrivate *src_priv;
 	NMDedupMultiIter ipconf_iter;
+	NMDedupMultiIter src_iter;
 	const NMPlatformIP4Address *a;
 	const NMPlatformIP4Route *r;
 	const NMPObject *new_best_default_route;
@@ -1536,10 +1699,12 @@ _nm_ip4_config_intersect_helper (NMIP4Config *dst,
 	/* addresses */
 	if (intersect_addresses) {
 		changed = FALSE;
+		nm_ip_config_iter_ip4_address_init (&src_iter, src);
 		nm_ip_config_iter_ip4_address_for_each (&ipconf_iter, dst, &a) {
-			if (nm_dedup_multi_index_lookup_obj (src_priv->multi_idx,
-			                                     &src_priv->idx_ip4_addresses,
-			                                     NMP_OBJECT_UP_CAST (a)))
+			if (_nm_ip_config_lookup_obj_ordered (src_priv->multi_idx,
+			                                      &src_priv->idx_ip4_addresses_,
+			                                      &src_iter,
+			                                      NMP_OBJECT_UP_CAST (a)))
 				continue;
 
 			if (!update_dst)
@@ -1564,6 +1729,7 @@ _nm_ip4_config_intersect_helper (NMIP4Config *dst,
 
 	changed = FALSE;
 	new_best_default_route = NULL;
+	nm_ip_config_iter_ip4_route_init (&src_iter, src);
 	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, dst, &r) {
 		const NMPObject *o_dst = NMP_OBJECT_UP_CAST (r);
 		const NMPObject *o_lookup;
@@ -1582,9 +1748,10 @@ _nm_ip4_config_intersect_helper (NMIP4Config *dst,
 		} else
 			o_lookup = o_dst;
 
-		if (nm_dedup_multi_index_lookup_obj (src_priv->multi_idx,
-		                                     &src_priv->idx_ip4_routes,
-		                                     o_lookup)) {
+		if (_nm_ip_config_lookup_obj_ordered (src_priv->multi_idx,
+		                                      &src_priv->idx_ip4_routes_,
+		                                      &src_iter,
+		                                      o_lookup)) {
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, o_dst);
 			continue;
 		}
@@ -1711,6 +1878,7 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 	gboolean config_equal;
 #endif
 	gboolean has_minor_changes = FALSE, has_relevant_changes = FALSE, are_equal;
+	gboolean in_place;
 	guint i, num;
 	NMIP4ConfigPrivate *dst_priv;
 	const NMIP4ConfigPrivate *src_priv;
@@ -1769,7 +1937,17 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 	if (!are_equal) {
 		has_minor_changes = TRUE;
 		nm_dedup_multi_index_dirty_set_idx (dst_priv->multi_idx, &dst_priv->idx_ip4_addresses);
+		nm_ip_config_iter_ip4_address_init (&ipconf_iter_dst, dst);
+		in_place = TRUE;
 		nm_dedup_multi_iter_for_each (&ipconf_iter_src, head_entry_src) {
+			/* the leading objects that are already at their place only need
+			 * to survive. After the first mismatch, objects get re-appended. */
+			if (   in_place
+			    && _nm_ip_config_iter_skip_obj (&ipconf_iter_dst, ipconf_iter_src.current->obj)) {
+				nm_dedup_multi_entry_set_dirty (ipconf_iter_dst.current, FALSE);
+				continue;
+			}
+			in_place = FALSE;
 			_nm_ip_config_add_obj (dst_priv->multi_idx,
 			                       &dst_priv->idx_ip4_addresses_,
 			                       dst_priv->ifindex,
@@ -1818,10 +1996,19 @@ nm_ip4_config_replace (NMIP4Config *dst, const NMIP4Config *src, gboolean *relev
 		has_minor_changes = TRUE;
 		new_best_default_route = NULL;
 		nm_dedup_multi_index_dirty_set_idx (dst_priv->multi_idx, &dst_priv->idx_ip4_routes);
+		nm_ip_config_iter_ip4_route_init (&ipconf_iter_dst, dst);
+		in_place = TRUE;
 		nm_dedup_multi_iter_for_each (&ipconf_iter_src, head_entry_src) {
 			const NMPObject *o = ipconf_iter_src.current->obj;
 			const NMPObject *obj_new;
 
+			if (   in_place
+			    && _nm_ip_config_iter_skip_obj (&ipconf_iter_dst, o)) {
+				nm_dedup_multi_entry_set_dirty (ipconf_iter_dst.current, FALSE);
+				new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, o);
+				continue;
+			}
+			in_place = FALSE;
 			_nm_ip_config_add_obj (dst_priv->multi_idx,
 			                       &dst_priv->idx_ip4_routes_,
 			                       dst_priv->ifindex,
@@ -2343,12 +2530,24 @@ nm_ip4_config_get_direct_route_for_host (const NMIP4Config *self,
                                          in_addr_t host,
                                          guint32 route_table)
 {
+	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
+	const NMDedupMultiHeadEntry *head_entry;
 	const NMPlatformIP4Route *best_route = NULL;
 	const NMPlatformIP4Route *item;
 	NMDedupMultiIter ipconf_iter;
 
 	g_return_val_if_fail (host, NULL);
 
+	head_entry = nm_ip4_config_lookup_routes (self);
+	if (!head_entry)
+		return NULL;
+
+	if (head_entry->len >= NM_IP_ROUTE_LPM_MIN_ROUTES) {
+		if (!priv->route_lpm)
+			priv->route_lpm = nm_ip_route_lpm_new (AF_INET, head_entry);
+		return NMP_OBJECT_CAST_IP4_ROUTE (nm_ip_route_lpm_lookup_direct (priv->route_lpm, route_table, &host));
+	}
+
 	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, self, &item) {
 		if (item->gateway != 0)
 			continue;
@@ -2362,7 +2561,9 @@ nm_ip4_config_get_direct_route_for_host (const NMIP4Config *self,
 		if (nm_utils_ip4_address_clear_host_address (host, item->plen) != nm_utils_ip4_address_clear_host_address (item->network, item->plen))
 			continue;
 
-		if (best_route && best_route->metric <= item->metric)
+		if (   best_route
+		    && best_route->plen == item->plen
+		    && best_route->metric <= item->metric)
 			continue;
 
 		best_route = item;
@@ -3301,6 +3502,8 @@ nm_ip4_config_init (NMIP4Config *self)
 	nm_ip_config_dedup_multi_idx_type_init ((NMIPConfigDedupMultiIdxType *) &priv->idx_ip4_routes,
 	                                        NMP_OBJECT_TYPE_IP4_ROUTE);
 
+	priv->version = ++_version_counter;
+
 	priv->mdns = NM_SETTING_CONNECTION_MDNS_DEFAULT;
 	priv->llmnr = NM_SETTING_CONNECTION_LLMNR_DEFAULT;
 	priv->nameservers = g_array_new (FALSE, FALSE, sizeof (guint32));
@@ -3331,6 +3534,7 @@ finalize (GObject *object)
 
 	nm_dedup_multi_index_remove_idx (priv->multi_idx, &priv->idx_ip4_addresses);
 	nm_dedup_multi_index_remove_idx (priv->multi_idx, &priv->idx_ip4_routes);
+	nm_clear_pointer (&priv->route_lpm, nm_ip_route_lpm_free);
 
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
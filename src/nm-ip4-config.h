@@ -114,11 +114,37 @@ const NMDedupMultiEntry *_nm_ip_config_lookup_ip_route (const NMDedupMultiIndex
                                                         const NMPObject *needle,
                                                         NMPlatformIPRouteCmpType cmp_type);
 
+/**
+ * _nm_ip_config_iter_skip_obj:
+ * @iter: an iterator over the objects of a NMIP4Config/NMIP6Config
+ * @obj: the object to compare
+ *
+ * Returns: %TRUE if the next entry of @iter holds exactly @obj (as a pointer).
+ *   In that case, @iter advances to it.
+ */
+static inline gboolean
+_nm_ip_config_iter_skip_obj (NMDedupMultiIter *iter,
+                             const NMPObject *obj)
+{
+	if (   !iter->_next
+	    || c_list_entry (iter->_next, NMDedupMultiEntry, lst_entries)->obj != obj)
+		return FALSE;
+	nm_dedup_multi_iter_next (iter);
+	return TRUE;
+}
+
+const NMDedupMultiEntry *_nm_ip_config_lookup_obj_ordered (const NMDedupMultiIndex *multi_idx,
+                                                          const NMIPConfigDedupMultiIdxType *idx_type,
+                                                          NMDedupMultiIter *iter,
+                                                          const NMPObject *needle);
+
 void _nm_ip_config_merge_route_attributes (int addr_family,
                                            NMIPRoute *s_route,
                                            NMPlatformIPRoute *r,
                                            guint32 route_table);
 
+gboolean _nm_ip_config_addresses_all_synced (const GPtrArray *addresses);
+
 /*****************************************************************************/
 
 #define NM_TYPE_IP4_CONFIG (nm_ip4_config_get_type ())
@@ -161,6 +187,8 @@ int nm_ip4_config_get_ifindex (const NMIP4Config *self);
 
 NMDedupMultiIndex *nm_ip4_config_get_multi_idx (const NMIP4Config *self);
 
+guint64 nm_ip4_config_get_version (const NMIP4Config *self);
+
 NMIP4Config *nm_ip4_config_capture (NMDedupMultiIndex *multi_idx, NMPlatform *platform, int ifindex);
 
 void nm_ip4_config_add_dependent_routes (NMIP4Config *self,
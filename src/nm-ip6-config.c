@@ -34,6 +34,7 @@
 #include "platform/nm-platform.h"
 #include "platform/nm-platform-utils.h"
 #include "nm-core-internal.h"
+#include "nm-ip-route-lpm.h"
 #include "NetworkManagerUtils.h"
 #include "nm-ip4-config.h"
 #include "ndisc/nm-ndisc.h"
@@ -68,7 +69,12 @@ typedef struct {
 	GVariant *route_data_variant;
 	GVariant *routes_variant;
 	NMDedupMultiIndex *multi_idx;
+	/* changes whenever the addresses or routes change. See nm_ip6_config_get_version(). */
+	guint64 version;
 	const NMPObject *best_default_route;
+	/* index for nm_ip6_config_get_direct_route_for_host(). Built on demand
+	 * and dropped whenever the routes change. */
+	NMIPRouteLpm *route_lpm;
 	union {
 		NMIPConfigDedupMultiIdxType idx_ip6_addresses_;
 		NMDedupMultiIdxType idx_ip6_addresses;
@@ -129,6 +135,20 @@ nm_ip6_config_get_multi_idx (const NMIP6Config *self)
 	return NM_IP6_CONFIG_GET_PRIVATE (self)->multi_idx;
 }
 
+/**
+ * nm_ip6_config_get_version:
+ * @self: the #NMIP6Config
+ *
+ * Returns: a number that identifies the current addresses and routes
+ *   of @self. It changes whenever they change, and no two instances
+ *   share the same version.
+ */
+guint64
+nm_ip6_config_get_version (const NMIP6Config *self)
+{
+	return NM_IP6_CONFIG_GET_PRIVATE (self)->version;
+}
+
 void
 nm_ip6_config_set_privacy (NMIP6Config *self, NMSettingIP6ConfigPrivacy privacy)
 {
@@ -200,11 +220,15 @@ _nm_ip6_config_best_default_route_find (const NMIP6Config *self)
 
 /*****************************************************************************/
 
+static guint64 _version_counter;
+
 static void
 _notify_addresses (NMIP6Config *self)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	priv->version = ++_version_counter;
+
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
 	nm_gobject_notify_together (self, PROP_ADDRESS_DATA,
@@ -216,6 +240,9 @@ _notify_routes (NMIP6Config *self)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	priv->version = ++_version_counter;
+	nm_clear_pointer (&priv->route_lpm, nm_ip_route_lpm_free);
+
 	nm_assert (priv->best_default_route == _nm_ip6_config_best_default_route_find (self));
 	nm_clear_g_variant (&priv->route_data_variant);
 	nm_clear_g_variant (&priv->routes_variant);
@@ -462,10 +489,12 @@ nm_ip6_config_add_dependent_routes (NMIP6Config *self,
                                     guint32 route_table,
                                     guint32 route_metric)
 {
+	gs_unref_array GArray *gw_routes = NULL;
 	const NMPlatformIP6Address *my_addr;
 	const NMPlatformIP6Route *my_route;
 	int ifindex;
 	NMDedupMultiIter iter;
+	guint i;
 
 	g_return_if_fail (NM_IS_IP6_CONFIG (self));
 
@@ -528,7 +557,10 @@ nm_ip6_config_add_dependent_routes (NMIP6Config *self,
 		}
 	}
 
-again:
+	/* Collect the direct routes to the gateways first, and add them
+	 * afterwards. Adding a route drops the lookup index of
+	 * nm_ip6_config_get_direct_route_for_host(), so it would otherwise be
+	 * rebuilt for every default route. */
 	nm_ip_config_iter_ip6_route_for_each (&iter, self, &my_route) {
 		NMPlatformIP6Route rt;
 
@@ -540,14 +572,28 @@ again:
 		                                                nm_platform_route_table_uncoerce (my_route->table_coerced, TRUE)))
 			continue;
 
+		/* another default route via the same gateway already needs it. */
+		for (i = 0; gw_routes && i < gw_routes->len; i++) {
+			const NMPlatformIP6Route *r = &g_array_index (gw_routes, NMPlatformIP6Route, i);
+
+			if (   IN6_ARE_ADDR_EQUAL (&r->network, &my_route->gateway)
+			    && r->table_coerced == my_route->table_coerced)
+				break;
+		}
+		if (gw_routes && i < gw_routes->len)
+			continue;
+
 		rt = *my_route;
 		rt.network = my_route->gateway;
 		rt.plen = 128;
 		rt.gateway = in6addr_any;
-		_add_route (self, NULL, &rt, NULL);
-		/* adding the route might have invalidated the iteration. Start again. */
-		goto again;
+		if (!gw_routes)
+			gw_routes = g_array_new (FALSE, FALSE, sizeof (NMPlatformIP6Route));
+		g_array_append_val (gw_routes, rt);
 	}
+
+	for (i = 0; gw_routes && i < gw_routes->len; i++)
+		_add_route (self, NULL, &g_array_index (gw_routes, NMPlatformIP6Route, i), NULL);
 }
 
 gboolean
@@ -559,18 +605,35 @@ nm_ip6_config_commit (const NMIP6Config *self,
 	gs_unref_ptrarray GPtrArray *addresses = NULL;
 	gs_unref_ptrarray GPtrArray *routes = NULL;
 	gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+	const NMDedupMultiHeadEntry *head_addresses;
+	const NMDedupMultiHeadEntry *head_routes;
+	guint64 version;
 	int ifindex;
 	gboolean success = TRUE;
 
 	g_return_val_if_fail (NM_IS_IP6_CONFIG (self), FALSE);
+	nm_assert (!out_temporary_not_available || !*out_temporary_not_available);
 
 	ifindex = nm_ip6_config_get_ifindex (self);
 	g_return_val_if_fail (ifindex > 0, FALSE);
 
-	addresses = nm_dedup_multi_objs_to_ptr_array_head (nm_ip6_config_lookup_addresses (self),
+	head_addresses = nm_ip6_config_lookup_addresses (self);
+	head_routes = nm_ip6_config_lookup_routes (self);
+	version = nm_ip6_config_get_version (self);
+
+	if (nm_platform_ip_commit_is_unchanged (platform,
+	                                        AF_INET6,
+	                                        ifindex,
+	                                        route_table_sync,
+	                                        version,
+	                                        head_addresses,
+	                                        head_routes))
+		return TRUE;
+
+	addresses = nm_dedup_multi_objs_to_ptr_array_head (head_addresses,
 	                                                   NULL, NULL);
 
-	routes = nm_dedup_multi_objs_to_ptr_array_head (nm_ip6_config_lookup_routes (self),
+	routes = nm_dedup_multi_objs_to_ptr_array_head (head_routes,
 	                                                NULL, NULL);
 
 	routes_prune = nm_platform_ip_route_get_prune_list (platform,
@@ -588,6 +651,20 @@ nm_ip6_config_commit (const NMIP6Config *self,
 	                                out_temporary_not_available))
 		success = FALSE;
 
+	/* routes that are temporarily not available must be retried on the next
+	 * commit, so don't remember this one. */
+	nm_platform_ip_commit_remember (platform,
+	                                AF_INET6,
+	                                ifindex,
+	                                route_table_sync,
+	                                version,
+	                                head_addresses,
+	                                head_routes,
+	                                   success
+	                                && _nm_ip_config_addresses_all_synced (addresses)
+	                                && (   !out_temporary_not_available
+	                                    || !*out_temporary_not_available));
+
 	return success;
 }
 
@@ -656,14 +733,14 @@ nm_ip6_config_merge_setting (NMIP6Config *self,
 		}
 
 		memset (&route, 0, sizeof (route));
-		nm_ip_route_get_dest_binary (s_route, &route.network);
+		route.network = _nm_ip_route_get_dest_direct (s_route)->addr6;
 
 		route.plen = nm_ip_route_get_prefix (s_route);
 		nm_assert (route.plen <= 128);
 		if (route.plen == 0)
 			continue;
 
-		nm_ip_route_get_next_hop_binary (s_route, &route.gateway);
+		route.gateway = _nm_ip_route_get_next_hop_direct (s_route)->addr6;
 		if (nm_ip_route_get_metric (s_route) == -1)
 			route.metric = route_metric;
 		else
@@ -672,7 +749,7 @@ nm_ip6_config_merge_setting (NMIP6Config *self,
 
 		nm_utils_ip6_address_clear_host_address (&route.network, &route.network, route.plen);
 
-		_nm_ip_config_merge_route_attributes (AF_INET,
+		_nm_ip_config_merge_route_attributes (AF_INET6,
 		                                      s_route,
 		                                      NM_PLATFORM_IP_ROUTE_CAST (&route),
 		                                      route_table);
@@ -837,6 +914,7 @@ nm_ip6_config_merge (NMIP6Config *dst,
 {
 	guint32 i;
 	NMDedupMultiIter ipconf_iter;
+	NMDedupMultiIter dst_iter;
 	const NMPlatformIP6Address *address = NULL;
 
 	g_return_if_fail (src != NULL);
@@ -844,9 +922,14 @@ nm_ip6_config_merge (NMIP6Config *dst,
 
 	g_object_freeze_notify (G_OBJECT (dst));
 
-	/* addresses */
-	nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, src, &address)
+	/* addresses. Objects that @dst already holds in the same order as @src
+	 * are skipped by comparing pointers, before hashing them. */
+	nm_ip_config_iter_ip6_address_init (&dst_iter, dst);
+	nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, src, &address) {
+		if (_nm_ip_config_iter_skip_obj (&dst_iter, ipconf_iter.current->obj))
+			continue;
 		_add_address (dst, NMP_OBJECT_UP_CAST (address), NULL);
+	}
 
 	/* nameservers */
 	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_DNS)) {
@@ -858,6 +941,7 @@ nm_ip6_config_merge (NMIP6Config *dst,
 	if (!NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_ROUTES)) {
 		const NMPlatformIP6Route *r_src;
 
+		nm_ip_config_iter_ip6_route_init (&dst_iter, dst);
 		nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, src, &r_src) {
 			if (NM_PLATFORM_IP_ROUTE_IS_DEFAULT (r_src)) {
 				if (NM_FLAGS_HAS (merge_flags, NM_IP_CONFIG_MERGE_NO_DEFAULT_ROUTES))
@@ -870,6 +954,8 @@ nm_ip6_config_merge (NMIP6Config *dst,
 					continue;
 				}
 			}
+			if (_nm_ip_config_iter_skip_obj (&dst_iter, ipconf_iter.current->obj))
+				continue;
 			_add_route (dst, ipconf_iter.current->obj, NULL, NULL);
 		}
 	}
@@ -985,6 +1071,8 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 	const NMPlatformIP6Address *a;
 	const NMPlatformIP6Route *r;
 	NMDedupMultiIter ipconf_iter;
+	NMDedupMultiIter dst_iter;
+	const NMDedupMultiEntry *entry;
 	gboolean changed;
 	gboolean changed_default_route;
 
@@ -997,12 +1085,17 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 
 	/* addresses */
 	changed = FALSE;
+	nm_ip_config_iter_ip6_address_init (&dst_iter, dst);
 	nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, src, &a) {
-		if (nm_dedup_multi_index_remove_obj (dst_priv->multi_idx,
-		                                     &dst_priv->idx_ip6_addresses,
-		                                     NMP_OBJECT_UP_CAST (a),
-		                                     NULL))
-			changed = TRUE;
+		entry = _nm_ip_config_lookup_obj_ordered (dst_priv->multi_idx,
+		                                          &dst_priv->idx_ip6_addresses_,
+		                                          &dst_iter,
+		                                          NMP_OBJECT_UP_CAST (a));
+		if (!entry)
+			continue;
+		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx, entry) != 1)
+			nm_assert_not_reached ();
+		changed = TRUE;
 	}
 	if (changed)
 		_notify_addresses (dst);
@@ -1017,11 +1110,11 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 	/* routes */
 	changed = FALSE;
 	changed_default_route = FALSE;
+	nm_ip_config_iter_ip6_route_init (&dst_iter, dst);
 	nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, src, &r) {
 		const NMPObject *o_src = NMP_OBJECT_UP_CAST (r);
 		NMPObject o_lookup_copy;
 		const NMPObject *o_lookup;
-		nm_auto_nmpobj const NMPObject *obj_old = NULL;
 
 		if (   NM_PLATFORM_IP_ROUTE_IS_DEFAULT (r)
 		    && default_route_metric_penalty) {
@@ -1036,16 +1129,19 @@ nm_ip6_config_subtract (NMIP6Config *dst,
 		} else
 			o_lookup = o_src;
 
-		if (nm_dedup_multi_index_remove_obj (dst_priv->multi_idx,
-		                                     &dst_priv->idx_ip6_routes,
-		                                     o_lookup,
-		                                     (gconstpointer *) &obj_old)) {
-			if (dst_priv->best_default_route == obj_old) {
-				nm_clear_nmp_object (&dst_priv->best_default_route);
-				changed_default_route = TRUE;
-			}
-			changed = TRUE;
+		entry = _nm_ip_config_lookup_obj_ordered (dst_priv->multi_idx,
+		                                          &dst_priv->idx_ip6_routes_,
+		                                          &dst_iter,
+		                                          o_lookup);
+		if (!entry)
+			continue;
+		if (dst_priv->best_default_route == entry->obj) {
+			nm_clear_nmp_object (&dst_priv->best_default_route);
+			changed_default_route = TRUE;
 		}
+		if (nm_dedup_multi_index_remove_entry (dst_priv->multi_idx, entry) != 1)
+			nm_assert_not_reached ();
+		changed = TRUE;
 	}
 	if (changed_default_route) {
 		_nm_ip_config_best_default_route_set (&dst_priv->best_default_route,
@@ -1094,6 +1190,7 @@ _nm_ip6_config_intersect_helper (NMIP6Config *dst,
 	NMIP6ConfigPrivate *dst_priv;
 	const NMIP6ConfigPrivate *src_priv;
 	NMDedupMultiIter ipconf_iter;
+	NMDedupMultiIter src_iter;
 	const NMPlatformIP6Address *a;
 	const NMPlatformIP6Route *r;
 	gboolean changed, result = FALSE;
@@ -1111,10 +1208,12 @@ _nm_ip6_config_intersect_helper (NMIP6Config *dst,
 	/* addresses */
 	if (intersect_addresses) {
 		changed = FALSE;
+		nm_ip_config_iter_ip6_address_init (&src_iter, src);
 		nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, dst, &a) {
-			if (nm_dedup_multi_index_lookup_obj (src_priv->multi_idx,
-			                                     &src_priv->idx_ip6_addresses,
-			                                     NMP_OBJECT_UP_CAST (a)))
+			if (_nm_ip_config_lookup_obj_ordered (src_priv->multi_idx,
+			                                      &src_priv->idx_ip6_addresses_,
+			                                      &src_iter,
+			                                      NMP_OBJECT_UP_CAST (a)))
 				continue;
 
 			if (!update_dst)
@@ -1139,6 +1238,7 @@ _nm_ip6_config_intersect_helper (NMIP6Config *dst,
 
 	changed = FALSE;
 	new_best_default_route = NULL;
+	nm_ip_config_iter_ip6_route_init (&src_iter, src);
 	nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, dst, &r) {
 		const NMPObject *o_dst = NMP_OBJECT_UP_CAST (r);
 		const NMPObject *o_lookup;
@@ -1157,9 +1257,10 @@ _nm_ip6_config_intersect_helper (NMIP6Config *dst,
 		} else
 			o_lookup = o_dst;
 
-		if (nm_dedup_multi_index_lookup_obj (src_priv->multi_idx,
-		                                     &src_priv->idx_ip6_routes,
-		                                     o_lookup)) {
+		if (_nm_ip_config_lookup_obj_ordered (src_priv->multi_idx,
+		                                      &src_priv->idx_ip6_routes_,
+		                                      &src_iter,
+		                                      o_lookup)) {
 			new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, o_dst);
 			continue;
 		}
@@ -1283,6 +1384,7 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 	gboolean config_equal;
 #endif
 	gboolean has_minor_changes = FALSE, has_relevant_changes = FALSE, are_equal;
+	gboolean in_place;
 	guint i, num;
 	NMIP6ConfigPrivate *dst_priv;
 	const NMIP6ConfigPrivate *src_priv;
@@ -1344,7 +1446,17 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 	if (!are_equal) {
 		has_minor_changes = TRUE;
 		nm_dedup_multi_index_dirty_set_idx (dst_priv->multi_idx, &dst_priv->idx_ip6_addresses);
+		nm_ip_config_iter_ip6_address_init (&ipconf_iter_dst, dst);
+		in_place = TRUE;
 		nm_dedup_multi_iter_for_each (&ipconf_iter_src, head_entry_src) {
+			/* the leading objects that are already at their place only need
+			 * to survive. After the first mismatch, objects get re-appended. */
+			if (   in_place
+			    && _nm_ip_config_iter_skip_obj (&ipconf_iter_dst, ipconf_iter_src.current->obj)) {
+				nm_dedup_multi_entry_set_dirty (ipconf_iter_dst.current, FALSE);
+				continue;
+			}
+			in_place = FALSE;
 			_nm_ip_config_add_obj (dst_priv->multi_idx,
 			                       &dst_priv->idx_ip6_addresses_,
 			                       dst_priv->ifindex,
@@ -1393,10 +1505,19 @@ nm_ip6_config_replace (NMIP6Config *dst, const NMIP6Config *src, gboolean *relev
 		has_minor_changes = TRUE;
 		new_best_default_route = NULL;
 		nm_dedup_multi_index_dirty_set_idx (dst_priv->multi_idx, &dst_priv->idx_ip6_routes);
+		nm_ip_config_iter_ip6_route_init (&ipconf_iter_dst, dst);
+		in_place = TRUE;
 		nm_dedup_multi_iter_for_each (&ipconf_iter_src, head_entry_src) {
 			const NMPObject *o = ipconf_iter_src.current->obj;
 			const NMPObject *obj_new;
 
+			if (   in_place
+			    && _nm_ip_config_iter_skip_obj (&ipconf_iter_dst, o)) {
+				nm_dedup_multi_entry_set_dirty (ipconf_iter_dst.current, FALSE);
+				new_best_default_route = _nm_ip_config_best_default_route_find_better (new_best_default_route, o);
+				continue;
+			}
+			in_place = FALSE;
 			_nm_ip_config_add_obj (dst_priv->multi_idx,
 			                       &dst_priv->idx_ip6_routes_,
 			                       dst_priv->ifindex,
@@ -1571,6 +1692,51 @@ nm_ip6_config_reset_addresses_ndisc (NMIP6Config *self,
 		_notify_addresses (self);
 }
 
+/**
+ * nm_ip6_config_refresh_addresses_ndisc:
+ * @self: the #NMIP6Config
+ * @platform: the platform
+ * @now: the current timestamp in seconds
+ *
+ * Pushes the current lifetimes of the autoconf addresses in @self to the
+ * kernel, without syncing the rest of the configuration. This is enough
+ * when a router only refreshed the lifetimes of what it announced before.
+ * Routes from RA are configured without lifetime, so they need no refresh.
+ */
+void
+nm_ip6_config_refresh_addresses_ndisc (const NMIP6Config *self,
+                                       NMPlatform *platform,
+                                       gint32 now)
+{
+	const NMIP6ConfigPrivate *priv;
+	const NMPlatformIP6Address *address;
+	NMDedupMultiIter ipconf_iter;
+
+	g_return_if_fail (NM_IS_IP6_CONFIG (self));
+
+	priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+
+	if (priv->ifindex <= 0)
+		return;
+
+	nm_ip_config_iter_ip6_address_for_each (&ipconf_iter, self, &address) {
+		guint32 lifetime, preferred;
+
+		if (address->addr_source != NM_IP_CONFIG_SOURCE_NDISC)
+			continue;
+
+		lifetime = nm_utils_lifetime_get (address->timestamp, address->lifetime, address->preferred,
+		                                  now, &preferred);
+		if (!lifetime)
+			continue;
+
+		nm_platform_ip6_address_add (platform, priv->ifindex, address->address,
+		                             address->plen, address->peer_address,
+		                             lifetime, preferred,
+		                             address->n_ifa_flags);
+	}
+}
+
 void
 nm_ip6_config_reset_addresses (NMIP6Config *self)
 {
@@ -2008,12 +2174,24 @@ nm_ip6_config_get_direct_route_for_host (const NMIP6Config *self,
                                          const struct in6_addr *host,
                                          guint32 route_table)
 {
+	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
+	const NMDedupMultiHeadEntry *head_entry;
 	const NMPlatformIP6Route *best_route = NULL;
 	const NMPlatformIP6Route *item;
 	NMDedupMultiIter ipconf_iter;
 
 	g_return_val_if_fail (host && !IN6_IS_ADDR_UNSPECIFIED (host), NULL);
 
+	head_entry = nm_ip6_config_lookup_routes (self);
+	if (!head_entry)
+		return NULL;
+
+	if (head_entry->len >= NM_IP_ROUTE_LPM_MIN_ROUTES) {
+		if (!priv->route_lpm)
+			priv->route_lpm = nm_ip_route_lpm_new (AF_INET6, head_entry);
+		return NMP_OBJECT_CAST_IP6_ROUTE (nm_ip_route_lpm_lookup_direct (priv->route_lpm, route_table, host));
+	}
+
 	nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, self, &item) {
 		if (!IN6_IS_ADDR_UNSPECIFIED (&item->gateway))
 			continue;
@@ -2027,8 +2205,9 @@ nm_ip6_config_get_direct_route_for_host (const NMIP6Config *self,
 		if (!nm_utils_ip6_address_same_prefix (host, &item->network, item->plen))
 			continue;
 
-		if (best_route &&
-		    nm_utils_ip6_route_metric_normalize (best_route->metric) <= nm_utils_ip6_route_metric_normalize (item->metric))
+		if (   best_route
+		    && best_route->plen == item->plen
+		    && nm_utils_ip6_route_metric_normalize (best_route->metric) <= nm_utils_ip6_route_metric_normalize (item->metric))
 			continue;
 
 		best_route = item;
@@ -2696,6 +2875,8 @@ nm_ip6_config_init (NMIP6Config *self)
 	nm_ip_config_dedup_multi_idx_type_init ((NMIPConfigDedupMultiIdxType *) &priv->idx_ip6_routes,
 	                                        NMP_OBJECT_TYPE_IP6_ROUTE);
 
+	priv->version = ++_version_counter;
+
 	priv->nameservers = g_array_new (FALSE, TRUE, sizeof (struct in6_addr));
 	priv->domains = g_ptr_array_new_with_free_func (g_free);
 	priv->searches = g_ptr_array_new_with_free_func (g_free);
@@ -2735,6 +2916,7 @@ finalize (GObject *object)
 
 	nm_dedup_multi_index_remove_idx (priv->multi_idx, &priv->idx_ip6_addresses);
 	nm_dedup_multi_index_remove_idx (priv->multi_idx, &priv->idx_ip6_routes);
+	nm_clear_pointer (&priv->route_lpm, nm_ip_route_lpm_free);
 
 	nm_clear_g_variant (&priv->address_data_variant);
 	nm_clear_g_variant (&priv->addresses_variant);
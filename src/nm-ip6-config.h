@@ -104,6 +104,8 @@ int nm_ip6_config_get_ifindex (const NMIP6Config *self);
 
 struct _NMDedupMultiIndex *nm_ip6_config_get_multi_idx (const NMIP6Config *self);
 
+guint64 nm_ip6_config_get_version (const NMIP6Config *self);
+
 NMIP6Config *nm_ip6_config_capture (struct _NMDedupMultiIndex *multi_idx, NMPlatform *platform, int ifindex,
                                     NMSettingIP6ConfigPrivacy use_temporary);
 
@@ -216,6 +218,9 @@ void nm_ip6_config_reset_addresses_ndisc (NMIP6Config *self,
                                           guint addresses_n,
                                           guint8 plen,
                                           guint32 ifa_flags);
+void nm_ip6_config_refresh_addresses_ndisc (const NMIP6Config *self,
+                                            NMPlatform *platform,
+                                            gint32 now);
 struct _NMNDiscRoute;
 struct _NMNDiscGateway;
 void nm_ip6_config_reset_routes_ndisc (NMIP6Config *self,
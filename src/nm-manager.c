@@ -302,6 +302,7 @@ static const GDBusSignalInfo signal_info_check_permissions;
 static const GDBusSignalInfo signal_info_state_changed;
 static const GDBusSignalInfo signal_info_device_added;
 static const GDBusSignalInfo signal_info_device_removed;
+static const GDBusSignalInfo signal_info_device_statistics_changed;
 
 static gboolean add_device (NMManager *self, NMDevice *device, GError **error);
 
@@ -2827,6 +2828,29 @@ device_iface_changed (NMDevice *device,
 	retry_connections_for_parent_device (self, device);
 }
 
+/**
+ * nm_manager_emit_device_statistics:
+ * @self: the #NMManager
+ * @statistics: a floating "a{oa{sv}}" variant with the statistics of
+ *   all devices that changed.
+ *
+ * Emits the counters of several devices with one D-Bus signal,
+ * instead of one PropertiesChanged signal per device.
+ */
+void
+nm_manager_emit_device_statistics (NMManager *self,
+                                   GVariant *statistics)
+{
+	g_return_if_fail (NM_IS_MANAGER (self));
+	g_return_if_fail (g_variant_is_of_type (statistics, G_VARIANT_TYPE ("a{oa{sv}}")));
+
+	nm_dbus_object_emit_signal (NM_DBUS_OBJECT (self),
+	                            &interface_info_manager,
+	                            &signal_info_device_statistics_changed,
+	                            "(@a{oa{sv}})",
+	                            statistics);
+}
+
 static void
 _emit_device_added_removed (NMManager *self,
                             NMDevice *device,
@@ -7839,6 +7863,13 @@ static const GDBusSignalInfo signal_info_device_removed = NM_DEFINE_GDBUS_SIGNAL
 	),
 );
 
+static const GDBusSignalInfo signal_info_device_statistics_changed = NM_DEFINE_GDBUS_SIGNAL_INFO_INIT (
+	"DeviceStatisticsChanged",
+	.args = NM_DEFINE_GDBUS_ARG_INFOS (
+		NM_DEFINE_GDBUS_ARG_INFO ("statistics", "a{oa{sv}}"),
+	),
+);
+
 static const NMDBusInterfaceInfoExtended interface_info_manager = {
 	.parent = NM_DEFINE_GDBUS_INTERFACE_INFO_INIT (
 		NM_DBUS_INTERFACE,
@@ -8054,6 +8085,7 @@ static const NMDBusInterfaceInfoExtended interface_info_manager = {
 			&signal_info_state_changed,
 			&signal_info_device_added,
 			&signal_info_device_removed,
+			&signal_info_device_statistics_changed,
 		),
 		.properties = NM_DEFINE_GDBUS_PROPERTY_INFOS (
 			NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE_L     ("Devices",                    "ao",    NM_MANAGER_DEVICES),
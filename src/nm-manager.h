@@ -159,6 +159,9 @@ guint32             nm_manager_device_route_metric_reserve (NMManager *self,
 void                nm_manager_device_route_metric_clear (NMManager *self,
                                                           int ifindex);
 
+void                nm_manager_emit_device_statistics (NMManager *self,
+                                                       GVariant *statistics);
+
 char *              nm_manager_get_connection_iface (NMManager *self,
                                                      NMConnection *connection,
                                                      NMDevice **out_parent,
@@ -2757,6 +2757,11 @@ _new_from_nl_link (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr
 		obj->link.rx_bytes   = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, rx_bytes)]);
 		obj->link.tx_packets = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, tx_packets)]);
 		obj->link.tx_bytes   = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, tx_bytes)]);
+		obj->link.rx_errors  = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, rx_errors)]);
+		obj->link.tx_errors  = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, tx_errors)]);
+		obj->link.rx_dropped = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, rx_dropped)]);
+		obj->link.tx_dropped = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, tx_dropped)]);
+		obj->link.multicast  = unaligned_read_ne64 (&stats[G_STRUCT_OFFSET (struct rtnl_link_stats64, multicast)]);
 	}
 
 	obj->link.n_ifi_flags = ifi->ifi_flags;
@@ -2907,6 +2912,11 @@ _new_from_nl_link (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr
 				obj->link.rx_bytes = link_cached->link.rx_bytes;
 				obj->link.tx_packets = link_cached->link.tx_packets;
 				obj->link.tx_bytes = link_cached->link.tx_bytes;
+				obj->link.rx_errors = link_cached->link.rx_errors;
+				obj->link.tx_errors = link_cached->link.tx_errors;
+				obj->link.rx_dropped = link_cached->link.rx_dropped;
+				obj->link.tx_dropped = link_cached->link.tx_dropped;
+				obj->link.multicast = link_cached->link.multicast;
 			}
 		}
 	}
@@ -5891,6 +5901,29 @@ link_refresh (NMPlatform *platform, int ifindex)
 	return !!nm_platform_link_get_obj (platform, ifindex, TRUE);
 }
 
+static void
+link_refresh_many (NMPlatform *platform, const int *ifindexes, guint len)
+{
+	/* Requesting a few links individually is cheaper than dumping all of
+	 * them. Beyond that, one dump replaces many round-trips. */
+	const guint LINK_REFRESH_MANY_DUMP_THRESHOLD = 8;
+	guint i;
+
+	if (len >= LINK_REFRESH_MANY_DUMP_THRESHOLD) {
+		_LOGD ("link-refresh-many: refresh all links instead of %u", len);
+		do_request_one_type (platform, NMP_OBJECT_TYPE_LINK);
+		return;
+	}
+
+	/* Queue all requests and send them in one go, without waiting
+	 * for each reply individually. */
+	for (i = 0; i < len; i++) {
+		if (ifindexes[i] > 0)
+			delayed_action_schedule (platform, DELAYED_ACTION_TYPE_REFRESH_LINK, GINT_TO_POINTER (ifindexes[i]));
+	}
+	delayed_action_handle_all (platform, FALSE);
+}
+
 static void
 refresh_all (NMPlatform *platform, NMPObjectType obj_type)
 {
@@ -8459,6 +8492,7 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 
 	platform_class->refresh_all = refresh_all;
 	platform_class->link_refresh = link_refresh;
+	platform_class->link_refresh_many = link_refresh_many;
 
 	platform_class->link_set_netns = link_set_netns;
 
@@ -126,6 +126,10 @@ typedef struct _NMPlatformPrivate {
 	GHashTable *ip4_dev_route_blacklist_hash;
 	NMDedupMultiIndex *multi_idx;
 	NMPCache *cache;
+
+	/* the IPCommitState per ifindex, for IPv6 and IPv4. */
+	GHashTable *ip_commit_states[2];
+	guint64 ip_commit_n_skipped;
 } NMPlatformPrivate;
 
 G_DEFINE_TYPE (NMPlatform, nm_platform, G_TYPE_OBJECT)
@@ -1223,6 +1227,37 @@ nm_platform_link_refresh (NMPlatform *self, int ifindex)
 	return TRUE;
 }
 
+/**
+ * nm_platform_link_refresh_many:
+ * @self: platform instance
+ * @ifindexes: the interface indexes to refresh
+ * @len: the number of entries in @ifindexes
+ *
+ * Reload the cache for several links synchronously. Compared to calling
+ * nm_platform_link_refresh() for each link, the platform may batch the
+ * requests or refresh all links at once.
+ */
+void
+nm_platform_link_refresh_many (NMPlatform *self, const int *ifindexes, guint len)
+{
+	guint i;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	g_return_if_fail (ifindexes || len == 0);
+
+	if (len == 0)
+		return;
+
+	if (klass->link_refresh_many) {
+		klass->link_refresh_many (self, ifindexes, len);
+		return;
+	}
+
+	for (i = 0; i < len; i++)
+		nm_platform_link_refresh (self, ifindexes[i]);
+}
+
 int
 nm_platform_link_get_ifi_flags (NMPlatform *self,
                                 int ifindex,
@@ -4456,6 +4491,280 @@ sync_route_add:
 	return success;
 }
 
+/*****************************************************************************/
+
+/* Committing a NMIP4Config/NMIP6Config means computing the prune list and
+ * diffing the desired addresses and routes against the cache. Most commits
+ * (DHCP renewals, RAs, metric changes for other address families) don't change
+ * anything. We remember what the last successful commit for an ifindex left
+ * behind, and if neither the desired objects nor the addresses and routes of
+ * the ifindex in the cache changed since, the commit can be skipped. */
+
+typedef struct {
+	int ifindex;
+	NMIPRouteTableSyncMode route_table_sync;
+	guint n_addresses;
+	guint64 config_version;
+	guint64 cache_version_addresses;
+	guint64 cache_version_routes;
+
+	/* the addresses, followed by the routes. */
+	GPtrArray *objs;
+} IPCommitState;
+
+static void
+_ip_commit_state_free (gpointer data)
+{
+	IPCommitState *state = data;
+
+	if (state->objs)
+		g_ptr_array_unref (state->objs);
+	g_slice_free (IPCommitState, state);
+}
+
+static GHashTable *
+_ip_commit_states_get (NMPlatform *self, int addr_family, gboolean create)
+{
+	NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+	GHashTable **p_states = &priv->ip_commit_states[addr_family == AF_INET];
+
+	if (   !*p_states
+	    && create)
+		*p_states = g_hash_table_new_full (nm_direct_hash, NULL, NULL, _ip_commit_state_free);
+	return *p_states;
+}
+
+static void
+_ip_commit_cache_versions (NMPlatform *self,
+                           int addr_family,
+                           int ifindex,
+                           guint64 *out_addresses,
+                           guint64 *out_routes)
+{
+	const NMPCache *cache = nm_platform_get_cache (self);
+	const gboolean IS_IPv4 = (addr_family == AF_INET);
+
+	*out_addresses = nmp_cache_get_ifindex_version (cache,
+	                                                IS_IPv4 ? NMP_OBJECT_TYPE_IP4_ADDRESS : NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                                                ifindex);
+	*out_routes = nmp_cache_get_ifindex_version (cache,
+	                                             IS_IPv4 ? NMP_OBJECT_TYPE_IP4_ROUTE : NMP_OBJECT_TYPE_IP6_ROUTE,
+	                                             ifindex);
+}
+
+static gboolean
+_ip_commit_objs_equal (const GPtrArray *objs,
+                       guint *p_idx,
+                       guint n_objs,
+                       const NMDedupMultiHeadEntry *head_entry)
+{
+	CList *iter;
+
+	if ((head_entry ? head_entry->len : 0u) != n_objs)
+		return FALSE;
+	if (!head_entry)
+		return TRUE;
+
+	c_list_for_each (iter, &head_entry->lst_entries_head) {
+		const NMPObject *obj = c_list_entry (iter, NMDedupMultiEntry, lst_entries)->obj;
+
+		/* objects from the same NMDedupMultiIndex are shared, so this usually
+		 * is a pointer comparison. */
+		if (!nmp_object_equal (obj, objs->pdata[(*p_idx)++]))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean
+_ip_commit_routes_all_present (NMPlatform *self,
+                               int addr_family,
+                               const NMDedupMultiHeadEntry *head_routes)
+{
+	const NMPlatformVTableRoute *vt;
+	const NMDedupMultiEntry *plat_entry;
+	CList *iter;
+
+	if (!head_routes)
+		return TRUE;
+
+	vt = addr_family == AF_INET
+	     ? &nm_platform_vtable_route_v4
+	     : &nm_platform_vtable_route_v6;
+
+	/* nm_platform_ip_route_sync() ignores failures to add certain routes.
+	 * Check that all routes are really there, the same way the sync does. */
+	c_list_for_each (iter, &head_routes->lst_entries_head) {
+		const NMPObject *conf_o = c_list_entry (iter, NMDedupMultiEntry, lst_entries)->obj;
+
+		plat_entry = nm_platform_lookup_entry (self,
+		                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+		                                       conf_o);
+		if (   !plat_entry
+		    || vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
+		                      NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
+		                      NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * nm_platform_ip_commit_is_unchanged:
+ * @self: the #NMPlatform instance
+ * @addr_family: AF_INET or AF_INET6
+ * @ifindex: the interface
+ * @route_table_sync: the sync mode for the routes
+ * @config_version: the version of the config that is about to be committed,
+ *   as returned by nm_ip4_config_get_version() or nm_ip6_config_get_version().
+ * @head_addresses: the addresses of the config
+ * @head_routes: the routes of the config
+ *
+ * Returns: %TRUE, if committing the addresses and routes would be a no-operation,
+ *   because the same objects were already successfully committed and the platform
+ *   cache didn't change since. In that case, the commit can be skipped.
+ */
+gboolean
+nm_platform_ip_commit_is_unchanged (NMPlatform *self,
+                                    int addr_family,
+                                    int ifindex,
+                                    NMIPRouteTableSyncMode route_table_sync,
+                                    guint64 config_version,
+                                    const NMDedupMultiHeadEntry *head_addresses,
+                                    const NMDedupMultiHeadEntry *head_routes)
+{
+	NMPlatformPrivate *priv;
+	GHashTable *states;
+	IPCommitState *state;
+	guint64 version_addresses;
+	guint64 version_routes;
+	guint idx;
+
+	_CHECK_SELF (self, klass, FALSE);
+
+	nm_assert (NM_IN_SET (addr_family, AF_INET, AF_INET6));
+
+	states = _ip_commit_states_get (self, addr_family, FALSE);
+	if (!states)
+		return FALSE;
+
+	state = g_hash_table_lookup (states, GINT_TO_POINTER (ifindex));
+	if (!state)
+		return FALSE;
+
+	_ip_commit_cache_versions (self, addr_family, ifindex, &version_addresses, &version_routes);
+	if (   state->route_table_sync != route_table_sync
+	    || state->cache_version_addresses != version_addresses
+	    || state->cache_version_routes != version_routes)
+		return FALSE;
+
+	if (state->config_version != config_version) {
+		/* a different config (or the same one, modified). Compare the content. */
+		idx = 0;
+		if (   !_ip_commit_objs_equal (state->objs, &idx, state->n_addresses, head_addresses)
+		    || !_ip_commit_objs_equal (state->objs, &idx, (state->objs ? state->objs->len : 0u) - state->n_addresses, head_routes))
+			return FALSE;
+		state->config_version = config_version;
+	}
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+	priv->ip_commit_n_skipped++;
+	_LOGT ("ip%c-config: skip commit for ifindex %d as nothing changed (%"G_GUINT64_FORMAT" commits skipped)",
+	       nm_utils_addr_family_to_char (addr_family),
+	       ifindex,
+	       priv->ip_commit_n_skipped);
+	return TRUE;
+}
+
+/**
+ * nm_platform_ip_commit_remember:
+ * @self: the #NMPlatform instance
+ * @addr_family: AF_INET or AF_INET6
+ * @ifindex: the interface
+ * @route_table_sync: the sync mode for the routes
+ * @config_version: the version of the committed config
+ * @head_addresses: the addresses of the config
+ * @head_routes: the routes of the config
+ * @success: whether all addresses and routes were configured.
+ *
+ * Record the result of a commit for nm_platform_ip_commit_is_unchanged().
+ * Must be called after the addresses and routes are synced, so that the
+ * resulting changes to the cache are accounted for. If @success is %FALSE,
+ * or if not all routes ended up in the platform cache, the previous record
+ * is dropped and the next commit will be performed.
+ */
+void
+nm_platform_ip_commit_remember (NMPlatform *self,
+                                int addr_family,
+                                int ifindex,
+                                NMIPRouteTableSyncMode route_table_sync,
+                                guint64 config_version,
+                                const NMDedupMultiHeadEntry *head_addresses,
+                                const NMDedupMultiHeadEntry *head_routes,
+                                gboolean success)
+{
+	GHashTable *states;
+	IPCommitState *state;
+	guint n_addresses;
+	guint n_routes;
+	CList *iter;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	nm_assert (NM_IN_SET (addr_family, AF_INET, AF_INET6));
+
+	if (   success
+	    && !_ip_commit_routes_all_present (self, addr_family, head_routes)) {
+		_LOGT ("ip%c-config: not all routes for ifindex %d are configured, don't skip the next commit",
+		       nm_utils_addr_family_to_char (addr_family),
+		       ifindex);
+		success = FALSE;
+	}
+
+	if (!success) {
+		states = _ip_commit_states_get (self, addr_family, FALSE);
+		if (states)
+			g_hash_table_remove (states, GINT_TO_POINTER (ifindex));
+		return;
+	}
+
+	states = _ip_commit_states_get (self, addr_family, TRUE);
+
+	state = g_slice_new0 (IPCommitState);
+	state->ifindex = ifindex;
+	state->route_table_sync = route_table_sync;
+	state->config_version = config_version;
+	_ip_commit_cache_versions (self, addr_family, ifindex,
+	                           &state->cache_version_addresses,
+	                           &state->cache_version_routes);
+
+	n_addresses = head_addresses ? head_addresses->len : 0u;
+	n_routes = head_routes ? head_routes->len : 0u;
+	state->n_addresses = n_addresses;
+	if (n_addresses + n_routes > 0) {
+		state->objs = g_ptr_array_new_full (n_addresses + n_routes,
+		                                    (GDestroyNotify) nmp_object_unref);
+		if (head_addresses) {
+			c_list_for_each (iter, &head_addresses->lst_entries_head)
+				g_ptr_array_add (state->objs, (gpointer) nmp_object_ref (c_list_entry (iter, NMDedupMultiEntry, lst_entries)->obj));
+		}
+		if (head_routes) {
+			c_list_for_each (iter, &head_routes->lst_entries_head)
+				g_ptr_array_add (state->objs, (gpointer) nmp_object_ref (c_list_entry (iter, NMDedupMultiEntry, lst_entries)->obj));
+		}
+	}
+
+	g_hash_table_insert (states, GINT_TO_POINTER (ifindex), state);
+}
+
+guint64
+nm_platform_ip_commit_get_n_skipped (NMPlatform *self)
+{
+	_CHECK_SELF (self, klass, 0);
+
+	return NM_PLATFORM_GET_PRIVATE (self)->ip_commit_n_skipped;
+}
+
 gboolean
 nm_platform_ip_route_flush (NMPlatform *self,
                             int addr_family,
@@ -6266,6 +6575,11 @@ nm_platform_link_hash_update (const NMPlatformLink *obj, NMHashState *h)
 	                     obj->rx_bytes,
 	                     obj->tx_packets,
 	                     obj->tx_bytes,
+	                     obj->rx_errors,
+	                     obj->tx_errors,
+	                     obj->rx_dropped,
+	                     obj->tx_dropped,
+	                     obj->multicast,
 	                     NM_HASH_COMBINE_BOOLS (guint8,
 	                                            obj->connected,
 	                                            obj->initialized));
@@ -6301,6 +6615,11 @@ nm_platform_link_cmp (const NMPlatformLink *a, const NMPlatformLink *b)
 	NM_CMP_FIELD (a, b, rx_bytes);
 	NM_CMP_FIELD (a, b, tx_packets);
 	NM_CMP_FIELD (a, b, tx_bytes);
+	NM_CMP_FIELD (a, b, rx_errors);
+	NM_CMP_FIELD (a, b, tx_errors);
+	NM_CMP_FIELD (a, b, rx_dropped);
+	NM_CMP_FIELD (a, b, tx_dropped);
+	NM_CMP_FIELD (a, b, multicast);
 	return 0;
 }
 
@@ -7199,6 +7518,16 @@ nm_platform_cache_update_emit_signal (NMPlatform *self,
 	ifindex = o->object.ifindex;
 	klass = NMP_OBJECT_GET_CLASS (o);
 
+	if (   klass->obj_type == NMP_OBJECT_TYPE_LINK
+	    && cache_op == NMP_CACHE_OPS_REMOVED) {
+		NMPlatformPrivate *priv = NM_PLATFORM_GET_PRIVATE (self);
+
+		if (priv->ip_commit_states[0])
+			g_hash_table_remove (priv->ip_commit_states[0], GINT_TO_POINTER (ifindex));
+		if (priv->ip_commit_states[1])
+			g_hash_table_remove (priv->ip_commit_states[1], GINT_TO_POINTER (ifindex));
+	}
+
 	if (   klass->obj_type == NMP_OBJECT_TYPE_IP4_ROUTE
 	    && NM_PLATFORM_GET_PRIVATE (self)->ip4_dev_route_blacklist_gc_timeout_id
 	    && NM_IN_SET (cache_op, NMP_CACHE_OPS_ADDED, NMP_CACHE_OPS_UPDATED))
@@ -7352,6 +7681,8 @@ finalize (GObject *object)
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_check_id);
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_gc_timeout_id);
 	g_clear_pointer (&priv->ip4_dev_route_blacklist_hash, g_hash_table_unref);
+	g_clear_pointer (&priv->ip_commit_states[0], g_hash_table_unref);
+	g_clear_pointer (&priv->ip_commit_states[1], g_hash_table_unref);
 	g_clear_object (&self->_netns);
 	nm_dedup_multi_index_unref (priv->multi_idx);
 	nmp_cache_free (priv->cache);
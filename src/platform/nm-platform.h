@@ -231,6 +231,11 @@ struct _NMPlatformLink {
 	guint64 rx_bytes;
 	guint64 tx_packets;
 	guint64 tx_bytes;
+	guint64 rx_errors;
+	guint64 tx_errors;
+	guint64 rx_dropped;
+	guint64 tx_dropped;
+	guint64 multicast;
 
 	/* @connected is mostly identical to (@n_ifi_flags & IFF_UP). Except for bridge/bond masters,
 	 * where we coerce the link as disconnect if it has no slaves. */
@@ -806,6 +811,7 @@ typedef struct {
 	gboolean (*link_delete) (NMPlatform *, int ifindex);
 
 	gboolean (*link_refresh) (NMPlatform *, int ifindex);
+	void (*link_refresh_many) (NMPlatform *, const int *ifindexes, guint len);
 
 	gboolean (*link_set_netns) (NMPlatform *, int ifindex, int netns_fd);
 
@@ -1237,6 +1243,7 @@ gboolean nm_platform_link_supports_slaves (NMPlatform *self, int ifindex);
 const char *nm_platform_link_get_type_name (NMPlatform *self, int ifindex);
 
 gboolean nm_platform_link_refresh (NMPlatform *self, int ifindex);
+void nm_platform_link_refresh_many (NMPlatform *self, const int *ifindexes, guint len);
 void nm_platform_process_events (NMPlatform *self);
 
 const NMPlatformLink *nm_platform_process_events_ensure_link (NMPlatform *self,
@@ -1472,6 +1479,23 @@ gboolean nm_platform_ip_route_sync (NMPlatform *self,
                                     GPtrArray *routes_prune,
                                     GPtrArray **out_temporary_not_available);
 
+gboolean nm_platform_ip_commit_is_unchanged (NMPlatform *self,
+                                             int addr_family,
+                                             int ifindex,
+                                             NMIPRouteTableSyncMode route_table_sync,
+                                             guint64 config_version,
+                                             const struct _NMDedupMultiHeadEntry *head_addresses,
+                                             const struct _NMDedupMultiHeadEntry *head_routes);
+void nm_platform_ip_commit_remember (NMPlatform *self,
+                                     int addr_family,
+                                     int ifindex,
+                                     NMIPRouteTableSyncMode route_table_sync,
+                                     guint64 config_version,
+                                     const struct _NMDedupMultiHeadEntry *head_addresses,
+                                     const struct _NMDedupMultiHeadEntry *head_routes,
+                                     gboolean success);
+guint64 nm_platform_ip_commit_get_n_skipped (NMPlatform *self);
+
 gboolean nm_platform_ip_route_flush (NMPlatform *self,
                                      int addr_family,
                                      int ifindex);
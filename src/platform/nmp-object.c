@@ -84,9 +84,20 @@ struct _NMPCache {
 	 * Don't bother, use _idx_type_get() instead! */
 	DedupMultiIdxType idx_types[NMP_CACHE_ID_TYPE_MAX];
 
+	/* per-ifindex version counters for addresses and routes, see
+	 * nmp_cache_get_ifindex_version(). Entries are dropped together
+	 * with their link. */
+	GHashTable *ifindex_versions;
+	guint64 version_counter;
+
 	gboolean use_udev;
 };
 
+typedef struct {
+	int ifindex;
+	guint64 versions[4];
+} IfindexVersions;
+
 /*****************************************************************************/
 
 int
@@ -2322,6 +2333,95 @@ _idxcache_update_other_cache_ids (NMPCache *cache,
 		nm_dedup_multi_index_remove_entry (cache->multi_idx, entry_old);
 }
 
+static int
+_ifindex_versions_idx (NMPObjectType obj_type)
+{
+	switch (obj_type) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: return 0;
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: return 1;
+	case NMP_OBJECT_TYPE_IP4_ROUTE:   return 2;
+	case NMP_OBJECT_TYPE_IP6_ROUTE:   return 3;
+	default:                          return -1;
+	}
+}
+
+static void
+_ifindex_versions_set (NMPCache *cache,
+                       int ifindex,
+                       int idx)
+{
+	IfindexVersions *v;
+
+	if (ifindex <= 0)
+		return;
+
+	v = g_hash_table_lookup (cache->ifindex_versions, GINT_TO_POINTER (ifindex));
+	if (!v) {
+		v = g_slice_new0 (IfindexVersions);
+		v->ifindex = ifindex;
+		g_hash_table_insert (cache->ifindex_versions, GINT_TO_POINTER (ifindex), v);
+	}
+	v->versions[idx] = cache->version_counter;
+}
+
+static void
+_ifindex_versions_bump (NMPCache *cache,
+                        const NMPObject *obj_old,
+                        const NMPObject *obj_new)
+{
+	const NMPObject *obj = obj_new ?: obj_old;
+	int idx;
+
+	if (NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_LINK) {
+		/* a new link might reuse the ifindex of an old one. Start over. */
+		if (!obj_old || !obj_new)
+			g_hash_table_remove (cache->ifindex_versions, GINT_TO_POINTER (obj->object.ifindex));
+		return;
+	}
+
+	idx = _ifindex_versions_idx (NMP_OBJECT_GET_TYPE (obj));
+	if (idx < 0)
+		return;
+
+	cache->version_counter++;
+	_ifindex_versions_set (cache, obj->object.ifindex, idx);
+	if (   obj_old
+	    && obj_new
+	    && obj_old->object.ifindex != obj_new->object.ifindex)
+		_ifindex_versions_set (cache, obj_old->object.ifindex, idx);
+}
+
+/**
+ * nmp_cache_get_ifindex_version:
+ * @cache: the #NMPCache
+ * @obj_type: one of the address or route object types
+ * @ifindex: the interface
+ *
+ * Returns: a counter that changes whenever an object of type @obj_type
+ *   on @ifindex was added, changed or removed in the cache. Zero means
+ *   that no such change happened since the link appeared.
+ */
+guint64
+nmp_cache_get_ifindex_version (const NMPCache *cache,
+                               NMPObjectType obj_type,
+                               int ifindex)
+{
+	const IfindexVersions *v;
+	int idx;
+
+	idx = _ifindex_versions_idx (obj_type);
+	g_return_val_if_fail (idx >= 0, 0);
+
+	v = g_hash_table_lookup (cache->ifindex_versions, GINT_TO_POINTER (ifindex));
+	return v ? v->versions[idx] : 0;
+}
+
+static void
+_ifindex_versions_free (gpointer data)
+{
+	g_slice_free (IfindexVersions, data);
+}
+
 static void
 _idxcache_update (NMPCache *cache,
                   const NMDedupMultiEntry *entry_old,
@@ -2401,6 +2501,8 @@ _idxcache_update (NMPCache *cache,
 		                                  is_dump);
 	}
 
+	_ifindex_versions_bump (cache, obj_old, entry_new ? entry_new->obj : NULL);
+
 	NM_SET_OUT (out_entry_new, entry_new);
 }
 
@@ -2944,6 +3046,8 @@ nmp_cache_new (NMDedupMultiIndex *multi_idx, gboolean use_udev)
 
 	cache->multi_idx = nm_dedup_multi_index_ref (multi_idx);
 
+	cache->ifindex_versions = g_hash_table_new_full (nm_direct_hash, NULL, NULL, _ifindex_versions_free);
+
 	cache->use_udev = !!use_udev;
 	return cache;
 }
@@ -2958,6 +3062,8 @@ nmp_cache_free (NMPCache *cache)
 
 	nm_dedup_multi_index_unref (cache->multi_idx);
 
+	g_hash_table_unref (cache->ifindex_versions);
+
 	g_slice_free (NMPCache, cache);
 }
 
@@ -787,6 +787,10 @@ NMPCacheOpsType nmp_cache_update_link_master_connected (NMPCache *cache,
 void nmp_cache_dirty_set_all (NMPCache *cache,
                               const NMPLookup *lookup);
 
+guint64 nmp_cache_get_ifindex_version (const NMPCache *cache,
+                                       NMPObjectType obj_type,
+                                       int ifindex);
+
 NMPCache *nmp_cache_new (NMDedupMultiIndex *multi_idx, gboolean use_udev);
 void nmp_cache_free (NMPCache *cache);
 
@@ -22,6 +22,7 @@
 #include <linux/rtnetlink.h>
 
 #include "nm-core-utils.h"
+#include "nm-ip4-config.h"
 #include "platform/nm-platform-utils.h"
 
 #include "test-common.h"
@@ -318,6 +319,52 @@ test_ip4_route (void)
 	free_signal (route_removed);
 }
 
+static void
+test_ip4_commit_skip (void)
+{
+	int ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_object NMIP4Config *config = NULL;
+	in_addr_t network = nmtst_inet4_from_string ("192.0.2.0");
+	guint8 plen = 24;
+	int metric = 22988;
+	guint64 n_skipped;
+
+	config = nm_ip4_config_new (nm_platform_get_multi_idx (NM_PLATFORM_GET), ifindex);
+	nm_ip4_config_add_route (config,
+	                         &((NMPlatformIP4Route) {
+	                             .ifindex = ifindex,
+	                             .rt_source = NM_IP_CONFIG_SOURCE_USER,
+	                             .network = network,
+	                             .plen = plen,
+	                             .metric = metric,
+	                         }),
+	                         NULL);
+
+	n_skipped = nm_platform_ip_commit_get_n_skipped (NM_PLATFORM_GET);
+
+	/* the first commit configures the route. */
+	g_assert (nm_ip4_config_commit (config, NM_PLATFORM_GET, NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN));
+	nmtstp_assert_ip4_route_exists (NULL, 1, DEVICE_NAME, network, plen, metric, 0);
+	g_assert_cmpint (nm_platform_ip_commit_get_n_skipped (NM_PLATFORM_GET), ==, n_skipped);
+
+	/* committing it again changes nothing and is skipped. */
+	g_assert (nm_ip4_config_commit (config, NM_PLATFORM_GET, NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN));
+	g_assert_cmpint (nm_platform_ip_commit_get_n_skipped (NM_PLATFORM_GET), ==, n_skipped + 1);
+
+	/* the route gets removed behind our back. The next commit must restore it. */
+	g_assert (nmtstp_platform_ip4_route_delete (NM_PLATFORM_GET, ifindex, network, plen, metric));
+	nmtstp_assert_ip4_route_exists (NULL, 0, DEVICE_NAME, network, plen, metric, 0);
+
+	g_assert (nm_ip4_config_commit (config, NM_PLATFORM_GET, NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN));
+	g_assert_cmpint (nm_platform_ip_commit_get_n_skipped (NM_PLATFORM_GET), ==, n_skipped + 1);
+	nmtstp_assert_ip4_route_exists (NULL, 1, DEVICE_NAME, network, plen, metric, 0);
+
+	g_assert (nm_ip4_config_commit (config, NM_PLATFORM_GET, NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN));
+	g_assert_cmpint (nm_platform_ip_commit_get_n_skipped (NM_PLATFORM_GET), ==, n_skipped + 2);
+
+	g_assert (nmtstp_platform_ip4_route_delete (NM_PLATFORM_GET, ifindex, network, plen, metric));
+}
+
 static void
 test_ip6_route (void)
 {
@@ -889,6 +936,8 @@ _nmtstp_setup_tests (void)
 	add_test_func ("/route/ip4", test_ip4_route);
 	add_test_func ("/route/ip6", test_ip6_route);
 	add_test_func ("/route/ip4_metric0", test_ip4_route_metric0);
+	if (!nmtstp_is_root_test ())
+		add_test_func ("/route/ip4_commit_skip", test_ip4_commit_skip);
 	add_test_func_data ("/route/ip4_options/1", test_ip4_route_options, GINT_TO_POINTER (1));
 	if (nmtstp_is_root_test ())
 		add_test_func_data ("/route/ip4_options/2", test_ip4_route_options, GINT_TO_POINTER (2));
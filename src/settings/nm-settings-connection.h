@@ -141,6 +141,8 @@ GType nm_settings_connection_get_type (void);
 
 NMConnection *nm_settings_connection_get_connection (NMSettingsConnection *self);
 
+GVariant *nm_settings_connection_to_dbus (NMSettingsConnection *self);
+
 guint64 nm_settings_connection_get_last_secret_agent_version_id (NMSettingsConnection *self);
 
 gboolean nm_settings_connection_has_unmodified_applied_connection (NMSettingsConnection *self,
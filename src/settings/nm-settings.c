@@ -281,6 +281,83 @@ impl_settings_list_connections (NMDBusObject *obj,
 	                                       g_variant_new ("(^ao)", strv));
 }
 
+static void
+_get_connections_settings_add (GVariantBuilder *builder,
+                               NMSettingsConnection *sett_conn,
+                               NMAuthSubject *subject)
+{
+	const char *path;
+
+	path = nm_dbus_object_get_path (NM_DBUS_OBJECT (sett_conn));
+	if (!path)
+		return;
+
+	if (!nm_auth_is_subject_in_acl (nm_settings_connection_get_connection (sett_conn),
+	                                subject,
+	                                NULL))
+		return;
+
+	g_variant_builder_add (builder, "{o@a{sa{sv}}}",
+	                       path,
+	                       nm_settings_connection_to_dbus (sett_conn));
+}
+
+static void
+impl_settings_get_connections_settings (NMDBusObject *obj,
+                                        const NMDBusInterfaceInfoExtended *interface_info,
+                                        const NMDBusMethodInfoExtended *method_info,
+                                        GDBusConnection *dbus_connection,
+                                        const char *sender,
+                                        GDBusMethodInvocation *invocation,
+                                        GVariant *parameters)
+{
+	NMSettings *self = NM_SETTINGS (obj);
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	gs_unref_object NMAuthSubject *subject = NULL;
+	gs_unref_variant GVariant *v_paths = NULL;
+	NMSettingsConnection *sett_conn;
+	GVariantBuilder builder;
+	GVariantIter iter;
+	const char *path;
+
+	g_variant_get (parameters, "(@ao)", &v_paths);
+
+	subject = nm_auth_subject_new_unix_process_from_context (invocation);
+	if (!subject) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+		                                               NM_SETTINGS_ERROR,
+		                                               NM_SETTINGS_ERROR_PERMISSION_DENIED,
+		                                               "Unable to determine UID of request.");
+		return;
+	}
+
+	/* Like GetSettings() on the individual connections, but in one go. Connections
+	 * that are not visible to the caller or that don't exist are silently
+	 * omitted from the result instead of failing the whole request. An empty
+	 * list of paths requests all connections. */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+
+	if (g_variant_n_children (v_paths) == 0) {
+		c_list_for_each_entry (sett_conn, &priv->connections_lst_head, _connections_lst)
+			_get_connections_settings_add (&builder, sett_conn, subject);
+	} else {
+		gs_unref_hashtable GHashTable *seen = NULL;
+
+		seen = g_hash_table_new (nm_str_hash, g_str_equal);
+		g_variant_iter_init (&iter, v_paths);
+		while (g_variant_iter_next (&iter, "&o", &path)) {
+			if (!g_hash_table_add (seen, (gpointer) path))
+				continue;
+			sett_conn = nm_settings_get_connection_by_path (self, path);
+			if (sett_conn)
+				_get_connections_settings_add (&builder, sett_conn, subject);
+		}
+	}
+
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(a{oa{sa{sv}}})", &builder));
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
@@ -1957,6 +2034,18 @@ static const NMDBusInterfaceInfoExtended interface_info_settings = {
 				),
 				.handle = impl_settings_list_connections,
 			),
+			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
+				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
+					"GetConnectionsSettings",
+					.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("connections", "ao"),
+					),
+					.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("settings", "a{oa{sa{sv}}}"),
+					),
+				),
+				.handle = impl_settings_get_connections_settings,
+			),
 			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
 				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
 					"GetConnectionByUuid",
@@ -2071,13 +2071,13 @@ write_route_file_svformat (const char *filename, NMSettingIPConfig *s_ip4)
 
 		route = nm_setting_ip_config_get_route (s_ip4, i);
 
-		svSetValueStr (routefile, addr_key, nm_ip_route_get_dest (route));
+		svSetValueStr (routefile, addr_key, _nm_ip_route_get_dest_str (route, buf));
 
 		netmask = _nm_utils_ip4_prefix_to_netmask (nm_ip_route_get_prefix (route));
 		svSetValueStr (routefile, netmask_key,
 		               nm_utils_inet4_ntop (netmask, buf));
 
-		svSetValueStr (routefile, gw_key, nm_ip_route_get_next_hop (route));
+		svSetValueStr (routefile, gw_key, _nm_ip_route_get_next_hop_str (route, buf));
 
 		metric = nm_ip_route_get_metric (route);
 		if (metric != -1) {
@@ -2115,16 +2115,18 @@ write_route_file (NMSettingIPConfig *s_ip)
 
 	for (i = 0; i < num; i++) {
 		gs_free char *options = NULL;
+		char dest_buf[NM_UTILS_INET_ADDRSTRLEN];
+		char next_hop_buf[NM_UTILS_INET_ADDRSTRLEN];
 		const char *next_hop;
 		gint64 metric;
 
 		route = nm_setting_ip_config_get_route (s_ip, i);
-		next_hop = nm_ip_route_get_next_hop (route);
+		next_hop = _nm_ip_route_get_next_hop_str (route, next_hop_buf);
 		metric = nm_ip_route_get_metric (route);
 		options = get_route_attributes_string (route, addr_family);
 
 		g_string_append_printf (contents, "%s/%u",
-		                        nm_ip_route_get_dest (route),
+		                        _nm_ip_route_get_dest_str (route, dest_buf),
 		                        nm_ip_route_get_prefix (route));
 		if (next_hop)
 			g_string_append_printf (contents, " via %s", next_hop);
@@ -38,3 +38,44 @@ nm_sd_utils_id128_get_machine (NMUuid *out_uuid)
 		return NULL;
 	return out_uuid;
 }
+
+/*****************************************************************************/
+
+/**
+ * nm_sd_utils_dhcp_renewal_jitter:
+ * @start: the time at which the lease was requested
+ * @timeout: the time of T1 or T2, after @start
+ * @percent: the maximum jitter, in percent of the time between
+ *   @start and @timeout
+ * @rnd: a random number. Using the same number for T1 and T2 keeps
+ *   T1 before T2.
+ *
+ * RFC 2131, section 4.4.5 recommends some random "fuzz" for T1 and T2
+ * to avoid synchronized renewals of many clients.
+ *
+ * Returns: @timeout, moved forward by a fraction of the time since @start
+ *   that is chosen by @rnd and at most @percent percent.
+ */
+guint64
+nm_sd_utils_dhcp_renewal_jitter (guint64 start,
+                                 guint64 timeout,
+                                 guint percent,
+                                 guint64 rnd)
+{
+	guint64 interval;
+	guint64 fraction;
+
+	if (   percent == 0
+	    || timeout <= start)
+		return timeout;
+
+	percent = MIN (percent, 100u);
+
+	/* the fraction of the interval to subtract, in units of 1/100000. */
+	fraction = rnd % ((guint64) percent * 1000u + 1u);
+
+	/* compute interval * fraction / 100000 without overflowing. */
+	interval = timeout - start;
+	return timeout - (  (interval / 100000u) * fraction
+	                  + (interval % 100000u) * fraction / 100000u);
+}
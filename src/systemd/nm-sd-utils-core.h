@@ -27,4 +27,18 @@ struct _NMUuid *nm_sd_utils_id128_get_machine (struct _NMUuid *out_uuid);
 
 /*****************************************************************************/
 
+/* NetworkManager specific changes to the systemd sources in src/systemd/src.
+ * They are not upstream and must be kept when re-importing systemd:
+ *
+ *  - sd-dhcp-client.c: sd_dhcp_client_set_renewal_jitter(). The client
+ *    moves T1 and T2 forward with nm_sd_utils_dhcp_renewal_jitter().
+ */
+
+guint64 nm_sd_utils_dhcp_renewal_jitter (guint64 start,
+                                         guint64 timeout,
+                                         guint percent,
+                                         guint64 rnd);
+
+/*****************************************************************************/
+
 #endif /* __NM_SD_UTILS_CORE_H__ */
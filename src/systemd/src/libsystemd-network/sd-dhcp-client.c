@@ -28,6 +28,7 @@
 #include "random-util.h"
 #include "string-util.h"
 #include "strv.h"
+#include "systemd/nm-sd-utils-core.h" /* NM local patch, see nm-sd-utils-core.h */
 #include "util.h"
 
 #define MAX_CLIENT_ID_LEN (sizeof(uint32_t) + MAX_DUID_LEN)  /* Arbitrary limit */
@@ -87,6 +88,7 @@ struct sd_dhcp_client {
         char *vendor_class_identifier;
         char **user_class;
         uint32_t mtu;
+        unsigned renewal_jitter; /* NM local patch */
         uint32_t xid;
         usec_t start_time;
         unsigned attempt;
@@ -524,6 +526,16 @@ int sd_dhcp_client_set_mtu(sd_dhcp_client *client, uint32_t mtu) {
         return 0;
 }
 
+/* NM local patch, see nm-sd-utils-core.h */
+int sd_dhcp_client_set_renewal_jitter(sd_dhcp_client *client, unsigned percent) {
+        assert_return(client, -EINVAL);
+        assert_return(percent <= 50, -ERANGE);
+
+        client->renewal_jitter = percent;
+
+        return 0;
+}
+
 int sd_dhcp_client_get_lease(sd_dhcp_client *client, sd_dhcp_lease **ret) {
         assert_return(client, -EINVAL);
 
@@ -1423,6 +1435,21 @@ static uint64_t client_compute_timeout(sd_dhcp_client *client, uint32_t lifetime
                 + (random_u32() & 0x1fffff);
 }
 
+/* NM local patch, see nm-sd-utils-core.h */
+static void client_jitter_timeouts(sd_dhcp_client *client, uint64_t *t1_timeout, uint64_t *t2_timeout) {
+        uint64_t r;
+
+        assert(client);
+
+        if (client->renewal_jitter == 0)
+                return;
+
+        /* the same random number for both keeps T1 before T2. */
+        r = random_u64();
+        *t1_timeout = nm_sd_utils_dhcp_renewal_jitter(client->request_sent, *t1_timeout, client->renewal_jitter, r);
+        *t2_timeout = nm_sd_utils_dhcp_renewal_jitter(client->request_sent, *t2_timeout, client->renewal_jitter, r);
+}
+
 static int client_set_lease_timeouts(sd_dhcp_client *client) {
         usec_t time_now;
         uint64_t lifetime_timeout;
@@ -1494,6 +1521,8 @@ static int client_set_lease_timeouts(sd_dhcp_client *client) {
                 client->lease->t2 = (client->lease->lifetime * 7) / 8;
         }
 
+        client_jitter_timeouts(client, &t1_timeout, &t2_timeout); /* NM local patch */
+
         /* arm lifetime timeout */
         r = event_reset_time(client->event, &client->timeout_expire,
                              clock_boottime_or_monotonic(),
@@ -154,6 +154,10 @@ int sd_dhcp_client_get_client_id(
 int sd_dhcp_client_set_mtu(
                 sd_dhcp_client *client,
                 uint32_t mtu);
+/* NM local patch, see nm-sd-utils-core.h */
+int sd_dhcp_client_set_renewal_jitter(
+                sd_dhcp_client *client,
+                unsigned percent);
 int sd_dhcp_client_set_client_port(
                 sd_dhcp_client *client,
                 uint16_t port);
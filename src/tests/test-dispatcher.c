@@ -0,0 +1,196 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ *
+ */
+
+#include "nm-default.h"
+
+#include "nm-dispatcher.h"
+#include "config/nm-test-device.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+typedef struct {
+	NMDispatcherAction action;
+	NMDevice *device;
+	NMDispatcherFunc callback;
+	gpointer user_data;
+	guint call_id;
+} SentRequest;
+
+static GArray *sent;
+
+static gboolean
+_send_func (NMDispatcherAction action,
+            NMDevice *device,
+            NMDispatcherFunc callback,
+            gpointer user_data,
+            guint *out_call_id)
+{
+	static guint call_id_counter = 0;
+	SentRequest r = {
+		.action = action,
+		.device = device,
+		.callback = callback,
+		.user_data = user_data,
+		.call_id = ++call_id_counter,
+	};
+
+	g_array_append_val (sent, r);
+	NM_SET_OUT (out_call_id, r.call_id);
+	return TRUE;
+}
+
+static void
+_complete (guint idx)
+{
+	SentRequest r;
+
+	g_assert_cmpint (idx, <, sent->len);
+
+	/* the callback might send further requests and grow the array. */
+	r = g_array_index (sent, SentRequest, idx);
+	if (r.callback)
+		r.callback (r.call_id, r.user_data);
+}
+
+static void
+_assert_sent (guint idx, NMDevice *device, NMDispatcherAction action)
+{
+	const SentRequest *r;
+
+	g_assert_cmpint (idx, <, sent->len);
+	r = &g_array_index (sent, SentRequest, idx);
+	g_assert (r->device == device);
+	g_assert_cmpint (r->action, ==, action);
+}
+
+static void
+_call (NMDevice *device, NMDispatcherAction action)
+{
+	g_assert (nm_dispatcher_call_device (action, device, NULL, NULL, NULL, NULL));
+}
+
+static void
+_setup (void)
+{
+	sent = g_array_new (FALSE, FALSE, sizeof (SentRequest));
+	_nmtst_dispatcher_set_send_func (_send_func);
+}
+
+static void
+_teardown (void)
+{
+	_nmtst_dispatcher_set_send_func (NULL);
+	g_clear_pointer (&sent, g_array_unref);
+}
+
+/*****************************************************************************/
+
+static void
+test_coalesce (void)
+{
+	gs_unref_object NMDevice *dev = nm_test_device_new ("00:00:00:00:00:01");
+
+	_setup ();
+
+	_call (dev, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_call (dev, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_call (dev, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	g_assert_cmpint (sent->len, ==, 1);
+	_assert_sent (0, dev, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+
+	/* the merged events are sent as one, once the pending request is done. */
+	_complete (0);
+	g_assert_cmpint (sent->len, ==, 2);
+	_assert_sent (1, dev, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+
+	_complete (1);
+	g_assert_cmpint (sent->len, ==, 2);
+
+	_call (dev, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	g_assert_cmpint (sent->len, ==, 3);
+	_complete (2);
+	g_assert_cmpint (sent->len, ==, 3);
+
+	_teardown ();
+}
+
+static void
+test_coalesce_order (void)
+{
+	gs_unref_object NMDevice *dev1 = nm_test_device_new ("00:00:00:00:00:01");
+	gs_unref_object NMDevice *dev2 = nm_test_device_new ("00:00:00:00:00:02");
+
+	_setup ();
+
+	_call (dev1, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_call (dev2, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_call (dev1, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_call (dev2, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	g_assert_cmpint (sent->len, ==, 2);
+
+	/* the held back "dhcp4-change" must reach the scripts before the
+	 * "dhcp6-change" and "pre-down" of the same device. The other device
+	 * is not affected. */
+	_call (dev1, NM_DISPATCHER_ACTION_DHCP6_CHANGE);
+	g_assert_cmpint (sent->len, ==, 4);
+	_assert_sent (2, dev1, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_assert_sent (3, dev1, NM_DISPATCHER_ACTION_DHCP6_CHANGE);
+
+	_call (dev1, NM_DISPATCHER_ACTION_DHCP6_CHANGE);
+	g_assert_cmpint (sent->len, ==, 4);
+
+	_call (dev1, NM_DISPATCHER_ACTION_PRE_DOWN);
+	_call (dev1, NM_DISPATCHER_ACTION_DOWN);
+	g_assert_cmpint (sent->len, ==, 7);
+	_assert_sent (4, dev1, NM_DISPATCHER_ACTION_DHCP6_CHANGE);
+	_assert_sent (5, dev1, NM_DISPATCHER_ACTION_PRE_DOWN);
+	_assert_sent (6, dev1, NM_DISPATCHER_ACTION_DOWN);
+
+	/* completing the pending requests of dev1 must not send anything
+	 * anymore, it would arrive after "down". */
+	_complete (0);
+	_complete (3);
+	g_assert_cmpint (sent->len, ==, 7);
+
+	_complete (1);
+	g_assert_cmpint (sent->len, ==, 8);
+	_assert_sent (7, dev2, NM_DISPATCHER_ACTION_DHCP4_CHANGE);
+	_complete (7);
+	g_assert_cmpint (sent->len, ==, 8);
+
+	_teardown ();
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init_with_logging (&argc, &argv, NULL, "ALL");
+
+	g_test_add_func ("/dispatcher/coalesce", test_coalesce);
+	g_test_add_func ("/dispatcher/coalesce-order", test_coalesce_order);
+
+	return g_test_run ();
+}
@@ -33,6 +33,8 @@
 
 #include "dns/nm-dns-manager.h"
 #include "nm-connectivity.h"
+#include "nm-config.h"
+#include "nm-auth-manager.h"
 
 #include "nm-test-utils-core.h"
 
@@ -2173,6 +2175,55 @@ test_connectivity_state_cmp (void)
 
 /*****************************************************************************/
 
+static void
+test_connectivity_resolve_cache (void)
+{
+	const gint64 t = 1000000;
+	guint interval;
+
+	/* with the default interval of 300 seconds, the next periodic check
+	 * reuses the addresses, even if the device delays it by 5%. */
+	interval = NM_CONFIG_DEFAULT_CONNECTIVITY_INTERVAL;
+	g_assert_cmpint (interval, ==, 300);
+	g_assert (_nm_connectivity_resolve_cache_is_fresh (t, t, interval));
+	g_assert (_nm_connectivity_resolve_cache_is_fresh (t, t + interval * 1000, interval));
+	g_assert (_nm_connectivity_resolve_cache_is_fresh (t, t + interval * 1050, interval));
+	g_assert (!_nm_connectivity_resolve_cache_is_fresh (t, t + interval * 2000, interval));
+
+	/* a long interval keeps the addresses for as long. */
+	interval = 3600;
+	g_assert (_nm_connectivity_resolve_cache_is_fresh (t, t + interval * 1050, interval));
+	g_assert (!_nm_connectivity_resolve_cache_is_fresh (t, t + interval * 2000, interval));
+
+	/* short intervals, or periodic checks disabled, still reuse the
+	 * addresses for a while. */
+	g_assert (_nm_connectivity_resolve_cache_is_fresh (t, t + 119 * 1000, 10));
+	g_assert (!_nm_connectivity_resolve_cache_is_fresh (t, t + 120 * 1000, 10));
+	g_assert (_nm_connectivity_resolve_cache_is_fresh (t, t + 119 * 1000, 0));
+	g_assert (!_nm_connectivity_resolve_cache_is_fresh (t, t + 120 * 1000, 0));
+}
+
+/*****************************************************************************/
+
+static void
+test_auth_call_result_is_cacheable (void)
+{
+	/* a grant or a denial of a non-interactive check can be reused. */
+	g_assert (nm_auth_call_result_is_cacheable (FALSE, FALSE));
+
+	/* a non-interactive check that requires authentication must be asked
+	 * again, in case the client retries with user interaction. */
+	g_assert (!nm_auth_call_result_is_cacheable (FALSE, TRUE));
+
+	/* a grant after the user authenticated to the agent (for example, a
+	 * one-shot "auth_admin" rule) must not be reused, neither must a
+	 * dismissed prompt turn into a denial. */
+	g_assert (!nm_auth_call_result_is_cacheable (TRUE, FALSE));
+	g_assert (!nm_auth_call_result_is_cacheable (TRUE, TRUE));
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -2229,6 +2280,9 @@ main (int argc, char **argv)
 	g_test_add_data_func ("/general/nm_utils_dhcp_client_id_systemd_node_specific/1", GINT_TO_POINTER (1), test_nm_utils_dhcp_client_id_systemd_node_specific);
 
 	g_test_add_func ("/core/general/test_connectivity_state_cmp", test_connectivity_state_cmp);
+	g_test_add_func ("/core/general/test_connectivity_resolve_cache", test_connectivity_resolve_cache);
+
+	g_test_add_func ("/core/general/auth-call-result-is-cacheable", test_auth_call_result_is_cacheable);
 
 	return g_test_run ();
 }
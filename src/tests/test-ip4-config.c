@@ -21,8 +21,10 @@
 #include "nm-default.h"
 
 #include <arpa/inet.h>
+#include <linux/rtnetlink.h>
 
 #include "nm-ip4-config.h"
+#include "nm-ip-route-lpm.h"
 #include "platform/nm-platform.h"
 
 #include "nm-test-utils-core.h"
@@ -333,6 +335,478 @@ test_strip_search_trailing_dot (void)
 
 /*****************************************************************************/
 
+/* nm_ip4_config_get_direct_route_for_host() before the lookup index. It
+ * prefers a lower metric over a longer prefix when the route with the
+ * shorter prefix comes later in the list. */
+static const NMPlatformIP4Route *
+_direct_route_for_host_linear (const NMIP4Config *config,
+                               in_addr_t host,
+                               guint32 route_table)
+{
+	const NMPlatformIP4Route *best_route = NULL;
+	const NMPlatformIP4Route *item;
+	NMDedupMultiIter ipconf_iter;
+
+	nm_ip_config_iter_ip4_route_for_each (&ipconf_iter, config, &item) {
+		if (item->gateway != 0)
+			continue;
+
+		if (best_route && best_route->plen > item->plen)
+			continue;
+
+		if (nm_platform_route_table_uncoerce (item->table_coerced, TRUE) != route_table)
+			continue;
+
+		if (nm_utils_ip4_address_clear_host_address (host, item->plen) != nm_utils_ip4_address_clear_host_address (item->network, item->plen))
+			continue;
+
+		if (best_route && best_route->metric <= item->metric)
+			continue;
+
+		best_route = item;
+	}
+	return best_route;
+}
+
+static const NMPlatformIP4Route *
+_direct_route_for_host_reference (const NMIP4Config *config,
+                                  in_addr_t host,
+                                  guint32 route_table)
+{
+	const NMPlatformIP4Route *best = NULL;
+	const NMPlatformIP4Route *r;
+	NMDedupMultiIter iter;
+
+	nm_ip_config_iter_ip4_route_for_each (&iter, config, &r) {
+		if (   r->gateway != 0
+		    || nm_platform_route_table_uncoerce (r->table_coerced, TRUE) != route_table
+		    || nm_utils_ip4_address_clear_host_address (host, r->plen) != r->network)
+			continue;
+		if (   !best
+		    || r->plen > best->plen
+		    || (   r->plen == best->plen
+		        && r->metric < best->metric))
+			best = r;
+	}
+	return best;
+}
+
+static void
+test_direct_route_for_host (gconstpointer test_data)
+{
+	const guint n_routes = GPOINTER_TO_UINT (test_data);
+	const guint n_lookups = 1000;
+	gs_unref_object NMIP4Config *config = NULL;
+	gs_free in_addr_t *hosts = NULL;
+	gs_free const NMPlatformIP4Route **r_linear = NULL;
+	gs_free const NMPlatformIP4Route **r_lpm = NULL;
+	gint64 t_start;
+	gint64 t_lpm;
+	gint64 t_linear;
+	guint n_longer = 0;
+	guint i;
+
+	if (   n_routes > 10000
+	    && nmtst_test_quick ()) {
+		g_test_skip ("Skip long running test. Run with NMTST_DEBUG=slow");
+		return;
+	}
+
+	config = nmtst_ip4_config_new (1);
+
+	for (i = 0; i < n_routes; i++) {
+		NMPlatformIP4Route r = {
+			.plen = 8 + (nmtst_get_rand_int () % 25),
+			.metric = nmtst_get_rand_int () % 4,
+			.table_coerced = nm_platform_route_table_coerce ((nmtst_get_rand_int () % 8) ? RT_TABLE_MAIN : 10),
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		};
+
+		/* cluster the routes in 10.0.0.0/8, so that the prefixes overlap. */
+		r.network = nm_utils_ip4_address_clear_host_address (htonl (0x0A000000u | (nmtst_get_rand_int () & 0x00FFFFFFu)), r.plen);
+		if (nmtst_get_rand_int () % 16 == 0)
+			r.gateway = nmtst_inet4_from_string ("192.168.1.1");
+		nm_ip4_config_add_route (config, &r, NULL);
+	}
+
+	hosts = g_new (in_addr_t, n_lookups);
+	for (i = 0; i < n_lookups; i++)
+		hosts[i] = htonl (0x0A000000u | (nmtst_get_rand_int () & 0x00FFFFFFu));
+
+	r_linear = g_new (const NMPlatformIP4Route *, n_lookups);
+	r_lpm = g_new (const NMPlatformIP4Route *, n_lookups);
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	for (i = 0; i < n_lookups; i++)
+		r_linear[i] = _direct_route_for_host_linear (config, hosts[i], (i % 2) ? RT_TABLE_MAIN : 10);
+	t_linear = nm_utils_get_monotonic_timestamp_us () - t_start;
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	for (i = 0; i < n_lookups; i++)
+		r_lpm[i] = nm_ip4_config_get_direct_route_for_host (config, hosts[i], (i % 2) ? RT_TABLE_MAIN : 10);
+	t_lpm = nm_utils_get_monotonic_timestamp_us () - t_start;
+
+	for (i = 0; i < n_lookups; i++) {
+		g_assert (r_lpm[i] == _direct_route_for_host_reference (config, hosts[i], (i % 2) ? RT_TABLE_MAIN : 10));
+		if (   r_linear[i]
+		    && r_lpm[i]
+		    && r_lpm[i]->plen > r_linear[i]->plen) {
+			/* the linear scan picked a shorter prefix with a lower or equal metric. */
+			g_assert_cmpint (r_lpm[i]->metric, >=, r_linear[i]->metric);
+			g_assert (nm_utils_ip4_address_clear_host_address (hosts[i], r_lpm[i]->plen) == r_lpm[i]->network);
+			g_assert (r_lpm[i]->gateway == 0);
+			n_longer++;
+			continue;
+		}
+		g_assert (r_lpm[i] == r_linear[i]);
+	}
+
+	g_test_message ("%u lookups over %u routes: %"G_GINT64_FORMAT" usec (linear: %"G_GINT64_FORMAT" usec, %u with a longer prefix)",
+	                n_lookups, nm_ip4_config_get_num_routes (config), t_lpm, t_linear, n_longer);
+}
+
+static void
+test_add_dependent_routes_gateway (void)
+{
+	gs_unref_object NMIP4Config *config = NULL;
+	const NMPlatformIP4Route *r;
+	NMDedupMultiIter iter;
+	guint n_host_routes = 0;
+	guint i;
+
+	/* enough routes to use the lookup index. */
+	config = nmtst_ip4_config_new (1);
+	for (i = 0; i < 2 * NM_IP_ROUTE_LPM_MIN_ROUTES; i++) {
+		NMPlatformIP4Route route = {
+			.network = htonl (0x0A000000u | (i << 8)),
+			.plen = 24,
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		};
+
+		nm_ip4_config_add_route (config, &route, NULL);
+	}
+
+	/* two default routes via the same gateway need one direct route to it,
+	 * the one via a reachable gateway none. */
+	nm_ip4_config_add_route (config, nmtst_platform_ip4_route_full ("0.0.0.0", 0, "192.168.1.1", 1, NM_IP_CONFIG_SOURCE_USER, 100, 0, 0, 0), NULL);
+	nm_ip4_config_add_route (config, nmtst_platform_ip4_route_full ("0.0.0.0", 0, "192.168.1.1", 1, NM_IP_CONFIG_SOURCE_USER, 200, 0, 0, 0), NULL);
+	nm_ip4_config_add_route (config, nmtst_platform_ip4_route_full ("0.0.0.0", 0, "10.0.3.1", 1, NM_IP_CONFIG_SOURCE_USER, 300, 0, 0, 0), NULL);
+
+	nm_ip4_config_add_dependent_routes (config, RT_TABLE_MAIN, 100, NULL);
+
+	nm_ip_config_iter_ip4_route_for_each (&iter, config, &r) {
+		if (r->plen == 32) {
+			g_assert (r->network == nmtst_inet4_from_string ("192.168.1.1"));
+			g_assert (r->gateway == 0);
+			n_host_routes++;
+		}
+	}
+	g_assert_cmpint (n_host_routes, ==, 1);
+	g_assert (nm_ip4_config_get_direct_route_for_host (config, nmtst_inet4_from_string ("192.168.1.1"), RT_TABLE_MAIN));
+}
+
+/*****************************************************************************/
+
+#define RAND_POOL_SIZE 64
+
+static void
+_rand_route (NMPlatformIP4Route *r, guint k)
+{
+	*r = (NMPlatformIP4Route) {
+		.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		.plen = 24,
+		.network = htonl (0x0B000000u | (k << 8)),
+		.metric = k % 3,
+	};
+	if (k % 7 == 0) {
+		/* default routes, distinguished by their metric. */
+		r->plen = 0;
+		r->network = 0;
+		r->metric = 100 + k;
+		r->gateway = nmtst_inet4_from_string ("192.168.1.1");
+	} else if (k % 3 == 0)
+		r->gateway = htonl (0xC0A80100u | (k % 5));
+}
+
+static NMIP4Config *
+_rand_config (NMDedupMultiIndex *multi_idx)
+{
+	NMIP4Config *config;
+	guint order[RAND_POOL_SIZE];
+	guint i;
+
+	config = nm_ip4_config_new (multi_idx, 1);
+
+	/* mostly keep the order of the pool, so that configs share runs of
+	 * objects. But swap some neighbors. */
+	for (i = 0; i < RAND_POOL_SIZE; i++)
+		order[i] = i;
+	for (i = 0; i + 1 < RAND_POOL_SIZE; i++) {
+		if (nmtst_get_rand_int () % 8 == 0) {
+			guint tmp = order[i];
+
+			order[i] = order[i + 1];
+			order[i + 1] = tmp;
+		}
+	}
+
+	for (i = 0; i < RAND_POOL_SIZE; i++) {
+		NMPlatformIP4Address a;
+		NMPlatformIP4Route r;
+
+		if (nmtst_get_rand_int () % 4 == 0)
+			continue;
+
+		if (nmtst_get_rand_int () % 2) {
+			a = *nmtst_platform_ip4_address ("10.0.0.1", NULL, 24);
+			a.address = htonl (0x0A000001u | (order[i] << 8));
+			a.peer_address = a.address;
+			/* same ID, but a different object. */
+			a.addr_source = (nmtst_get_rand_int () % 8) ? NM_IP_CONFIG_SOURCE_USER : NM_IP_CONFIG_SOURCE_DHCP;
+			nm_ip4_config_add_address (config, &a);
+		}
+
+		_rand_route (&r, order[i]);
+		if (nmtst_get_rand_int () % 8 == 0)
+			r.mss = 1400;
+		nm_ip4_config_add_route (config, &r, NULL);
+	}
+
+	return config;
+}
+
+static void
+_assert_config_equal_ordered (const NMIP4Config *a, const NMIP4Config *b)
+{
+	NMDedupMultiIter iter_a, iter_b;
+	const NMPlatformIP4Address *a_a, *a_b;
+	const NMPlatformIP4Route *r_a, *r_b;
+
+	g_assert_cmpint (nm_ip4_config_get_ifindex (a), ==, nm_ip4_config_get_ifindex (b));
+
+	g_assert_cmpint (nm_ip4_config_get_num_addresses (a), ==, nm_ip4_config_get_num_addresses (b));
+	nm_ip_config_iter_ip4_address_init (&iter_b, b);
+	nm_ip_config_iter_ip4_address_for_each (&iter_a, a, &a_a) {
+		g_assert (nm_ip_config_iter_ip4_address_next (&iter_b, &a_b));
+		g_assert_cmpint (nm_platform_ip4_address_cmp (a_a, a_b), ==, 0);
+	}
+
+	g_assert_cmpint (nm_ip4_config_get_num_routes (a), ==, nm_ip4_config_get_num_routes (b));
+	nm_ip_config_iter_ip4_route_init (&iter_b, b);
+	nm_ip_config_iter_ip4_route_for_each (&iter_a, a, &r_a) {
+		g_assert (nm_ip_config_iter_ip4_route_next (&iter_b, &r_b));
+		g_assert_cmpint (nm_platform_ip4_route_cmp_full (r_a, r_b), ==, 0);
+	}
+
+	g_assert (nm_ip4_config_best_default_route_get (a) == nm_ip4_config_best_default_route_get (b));
+}
+
+static const NMPObject *
+_penalized_lookup_obj (NMPObject *obj_stack, const NMPObject *obj, guint32 penalty)
+{
+	if (   !penalty
+	    || NMP_OBJECT_GET_TYPE (obj) != NMP_OBJECT_TYPE_IP4_ROUTE
+	    || !NM_PLATFORM_IP_ROUTE_IS_DEFAULT (NMP_OBJECT_CAST_IP4_ROUTE (obj)))
+		return obj;
+
+	nmp_object_stackinit_obj (obj_stack, obj);
+	obj_stack->ip4_route.metric = nm_utils_ip_route_metric_penalize (AF_INET, obj_stack->ip4_route.metric, penalty);
+	return obj_stack;
+}
+
+/* the reference implementations below handle one object at a time, via the
+ * public API. */
+
+static void
+_merge_reference (NMIP4Config *dst, const NMIP4Config *src, guint32 penalty)
+{
+	NMDedupMultiIter iter;
+	const NMPlatformIP4Address *a;
+	const NMPlatformIP4Route *r;
+
+	nm_ip_config_iter_ip4_address_for_each (&iter, src, &a)
+		nm_ip4_config_add_address (dst, a);
+	nm_ip_config_iter_ip4_route_for_each (&iter, src, &r) {
+		NMPObject obj_stack;
+
+		nm_ip4_config_add_route (dst,
+		                         NMP_OBJECT_CAST_IP4_ROUTE (_penalized_lookup_obj (&obj_stack, NMP_OBJECT_UP_CAST (r), penalty)),
+		                         NULL);
+	}
+}
+
+static void
+_subtract_reference (NMIP4Config *dst, const NMIP4Config *src, guint32 penalty)
+{
+	NMDedupMultiIter iter;
+	const NMPlatformIP4Address *a;
+	const NMPlatformIP4Route *r;
+
+	nm_ip_config_iter_ip4_address_for_each (&iter, src, &a)
+		nm_ip4_config_nmpobj_remove (dst, NMP_OBJECT_UP_CAST (a));
+	nm_ip_config_iter_ip4_route_for_each (&iter, src, &r) {
+		NMPObject obj_stack;
+
+		nm_ip4_config_nmpobj_remove (dst, _penalized_lookup_obj (&obj_stack, NMP_OBJECT_UP_CAST (r), penalty));
+	}
+}
+
+static void
+_intersect_reference (NMIP4Config *dst, const NMIP4Config *src, guint32 penalty)
+{
+	gs_unref_ptrarray GPtrArray *to_remove = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+	NMDedupMultiIter iter;
+	const NMPlatformIP4Address *a;
+	const NMPlatformIP4Route *r;
+	guint i;
+
+	nm_ip_config_iter_ip4_address_for_each (&iter, dst, &a) {
+		if (!nm_ip4_config_nmpobj_lookup (src, NMP_OBJECT_UP_CAST (a)))
+			g_ptr_array_add (to_remove, (gpointer) nmp_object_ref (NMP_OBJECT_UP_CAST (a)));
+	}
+	nm_ip_config_iter_ip4_route_for_each (&iter, dst, &r) {
+		NMPObject obj_stack;
+
+		if (!nm_ip4_config_nmpobj_lookup (src, _penalized_lookup_obj (&obj_stack, NMP_OBJECT_UP_CAST (r), penalty)))
+			g_ptr_array_add (to_remove, (gpointer) nmp_object_ref (NMP_OBJECT_UP_CAST (r)));
+	}
+	for (i = 0; i < to_remove->len; i++)
+		g_assert (nm_ip4_config_nmpobj_remove (dst, to_remove->pdata[i]));
+}
+
+static void
+test_merge_subtract_intersect_random (void)
+{
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = nm_dedup_multi_index_new ();
+	guint i_run;
+
+	for (i_run = 0; i_run < 50; i_run++) {
+		gs_unref_object NMIP4Config *a = _rand_config (multi_idx);
+		gs_unref_object NMIP4Config *b = _rand_config (multi_idx);
+		const guint32 penalty = (i_run % 2) ? 20000 : 0;
+
+		{
+			gs_unref_object NMIP4Config *dst1 = nm_ip4_config_clone (a);
+			gs_unref_object NMIP4Config *dst2 = nm_ip4_config_clone (a);
+
+			_assert_config_equal_ordered (dst1, a);
+			nm_ip4_config_merge (dst1, b, NM_IP_CONFIG_MERGE_DEFAULT, penalty);
+			_merge_reference (dst2, b, penalty);
+			_assert_config_equal_ordered (dst1, dst2);
+
+			/* merging again changes nothing. */
+			nm_ip4_config_merge (dst1, b, NM_IP_CONFIG_MERGE_DEFAULT, penalty);
+			_assert_config_equal_ordered (dst1, dst2);
+
+			nm_ip4_config_subtract (dst1, b, penalty);
+			_subtract_reference (dst2, b, penalty);
+			_assert_config_equal_ordered (dst1, dst2);
+		}
+		{
+			gs_unref_object NMIP4Config *dst1 = nm_ip4_config_clone (a);
+			gs_unref_object NMIP4Config *dst2 = nm_ip4_config_clone (a);
+
+			nm_ip4_config_subtract (dst1, b, penalty);
+			_subtract_reference (dst2, b, penalty);
+			_assert_config_equal_ordered (dst1, dst2);
+		}
+		{
+			gs_unref_object NMIP4Config *dst1 = nm_ip4_config_clone (a);
+			gs_unref_object NMIP4Config *dst2 = nm_ip4_config_clone (a);
+
+			nm_ip4_config_intersect (dst1, b, TRUE, TRUE, penalty);
+			_intersect_reference (dst2, b, penalty);
+			_assert_config_equal_ordered (dst1, dst2);
+		}
+		{
+			gs_unref_object NMIP4Config *dst = nm_ip4_config_clone (a);
+
+			nm_ip4_config_replace (dst, b, NULL);
+			_assert_config_equal_ordered (dst, b);
+		}
+	}
+}
+
+static void
+_merge_benchmark_run (NMDedupMultiIndex *multi_idx,
+                      const NMIP4Config *src,
+                      gboolean reference,
+                      gint64 *out_t_merge,
+                      gint64 *out_t_merge_again,
+                      gint64 *out_t_subtract)
+{
+	gs_unref_object NMIP4Config *dst = NULL;
+	const guint n_routes = nm_ip4_config_get_num_routes (src);
+	gint64 t_start;
+
+	dst = nm_ip4_config_new (multi_idx, 1);
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	if (reference)
+		_merge_reference (dst, src, 0);
+	else
+		nm_ip4_config_merge (dst, src, NM_IP_CONFIG_MERGE_DEFAULT, 0);
+	*out_t_merge = nm_utils_get_monotonic_timestamp_us () - t_start;
+	g_assert_cmpint (nm_ip4_config_get_num_routes (dst), ==, n_routes);
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	if (reference)
+		_merge_reference (dst, src, 0);
+	else
+		nm_ip4_config_merge (dst, src, NM_IP_CONFIG_MERGE_DEFAULT, 0);
+	*out_t_merge_again = nm_utils_get_monotonic_timestamp_us () - t_start;
+	g_assert_cmpint (nm_ip4_config_get_num_routes (dst), ==, n_routes);
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	if (reference)
+		_subtract_reference (dst, src, 0);
+	else
+		nm_ip4_config_subtract (dst, src, 0);
+	*out_t_subtract = nm_utils_get_monotonic_timestamp_us () - t_start;
+	g_assert_cmpint (nm_ip4_config_get_num_routes (dst), ==, 0);
+}
+
+static void
+test_merge_benchmark (void)
+{
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = nm_dedup_multi_index_new ();
+	gs_unref_object NMIP4Config *src = NULL;
+	const guint n_routes = 10000;
+	gint64 t_merge[2];
+	gint64 t_merge_again[2];
+	gint64 t_subtract[2];
+	guint i;
+
+	src = nm_ip4_config_new (multi_idx, 1);
+	for (i = 0; i < n_routes; i++) {
+		const NMPlatformIP4Route r = {
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+			.plen = 32,
+			.network = htonl (0x0A000000u + i),
+			.metric = 100,
+		};
+
+		nm_ip4_config_add_route (src, &r, NULL);
+	}
+
+	/* the reference adds and removes one object at a time, with a lookup
+	 * in the index for each, like the operations did before walking the
+	 * configs in order. Merging into an empty config gains nothing from
+	 * the walk; merging again and subtracting do. */
+	_merge_benchmark_run (multi_idx, src, TRUE, &t_merge[0], &t_merge_again[0], &t_subtract[0]);
+	_merge_benchmark_run (multi_idx, src, FALSE, &t_merge[1], &t_merge_again[1], &t_subtract[1]);
+
+	g_test_message ("%u routes: merge %"G_GINT64_FORMAT" usec (reference %"G_GINT64_FORMAT"), "
+	                "merge again %"G_GINT64_FORMAT" usec (reference %"G_GINT64_FORMAT"), "
+	                "subtract %"G_GINT64_FORMAT" usec (reference %"G_GINT64_FORMAT")",
+	                n_routes,
+	                t_merge[1], t_merge[0],
+	                t_merge_again[1], t_merge_again[0],
+	                t_subtract[1], t_subtract[0]);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -346,6 +820,12 @@ main (int argc, char **argv)
 	g_test_add_func ("/ip4-config/add-route-with-source", test_add_route_with_source);
 	g_test_add_func ("/ip4-config/merge-subtract-mtu", test_merge_subtract_mtu);
 	g_test_add_func ("/ip4-config/strip-search-trailing-dot", test_strip_search_trailing_dot);
+	g_test_add_data_func ("/ip4-config/direct-route-for-host/10", GUINT_TO_POINTER (10), test_direct_route_for_host);
+	g_test_add_data_func ("/ip4-config/direct-route-for-host/1000", GUINT_TO_POINTER (1000), test_direct_route_for_host);
+	g_test_add_data_func ("/ip4-config/direct-route-for-host/100000", GUINT_TO_POINTER (100000), test_direct_route_for_host);
+	g_test_add_func ("/ip4-config/add-dependent-routes-gateway", test_add_dependent_routes_gateway);
+	g_test_add_func ("/ip4-config/merge-subtract-intersect-random", test_merge_subtract_intersect_random);
+	g_test_add_func ("/ip4-config/merge-benchmark", test_merge_benchmark);
 
 	return g_test_run ();
 }
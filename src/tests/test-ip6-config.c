@@ -24,6 +24,7 @@
 #include <linux/if_addr.h>
 
 #include "nm-ip6-config.h"
+#include "nm-ip-route-lpm.h"
 
 #include "platform/nm-platform.h"
 #include "nm-test-utils-core.h"
@@ -355,6 +356,48 @@ test_strip_search_trailing_dot (void)
 
 /*****************************************************************************/
 
+static void
+test_merge_setting_route_attributes (void)
+{
+	gs_unref_object NMIP6Config *config = NULL;
+	gs_unref_object NMSettingIPConfig *s_ip6 = NULL;
+	const NMPlatformIP6Route *r;
+	NMIPRoute *route;
+
+	s_ip6 = NM_SETTING_IP_CONFIG (nm_setting_ip6_config_new ());
+	g_object_set (s_ip6,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP6_CONFIG_METHOD_MANUAL,
+	              NULL);
+
+	route = nm_ip_route_new (AF_INET6, "2001:db8:1::", 64, "fe80::1", 100, NULL);
+	nm_ip_route_set_attribute (route, NM_IP_ROUTE_ATTRIBUTE_SRC,
+	                           g_variant_new_string ("2001:db8::5"));
+	nm_ip_route_set_attribute (route, NM_IP_ROUTE_ATTRIBUTE_FROM,
+	                           g_variant_new_string ("2001:db8:2::/48"));
+	nm_ip_route_set_attribute (route, NM_IP_ROUTE_ATTRIBUTE_MTU,
+	                           g_variant_new_uint32 (1400));
+	nm_setting_ip_config_add_route (s_ip6, route);
+	nm_ip_route_unref (route);
+
+	config = nmtst_ip6_config_new (1);
+	nm_ip6_config_merge_setting (config, s_ip6, 0, 1024);
+
+	g_assert_cmpuint (nm_ip6_config_get_num_routes (config), ==, 1);
+	r = _nmtst_ip6_config_get_route (config, 0);
+	nmtst_assert_ip6_address (&r->network, "2001:db8:1::");
+	g_assert_cmpint (r->plen, ==, 64);
+	nmtst_assert_ip6_address (&r->gateway, "fe80::1");
+	g_assert_cmpint (r->metric, ==, 100);
+	g_assert_cmpint (r->mtu, ==, 1400);
+
+	/* the IPv6 only attributes are honored. */
+	nmtst_assert_ip6_address (&r->pref_src, "2001:db8::5");
+	nmtst_assert_ip6_address (&r->src, "2001:db8:2::");
+	g_assert_cmpint (r->src_plen, ==, 48);
+}
+
+/*****************************************************************************/
+
 static void
 test_replace (gconstpointer user_data)
 {
@@ -420,6 +463,193 @@ test_replace (gconstpointer user_data)
 
 /*****************************************************************************/
 
+/* nm_ip6_config_get_direct_route_for_host() before the lookup index. It
+ * prefers a lower metric over a longer prefix when the route with the
+ * shorter prefix comes later in the list. */
+static const NMPlatformIP6Route *
+_direct_route_for_host_linear (const NMIP6Config *config,
+                               const struct in6_addr *host,
+                               guint32 route_table)
+{
+	const NMPlatformIP6Route *best_route = NULL;
+	const NMPlatformIP6Route *item;
+	NMDedupMultiIter ipconf_iter;
+
+	nm_ip_config_iter_ip6_route_for_each (&ipconf_iter, config, &item) {
+		if (!IN6_IS_ADDR_UNSPECIFIED (&item->gateway))
+			continue;
+
+		if (best_route && best_route->plen > item->plen)
+			continue;
+
+		if (nm_platform_route_table_uncoerce (item->table_coerced, TRUE) != route_table)
+			continue;
+
+		if (!nm_utils_ip6_address_same_prefix (host, &item->network, item->plen))
+			continue;
+
+		if (best_route &&
+		    nm_utils_ip6_route_metric_normalize (best_route->metric) <= nm_utils_ip6_route_metric_normalize (item->metric))
+			continue;
+
+		best_route = item;
+	}
+	return best_route;
+}
+
+static const NMPlatformIP6Route *
+_direct_route_for_host_reference (const NMIP6Config *config,
+                                  const struct in6_addr *host,
+                                  guint32 route_table)
+{
+	const NMPlatformIP6Route *best = NULL;
+	const NMPlatformIP6Route *r;
+	NMDedupMultiIter iter;
+
+	nm_ip_config_iter_ip6_route_for_each (&iter, config, &r) {
+		if (   !IN6_IS_ADDR_UNSPECIFIED (&r->gateway)
+		    || nm_platform_route_table_uncoerce (r->table_coerced, TRUE) != route_table
+		    || !nm_utils_ip6_address_same_prefix (host, &r->network, r->plen))
+			continue;
+		if (   !best
+		    || r->plen > best->plen
+		    || (   r->plen == best->plen
+		        && nm_utils_ip6_route_metric_normalize (r->metric) < nm_utils_ip6_route_metric_normalize (best->metric)))
+			best = r;
+	}
+	return best;
+}
+
+static void
+_rand_host_in_2001_db8 (struct in6_addr *addr)
+{
+	guint i;
+
+	/* cluster the addresses in 2001:db8::/32, so that the prefixes overlap. */
+	*addr = *nmtst_inet6_from_string ("2001:db8::");
+	for (i = 4; i < 16; i++)
+		addr->s6_addr[i] = nmtst_get_rand_int () & 0xFF;
+}
+
+static void
+test_direct_route_for_host (gconstpointer test_data)
+{
+	const guint n_routes = GPOINTER_TO_UINT (test_data);
+	const guint n_lookups = 1000;
+	gs_unref_object NMIP6Config *config = NULL;
+	gs_free struct in6_addr *hosts = NULL;
+	gs_free const NMPlatformIP6Route **r_linear = NULL;
+	gs_free const NMPlatformIP6Route **r_lpm = NULL;
+	gint64 t_start;
+	gint64 t_lpm;
+	gint64 t_linear;
+	guint n_longer = 0;
+	guint i;
+
+	if (   n_routes > 10000
+	    && nmtst_test_quick ()) {
+		g_test_skip ("Skip long running test. Run with NMTST_DEBUG=slow");
+		return;
+	}
+
+	config = nmtst_ip6_config_new (1);
+
+	for (i = 0; i < n_routes; i++) {
+		NMPlatformIP6Route r = {
+			.plen = 32 + (nmtst_get_rand_int () % 33),
+			.metric = 1 + (nmtst_get_rand_int () % 4),
+			.table_coerced = nm_platform_route_table_coerce ((nmtst_get_rand_int () % 8) ? RT_TABLE_MAIN : 10),
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		};
+		struct in6_addr a;
+
+		_rand_host_in_2001_db8 (&a);
+		nm_utils_ip6_address_clear_host_address (&r.network, &a, r.plen);
+		if (nmtst_get_rand_int () % 16 == 0)
+			r.gateway = *nmtst_inet6_from_string ("fe80::1");
+		nm_ip6_config_add_route (config, &r, NULL);
+	}
+
+	hosts = g_new (struct in6_addr, n_lookups);
+	for (i = 0; i < n_lookups; i++)
+		_rand_host_in_2001_db8 (&hosts[i]);
+
+	r_linear = g_new (const NMPlatformIP6Route *, n_lookups);
+	r_lpm = g_new (const NMPlatformIP6Route *, n_lookups);
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	for (i = 0; i < n_lookups; i++)
+		r_linear[i] = _direct_route_for_host_linear (config, &hosts[i], (i % 2) ? RT_TABLE_MAIN : 10);
+	t_linear = nm_utils_get_monotonic_timestamp_us () - t_start;
+
+	t_start = nm_utils_get_monotonic_timestamp_us ();
+	for (i = 0; i < n_lookups; i++)
+		r_lpm[i] = nm_ip6_config_get_direct_route_for_host (config, &hosts[i], (i % 2) ? RT_TABLE_MAIN : 10);
+	t_lpm = nm_utils_get_monotonic_timestamp_us () - t_start;
+
+	for (i = 0; i < n_lookups; i++) {
+		g_assert (r_lpm[i] == _direct_route_for_host_reference (config, &hosts[i], (i % 2) ? RT_TABLE_MAIN : 10));
+		if (   r_linear[i]
+		    && r_lpm[i]
+		    && r_lpm[i]->plen > r_linear[i]->plen) {
+			/* the linear scan picked a shorter prefix with a lower or equal metric. */
+			g_assert_cmpint (r_lpm[i]->metric, >=, r_linear[i]->metric);
+			g_assert (nm_utils_ip6_address_same_prefix (&hosts[i], &r_lpm[i]->network, r_lpm[i]->plen));
+			g_assert (IN6_IS_ADDR_UNSPECIFIED (&r_lpm[i]->gateway));
+			n_longer++;
+			continue;
+		}
+		g_assert (r_lpm[i] == r_linear[i]);
+	}
+
+	g_test_message ("%u lookups over %u routes: %"G_GINT64_FORMAT" usec (linear: %"G_GINT64_FORMAT" usec, %u with a longer prefix)",
+	                n_lookups, nm_ip6_config_get_num_routes (config), t_lpm, t_linear, n_longer);
+}
+
+static void
+test_add_dependent_routes_gateway (void)
+{
+	gs_unref_object NMIP6Config *config = NULL;
+	const NMPlatformIP6Route *r;
+	NMDedupMultiIter iter;
+	guint n_host_routes = 0;
+	guint i;
+
+	/* enough routes to use the lookup index. */
+	config = nmtst_ip6_config_new (1);
+	for (i = 0; i < 2 * NM_IP_ROUTE_LPM_MIN_ROUTES; i++) {
+		NMPlatformIP6Route route = {
+			.network = *nmtst_inet6_from_string ("2001:db8::"),
+			.plen = 64,
+			.metric = 1024,
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		};
+
+		route.network.s6_addr[7] = i;
+		nm_ip6_config_add_route (config, &route, NULL);
+	}
+
+	/* two default routes via the same gateway need one direct route to it,
+	 * the one via a reachable gateway none. */
+	nm_ip6_config_add_route (config, nmtst_platform_ip6_route_full ("::", 0, "2001:db8:1::1", 1, NM_IP_CONFIG_SOURCE_USER, 100, 0), NULL);
+	nm_ip6_config_add_route (config, nmtst_platform_ip6_route_full ("::", 0, "2001:db8:1::1", 1, NM_IP_CONFIG_SOURCE_USER, 200, 0), NULL);
+	nm_ip6_config_add_route (config, nmtst_platform_ip6_route_full ("::", 0, "2001:db8:0:3::1", 1, NM_IP_CONFIG_SOURCE_USER, 300, 0), NULL);
+
+	nm_ip6_config_add_dependent_routes (config, RT_TABLE_MAIN, 100);
+
+	nm_ip_config_iter_ip6_route_for_each (&iter, config, &r) {
+		if (r->plen == 128) {
+			g_assert (IN6_ARE_ADDR_EQUAL (&r->network, nmtst_inet6_from_string ("2001:db8:1::1")));
+			g_assert (IN6_IS_ADDR_UNSPECIFIED (&r->gateway));
+			n_host_routes++;
+		}
+	}
+	g_assert_cmpint (n_host_routes, ==, 1);
+	g_assert (nm_ip6_config_get_direct_route_for_host (config, nmtst_inet6_from_string ("2001:db8:1::1"), RT_TABLE_MAIN));
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -433,8 +663,13 @@ main (int argc, char **argv)
 	g_test_add_func ("/ip6-config/add-route-with-source", test_add_route_with_source);
 	g_test_add_func ("/ip6-config/test_nm_ip6_config_addresses_sort", test_nm_ip6_config_addresses_sort);
 	g_test_add_func ("/ip6-config/strip-search-trailing-dot", test_strip_search_trailing_dot);
+	g_test_add_func ("/ip6-config/merge-setting-route-attributes", test_merge_setting_route_attributes);
 	g_test_add_data_func ("/ip6-config/replace/1", GINT_TO_POINTER (1), test_replace);
 	g_test_add_data_func ("/ip6-config/replace/2", GINT_TO_POINTER (2), test_replace);
+	g_test_add_data_func ("/ip6-config/direct-route-for-host/10", GUINT_TO_POINTER (10), test_direct_route_for_host);
+	g_test_add_data_func ("/ip6-config/direct-route-for-host/1000", GUINT_TO_POINTER (1000), test_direct_route_for_host);
+	g_test_add_data_func ("/ip6-config/direct-route-for-host/100000", GUINT_TO_POINTER (100000), test_direct_route_for_host);
+	g_test_add_func ("/ip6-config/add-dependent-routes-gateway", test_add_dependent_routes_gateway);
 
 	return g_test_run ();
 }
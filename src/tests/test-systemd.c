@@ -21,6 +21,7 @@
 
 #include "systemd/nm-sd.h"
 #include "systemd/nm-sd-utils-shared.h"
+#include "systemd/nm-sd-utils-core.h"
 
 #include "nm-test-utils-core.h"
 
@@ -328,6 +329,57 @@ test_nm_sd_utils_unbase64mem (void)
 
 /*****************************************************************************/
 
+static void
+_test_dhcp_renewal_jitter (guint64 start, guint64 t1, guint64 t2, guint percent, guint64 rnd)
+{
+	guint64 j1, j2;
+
+	j1 = nm_sd_utils_dhcp_renewal_jitter (start, t1, percent, rnd);
+	j2 = nm_sd_utils_dhcp_renewal_jitter (start, t2, percent, rnd);
+
+	g_assert_cmpuint (j1, <=, t1);
+	g_assert_cmpuint (j2, <=, t2);
+	g_assert_cmpuint (j1, >=, t1 - (t1 - start) * percent / 100u);
+	g_assert_cmpuint (j2, >=, t2 - (t2 - start) * percent / 100u);
+	g_assert_cmpuint (j1, >=, start);
+	g_assert_cmpuint (j1, <=, j2);
+}
+
+static void
+test_dhcp_renewal_jitter (void)
+{
+	const guint64 start = 1000 * G_USEC_PER_SEC;
+	guint64 lifetime;
+	guint64 rnd;
+	guint percent;
+	guint i;
+
+	/* no jitter, or no time to move the timeout into. */
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start + 100, 0, 12345), ==, start + 100);
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start, 50, 12345), ==, start);
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start - 1, 50, 12345), ==, start - 1);
+
+	/* the extremes: a random number of zero doesn't move the timeout, the
+	 * largest fraction moves it by exactly @percent percent. */
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start + 100000, 50, 0), ==, start + 100000);
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start + 100000, 50, 50000), ==, start + 50000);
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start + 100000, 10, 10000), ==, start + 90000);
+
+	/* no overflow for the longest lease lifetime. */
+	lifetime = (guint64) G_MAXUINT32 * G_USEC_PER_SEC;
+	_test_dhcp_renewal_jitter (start, start + lifetime / 2, start + lifetime / 8 * 7, 50, G_MAXUINT64);
+	g_assert_cmpuint (nm_sd_utils_dhcp_renewal_jitter (start, start + lifetime, 50, 50000), ==, start + lifetime / 2);
+
+	for (i = 0; i < 1000; i++) {
+		lifetime = (nmtst_get_rand_int () % 86400u + 1u) * G_USEC_PER_SEC;
+		percent = nmtst_get_rand_int () % 51u;
+		rnd = (((guint64) nmtst_get_rand_int ()) << 32) | nmtst_get_rand_int ();
+		_test_dhcp_renewal_jitter (start, start + lifetime / 2, start + lifetime / 8 * 7, percent, rnd);
+	}
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -340,6 +392,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/systemd/sd-event", test_sd_event);
 	g_test_add_func ("/systemd/test_path_equal", test_path_equal);
 	g_test_add_func ("/systemd/test_nm_sd_utils_unbase64mem", test_nm_sd_utils_unbase64mem);
+	g_test_add_func ("/systemd/dhcp/renewal-jitter", test_dhcp_renewal_jitter);
 
 	return g_test_run ();
 }
@@ -1722,6 +1722,15 @@ class Settings(ExportedObj):
     def ListConnections(self):
         return self.get_connection_paths()
 
+    @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='ao', out_signature='a{oa{sa{sv}}}')
+    def GetConnectionsSettings(self, paths):
+        if len(paths) == 0:
+            cons = self.get_connections()
+        else:
+            cons = [self.connections[p] for p in set(paths) if p in self.connections]
+        return dbus.Dictionary(dict([(c.path, c.con_hash) for c in cons if c.visible]),
+                               signature='oa{sa{sv}}')
+
     @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='a{sa{sv}}', out_signature='o')
     def AddConnection(self, con_hash):
         return self.add_connection(con_hash)